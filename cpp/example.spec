@@ -5,9 +5,15 @@
 # the signal may be signed or unsigned (this ends up in the header file)
 # signal type can be "output" or "input" -- "io" is not supported
 # signal connection can be "wire" or "channel" -- sync channels are not yet supported
+# a "memory" connection takes a sixth field, the depth in words (if_gen_axi only)
+# a "stream" connection may take a sixth field, the TDATA width (if_gen_axi only)
 # 
 # comma delimited, basic edit checking is provided
 #
+# bus options are given as "<option> = <value>", see README.AXI.txt
+#
+# data_bits = 64
+#
 
 # name,        bitwidth, signed,   type,  connection (wire|channel)
 #
@@ -35,3 +41,16 @@ data_out,             8, unsigned, output, channel
 # this is only supported for if_gen_axi
 
 memory,              20, unsigned, input, master
+
+# a catapult array mapped to an external 1R1W RAM resource can be loaded
+# or read back by the host through the slave, an input memory is read by
+# the catapult component and an output memory written by it.  This is only
+# supported for if_gen_axi
+#
+# weights,             16, signed,   input,  memory, 4096
+
+# a channel fed or drained by a stream DMA can be an AXI4-Stream port
+# instead of a register, optionally with a wider TDATA holding several
+# elements.  This is only supported for if_gen_axi
+#
+# pixels,               8, unsigned, input,  stream, 64
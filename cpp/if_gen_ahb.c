@@ -869,6 +869,118 @@ static void print_epilog(FILE *txt)
 }
 
 
+static void print_ahb_wrapper(FILE *txt, signal_struct *signals)
+{
+    // cat_accel behind ahb_lite_slave, zero wait state AHB-Lite with the
+    // master port of cat_accel passed through
+
+    int master = has_master(signals);
+
+    fprintf(txt, "// AHB-Lite slave wrapper of cat_accel, written by if_gen.  Transfers and \n");
+    fprintf(txt, "// bursts run back to back at one per HCLK through verilog/ahb_lite_slave.sv, \n");
+    fprintf(txt, "// register n at byte offset 4n of the HSEL window, and an access past the \n");
+    fprintf(txt, "// %d registers is answered ERROR.  The register bank takes whole words, \n", register_count(signals));
+    fprintf(txt, "// HSIZE below a word still writes all 32 bits. \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "module cat_accel_ahb ( \n");
+    fprintf(txt, "  input          HCLK, \n");
+    fprintf(txt, "  input          HRESETn, \n");
+    fprintf(txt, "  input          HSEL, \n");
+    fprintf(txt, "  input  [31:0]  HADDR, \n");
+    fprintf(txt, "  input  [1:0]   HTRANS, \n");
+    fprintf(txt, "  input          HWRITE, \n");
+    fprintf(txt, "  input  [2:0]   HSIZE, \n");
+    fprintf(txt, "  input  [2:0]   HBURST, \n");
+    fprintf(txt, "  input  [3:0]   HPROT, \n");
+    fprintf(txt, "  input          HMASTLOCK, \n");
+    fprintf(txt, "  input          HREADY, \n");
+    fprintf(txt, "  input  [31:0]  HWDATA, \n");
+    fprintf(txt, "  output         HREADYOUT, \n");
+    fprintf(txt, "  output         HRESP, \n");
+    if (master) {
+        fprintf(txt, "  output [31:0]  HRDATA, \n");
+        fprintf(txt, "  output         ready, \n");
+        fprintf(txt, "  output [31:0]  haddr, \n");
+        fprintf(txt, "  output [1:0]   htrans, \n");
+        fprintf(txt, "  output [2:0]   hsize, \n");
+        fprintf(txt, "  output         hwrite, \n");
+        fprintf(txt, "  output         hready, \n");
+        fprintf(txt, "  output [3:0]   hprot, \n");
+        fprintf(txt, "  output [2:0]   hburst, \n");
+        fprintf(txt, "  output [31:0]  hwdata, \n");
+        fprintf(txt, "  output         hlock, \n");
+        fprintf(txt, "  input  [1:0]   hresp, \n");
+        fprintf(txt, "  input  [31:0]  hrdata \n");
+    } else {
+        fprintf(txt, "  output [31:0]  HRDATA \n");
+    }
+    fprintf(txt, "); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " wire    [15:0]  read_addr; \n");
+    fprintf(txt, " wire    [31:0]  read_data; \n");
+    fprintf(txt, " wire            oe; \n");
+    fprintf(txt, " wire    [15:0]  write_addr; \n");
+    fprintf(txt, " wire    [31:0]  write_data; \n");
+    fprintf(txt, " wire    [3:0]   be; \n");
+    fprintf(txt, " wire            we; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " ahb_lite_slave #(.width(18), .registers(%d)) slave ( \n", register_count(signals));
+    fprintf(txt, "    .HCLK                   (HCLK), \n");
+    fprintf(txt, "    .HRESETn                (HRESETn), \n");
+    fprintf(txt, "    .HSEL                   (HSEL), \n");
+    fprintf(txt, "    .HADDR                  (HADDR), \n");
+    fprintf(txt, "    .HTRANS                 (HTRANS), \n");
+    fprintf(txt, "    .HWRITE                 (HWRITE), \n");
+    fprintf(txt, "    .HSIZE                  (HSIZE), \n");
+    fprintf(txt, "    .HBURST                 (HBURST), \n");
+    fprintf(txt, "    .HPROT                  (HPROT), \n");
+    fprintf(txt, "    .HMASTLOCK              (HMASTLOCK), \n");
+    fprintf(txt, "    .HREADY                 (HREADY), \n");
+    fprintf(txt, "    .HWDATA                 (HWDATA), \n");
+    fprintf(txt, "    .HREADYOUT              (HREADYOUT), \n");
+    fprintf(txt, "    .HRESP                  (HRESP), \n");
+    fprintf(txt, "    .HRDATA                 (HRDATA), \n");
+    fprintf(txt, "    .SRAM_READ_ADDRESS      (read_addr), \n");
+    fprintf(txt, "    .SRAM_READ_DATA         (read_data), \n");
+    fprintf(txt, "    .SRAM_OUTPUT_ENABLE     (oe), \n");
+    fprintf(txt, "    .SRAM_WRITE_ADDRESS     (write_addr), \n");
+    fprintf(txt, "    .SRAM_WRITE_DATA        (write_data), \n");
+    fprintf(txt, "    .SRAM_WRITE_BYTE_ENABLE (be), \n");
+    fprintf(txt, "    .SRAM_WRITE_STROBE      (we) \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " cat_accel accel ( \n");
+    fprintf(txt, "    .clock      (HCLK), \n");
+    fprintf(txt, "    .resetn     (HRESETn), \n");
+    fprintf(txt, "    .read_addr  (read_addr), \n");
+    fprintf(txt, "    .read_data  (read_data), \n");
+    fprintf(txt, "    .oe         (oe), \n");
+    fprintf(txt, "    .write_addr (write_addr), \n");
+    fprintf(txt, "    .write_data (write_data), \n");
+    fprintf(txt, "    .be         (be), \n");
+    if (master) {
+        fprintf(txt, "    .we         (we), \n");
+        fprintf(txt, "    .ready      (ready), \n");
+        fprintf(txt, "    .haddr      (haddr), \n");
+        fprintf(txt, "    .htrans     (htrans), \n");
+        fprintf(txt, "    .hsize      (hsize), \n");
+        fprintf(txt, "    .hwrite     (hwrite), \n");
+        fprintf(txt, "    .hready     (hready), \n");
+        fprintf(txt, "    .hprot      (hprot), \n");
+        fprintf(txt, "    .hburst     (hburst), \n");
+        fprintf(txt, "    .hwdata     (hwdata), \n");
+        fprintf(txt, "    .hlock      (hlock), \n");
+        fprintf(txt, "    .hresp      (hresp), \n");
+        fprintf(txt, "    .hrdata     (hrdata) \n");
+    } else {
+        fprintf(txt, "    .we         (we) \n");
+    }
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "endmodule \n");
+}
+
+
 static void print_header_file(FILE *txt, signal_struct *signals)
 {
     signal_struct *sp;
@@ -939,8 +1051,10 @@ main(int argc, char **argv)
     signal_struct *next_signal;
     FILE *verilog_file;
     FILE *header_file;
+    FILE *wrapper_file;
     char filename[STRLEN];
     char verilog_filename[STRLEN];
+    char wrapper_filename[STRLEN];
     char header_filename[STRLEN];
     char module_name[STRLEN] = DEFAULT_MODULE_NAME;
   
@@ -963,6 +1077,9 @@ main(int argc, char **argv)
     strcpy(verilog_filename, module_name);
     strcat(verilog_filename, ".v");
 
+    strcpy(wrapper_filename, module_name);
+    strcat(wrapper_filename, "_ahb.v");
+
     make_filenames(argv[2], header_filename);
 
     verilog_file = fopen(verilog_filename, "w");
@@ -994,6 +1111,15 @@ main(int argc, char **argv)
        if (has_master(signals)) instantiate_arbiter(verilog_file);
        print_epilog(verilog_file);
        print_header_file(header_file, signals);
+
+       wrapper_file = fopen(wrapper_filename, "w");
+       if (!wrapper_file) {
+           fprintf(stderr, "Unable to open file %s for writing. \n", wrapper_filename);
+           perror("if_gen");
+       } else {
+           print_ahb_wrapper(wrapper_file, signals);
+           fclose(wrapper_file);
+       }
     }
 
     while (signals) {
@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define STRLEN 1000
+#define NAMELEN (STRLEN + 32)   // a signal name with a suffix
 #define DEFAULT_MODULE_NAME "cat_accel"
 
 typedef struct sig_str_type {
@@ -13,9 +16,136 @@ typedef struct sig_str_type {
    int  is_wire;
    int  is_channel;
    int  is_master;
+   int  is_memory;
+   int  is_stream;
+   int  depth;            // words in a memory
+   int  stream_bits;      // TDATA width of a stream
    struct sig_str_type *next;
 } signal_struct;
 
+#define MAX_JOB_ITEMS 64
+
+typedef struct {
+   int  items;
+   char name[MAX_JOB_ITEMS][64];   // register, channel or memory of the spec
+   long count[MAX_JOB_ITEMS];      // accesses or elements per job
+   long config;           // host written registers changed per job
+   int  polls;            // reads of a ready, valid or status bit until it is set
+   int  done_polls;       // reads waiting for done or a DMA engine to finish
+   int  burst_size;       // beats per master burst, as written to BURST_SIZE_REG
+   long master_bytes;     // bytes over the master port per job
+   long compute;          // cycles the catapult instance computes per job
+} job_struct;
+
+// resource figures of the estimate, in the order of calibration_struct
+
+#define RESOURCES 4
+
+static const char *resource_names[RESOURCES] = { "flops", "mux_inputs", "ram_bits", "levels" };
+
+typedef struct {
+   double scale[RESOURCES];    // measured over estimated, from synthesis of earlier builds
+   long   max[RESOURCES];      // warn above this per module, 0 for no limit
+   int    mux_bits;            // select bits a logic level resolves, 2 for a 6 input LUT
+} calibration_struct;
+
+typedef struct opt_str_type {
+   int  bw_bits;          // data bus is 2^bw_bits bytes
+   int  id_bits;
+   int  addr_bits;
+   int  awuser_bits;      // user signal widths, 0 leaves the signal off the module
+   int  wuser_bits;
+   int  buser_bits;
+   int  aruser_bits;
+   int  ruser_bits;
+   int  cores;            // per-core job slots and a ticket lock when non-zero
+   char job_channel[STRLEN];   // input channel the job slots feed
+   int  core_clock;       // run the catapult instance on its own clock
+   int  cdc_depth;        // entries in each clock crossing FIFO
+   int  read_stages;      // register stages in the read mux tree
+   int  read_ram;         // read host written registers back from block RAM
+   int  stream_slice;     // register slice on each stream port
+   int  slice[5];         // register slice mode of each AXI slave channel, AW W B AR R
+   char dma_in[STRLEN];   // input channel fed by the DMA read engine, "" for none
+   char dma_out[STRLEN];  // output channel drained by the DMA write engine, "" for none
+   int  scatter_gather;   // remap the master port through a segment list in memory
+   int  testbench;        // also write a self-checking throughput testbench
+   int  replay;           // also write a bench replaying an ACCEL_TRACE capture
+   int  top;              // also write a top level, 0 none, 1 AXI4-Lite, 2 AXI4
+   char perf_job[STRLEN]; // job file of the performance report, "" for none
+   job_struct job;        // the job it describes
+   int  resources;        // also write a resource estimate of each module
+   char calibration[STRLEN];   // calibration file of the estimate, "" for none
+   calibration_struct cal;
+} option_struct;
+
+static option_struct options;
+
+// AXI master channels other than VALID/READY, in the order they are packed
+// through the clock crossing.  A width of NULL is the USER signal of the channel.
+
+typedef struct axi_field_type {
+   char *name;
+   char *width;
+} axi_field;
+
+static const char *axi_channels[] = { "AW", "W", "B", "AR", "R" };
+
+static axi_field axi_fields[5][12] = {
+   { {"ID", "ID_BITS"}, {"ADDR", "ADDR_BITS"}, {"LEN", "8"}, {"SIZE", "3"}, {"BURST", "2"}, {"LOCK", "1"},
+     {"CACHE", "4"}, {"PROT", "3"}, {"REGION", "4"}, {"QOS", "4"}, {"USER", NULL}, {NULL, NULL} },
+   { {"ID", "ID_BITS"}, {"DATA", "DATA_BITS"}, {"STRB", "STRB_BITS"}, {"USER", NULL}, {"LAST", "1"}, {NULL, NULL} },
+   { {"ID", "ID_BITS"}, {"RESP", "2"}, {"USER", NULL}, {NULL, NULL} },
+   { {"ID", "ID_BITS"}, {"ADDR", "ADDR_BITS"}, {"LEN", "8"}, {"SIZE", "3"}, {"BURST", "2"}, {"LOCK", "1"},
+     {"CACHE", "4"}, {"PROT", "3"}, {"REGION", "4"}, {"QOS", "4"}, {"USER", NULL}, {NULL, NULL} },
+   { {"ID", "ID_BITS"}, {"DATA", "DATA_BITS"}, {"RESP", "2"}, {"USER", NULL}, {"LAST", "1"}, {NULL, NULL} }
+};
+
+
+// register slices of axi_slave_interface, in the order of axi_channels
+
+static const char *slice_options[] = { "aw_slice", "w_slice", "b_slice", "ar_slice", "r_slice" };
+static const char *slice_modes[]   = { "bypass", "forward", "backward", "full" };
+
+static const char *top_modes[] = { "none", "lite", "axi4" };
+
+
+static void default_options(option_struct *opt)
+{
+   int i;
+
+   opt->bw_bits     = 3;
+   opt->id_bits     = 4;
+   opt->addr_bits   = 32;
+   opt->awuser_bits = 0;
+   opt->wuser_bits  = 0;
+   opt->buser_bits  = 0;
+   opt->aruser_bits = 0;
+   opt->ruser_bits  = 0;
+   opt->cores       = 0;
+   strcpy(opt->job_channel, "go");
+   opt->core_clock  = 0;
+   opt->cdc_depth   = 4;
+   opt->read_stages = 1;
+   opt->read_ram    = 0;
+   opt->stream_slice = 0;
+   memset(opt->slice, 0, sizeof(opt->slice));
+   strcpy(opt->dma_in, "");
+   strcpy(opt->dma_out, "");
+   opt->scatter_gather = 0;
+   opt->testbench   = 0;
+   opt->replay      = 0;
+   opt->top         = 0;
+   strcpy(opt->perf_job, "");
+   opt->resources   = 0;
+   strcpy(opt->calibration, "");
+   for (i=0; i<RESOURCES; i++) {
+      opt->cal.scale[i] = 1.0;
+      opt->cal.max[i]   = 0;
+   }
+   opt->cal.mux_bits = 2;
+}
+
 
 static void clean_whitespace(char *s)
 {
@@ -151,6 +281,421 @@ static int valid_master_str(char *s)
    return 0;
 }
 
+static int valid_memory_str(char *s)
+{
+   if (0 == strcmp(lowercase(s), "memory")) return 1;
+   return 0;
+}
+
+static int valid_stream_str(char *s)
+{
+   if (0 == strcmp(lowercase(s), "stream")) return 1;
+   return 0;
+}
+
+
+static int valid_number_str(char *s)
+{
+   if (strlen(s) == 0) return 0;
+
+   while (*s) {
+      if (!isdigit(*s)) return 0;
+      s++;
+   }
+   return 1;
+}
+
+
+static int parse_job(char *filename, job_struct *job)
+{
+   /*
+    * file should have the following format:
+    *
+    * <name> = <count>
+    *
+    * where <name> is a register, channel or memory of the spec and <count>
+    * the accesses or elements of it per job, or one of
+    *
+    * config = <registers>          host written registers changed per job
+    * polls = <reads>               reads of a poll until its bit is set (default 1)
+    * done_polls = <reads>          reads waiting for done or a DMA engine (default 1)
+    * burst_size = <beats>          master burst, as written to BURST_SIZE_REG (default 16)
+    * master_bytes = <bytes>        bytes over the master port per job
+    * compute = <cycles>            cycles the catapult instance computes per job
+    */
+
+   FILE *job_spec;
+   char line[STRLEN];
+   char *value;
+   long num;
+   int line_no = 0;
+
+   memset(job, 0, sizeof(job_struct));
+   job->polls = 1;
+   job->done_polls = 1;
+   job->burst_size = 16;
+
+   job_spec = fopen(filename, "r");
+   if (!job_spec) {
+      fprintf(stderr, "Unable to open file %s for reading \n", filename);
+      perror("if_gen");
+      return 0;
+   }
+
+   while (fgets(line, sizeof(line), job_spec)) {
+      line_no++;
+
+      clean_whitespace(line);
+      if (strlen(line) == 0) continue;
+      if (comment(line)) continue;
+
+      if (!(value = strchr(line, '='))) {
+         fprintf(stderr, "Expected <name> = <count> at line %d of %s \n", line_no, filename);
+         fclose(job_spec);
+         return 0;
+      }
+      *value++ = 0;
+      clean_whitespace(line);
+      clean_whitespace(value);
+      lowercase(line);
+      if (!valid_signal_name(line) || (strlen(line) >= 64) || !valid_number_str(value) || (strlen(value) > 12)) {
+         fprintf(stderr, "Invalid line %d of %s \n", line_no, filename);
+         fclose(job_spec);
+         return 0;
+      }
+      num = atol(value);
+
+      if (0 == strcmp(line, "config"))            job->config = num;
+      else if (0 == strcmp(line, "polls"))        job->polls = num;
+      else if (0 == strcmp(line, "done_polls"))   job->done_polls = num;
+      else if (0 == strcmp(line, "master_bytes")) job->master_bytes = num;
+      else if (0 == strcmp(line, "compute"))      job->compute = num;
+      else if (0 == strcmp(line, "burst_size")) {
+         if ((num < 1) || (num > 256)) {
+            fprintf(stderr, "burst_size must be from 1 to 256 at line %d of %s \n", line_no, filename);
+            fclose(job_spec);
+            return 0;
+         }
+         job->burst_size = num;
+      } else {
+         if (job->items == MAX_JOB_ITEMS) {
+            fprintf(stderr, "More than %d names in %s \n", MAX_JOB_ITEMS, filename);
+            fclose(job_spec);
+            return 0;
+         }
+         strcpy(job->name[job->items], line);
+         job->count[job->items++] = num;
+      }
+   }
+
+   fclose(job_spec);
+
+   if ((job->polls < 1) || (job->done_polls < 1)) {
+      fprintf(stderr, "polls and done_polls must be at least 1 in %s \n", filename);
+      return 0;
+   }
+   return 1;
+}
+
+
+static int parse_calibration(char *filename, calibration_struct *cal)
+{
+   /*
+    * file should have the following format:
+    *
+    * <resource> = <scale>          measured over estimated, default 1
+    * max_<resource> = <limit>      warn when a module estimates above it
+    * mux_bits = <bits>             select bits a logic level resolves (default 2)
+    *
+    * where <resource> is flops, mux_inputs, ram_bits or levels
+    */
+
+   FILE *cal_spec;
+   char line[STRLEN];
+   char *value;
+   char *end;
+   double num;
+   int line_no = 0;
+   int ok;
+   int i;
+
+   for (i=0; i<RESOURCES; i++) {
+      cal->scale[i] = 1.0;
+      cal->max[i]   = 0;
+   }
+   cal->mux_bits = 2;
+
+   cal_spec = fopen(filename, "r");
+   if (!cal_spec) {
+      fprintf(stderr, "Unable to open file %s for reading \n", filename);
+      perror("if_gen");
+      return 0;
+   }
+
+   while (fgets(line, sizeof(line), cal_spec)) {
+      line_no++;
+
+      clean_whitespace(line);
+      if (strlen(line) == 0) continue;
+      if (comment(line)) continue;
+
+      ok = 0;
+      if ((value = strchr(line, '='))) {
+         *value++ = 0;
+         clean_whitespace(line);
+         clean_whitespace(value);
+         lowercase(line);
+         num = strtod(value, &end);
+         ok = (strlen(value) != 0) && (*end == 0) && (num >= 0);
+      }
+      if (ok && (0 == strcmp(line, "mux_bits"))) {
+         ok = valid_number_str(value) && (num >= 1) && (num <= 8);
+         cal->mux_bits = num;
+      } else if (ok) {
+         ok = 0;
+         for (i=0; i<RESOURCES; i++) {
+            if (0 == strcmp(line, resource_names[i])) {
+               ok = (num > 0);
+               cal->scale[i] = num;
+            } else if ((0 == strncmp(line, "max_", 4)) && (0 == strcmp(line + 4, resource_names[i]))) {
+               ok = valid_number_str(value) && (strlen(value) <= 12);
+               cal->max[i] = atol(value);
+            }
+         }
+      }
+      if (!ok) {
+         fprintf(stderr, "Invalid line %d of %s \n", line_no, filename);
+         fclose(cal_spec);
+         return 0;
+      }
+   }
+
+   fclose(cal_spec);
+   return 1;
+}
+
+
+static int set_option(char *name, char *value)
+{
+   /*
+    * options come from "<name> = <value>" lines in the spec file or from
+    * "-<name> <value>" on the command line, the command line wins
+    */
+
+   int num;
+   int bw;
+   int c;
+
+   lowercase(name);
+
+   for (c=0; c<5; c++) {
+      if (0 == strcmp(name, slice_options[c])) {
+         for (num=0; num<4; num++) {
+            if ((0 == strcmp(value, slice_modes[num])) || ((value[0] == '0' + num) && !value[1])) {
+               options.slice[c] = num;
+               return 1;
+            }
+         }
+         fprintf(stderr, "%s must be bypass, forward, backward or full: %s \n", name, value);
+         return 0;
+      }
+   }
+   if (0 == strcmp(name, "top")) {
+      for (num=0; num<3; num++) {
+         if ((0 == strcmp(value, top_modes[num])) || ((value[0] == '0' + num) && !value[1])) {
+            options.top = num;
+            return 1;
+         }
+      }
+      fprintf(stderr, "top must be none, lite or axi4: %s \n", value);
+      return 0;
+   }
+
+   if (0 == strcmp(name, "perf_job")) {
+      // read now, the sweep writes each variant from its own directory
+      if ((strlen(value) == 0) || !parse_job(value, &options.job)) {
+         fprintf(stderr, "Invalid value for option %s: %s \n", name, value);
+         return 0;
+      }
+      strcpy(options.perf_job, value);
+      return 1;
+   }
+   if (0 == strcmp(name, "calibration")) {
+      if ((strlen(value) == 0) || !parse_calibration(value, &options.cal)) {
+         fprintf(stderr, "Invalid value for option %s: %s \n", name, value);
+         return 0;
+      }
+      strcpy(options.calibration, value);
+      return 1;
+   }
+   if (0 == strcmp(name, "job_channel")) {
+      if (!valid_signal_name(value)) {
+         fprintf(stderr, "Invalid value for option %s: %s \n", name, value);
+         return 0;
+      }
+      strcpy(options.job_channel, value);
+      return 1;
+   }
+   if ((0 == strcmp(name, "dma_in")) || (0 == strcmp(name, "dma_out"))) {
+      if (!valid_signal_name(value)) {
+         fprintf(stderr, "Invalid value for option %s: %s \n", name, value);
+         return 0;
+      }
+      strcpy((0 == strcmp(name, "dma_in")) ? options.dma_in : options.dma_out, value);
+      return 1;
+   }
+
+   if (!valid_number_str(value)) {
+      fprintf(stderr, "Invalid value for option %s: %s \n", name, value);
+      return 0;
+   }
+
+   num = atoi(value);
+
+   if (0 == strcmp(name, "data_bits")) {
+      for (bw=2; bw<=7; bw++) {
+         if ((8 << bw) == num) {
+            options.bw_bits = bw;
+            return 1;
+         }
+      }
+      fprintf(stderr, "data_bits must be a power of 2 from 32 to 1024: %s \n", value);
+      return 0;
+   }
+   if (0 == strcmp(name, "id_bits")) {
+      if ((num < 1) || (num > 32)) {
+         fprintf(stderr, "id_bits must be from 1 to 32: %s \n", value);
+         return 0;
+      }
+      options.id_bits = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "addr_bits")) {
+      if ((num < 12) || (num > 64)) {
+         fprintf(stderr, "addr_bits must be from 12 to 64: %s \n", value);
+         return 0;
+      }
+      options.addr_bits = num;
+      return 1;
+   }
+   if ((0 == strcmp(name, "awuser_bits")) || (0 == strcmp(name, "wuser_bits")) || (0 == strcmp(name, "buser_bits")) ||
+       (0 == strcmp(name, "aruser_bits")) || (0 == strcmp(name, "ruser_bits"))) {
+      if (num > 1024) {
+         fprintf(stderr, "%s must be from 0 to 1024: %s \n", name, value);
+         return 0;
+      }
+      if (name[0] == 'w')      options.wuser_bits  = num;
+      else if (name[0] == 'b') options.buser_bits  = num;
+      else if (name[0] == 'r') options.ruser_bits  = num;
+      else if (name[1] == 'w') options.awuser_bits = num;
+      else                     options.aruser_bits = num;
+      return 1;
+   }
+
+   if (0 == strcmp(name, "core_clock")) {
+      if (num > 1) {
+         fprintf(stderr, "core_clock must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.core_clock = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "cdc_depth")) {
+      if ((num < 4) || (num > 256) || (num & (num - 1))) {
+         fprintf(stderr, "cdc_depth must be a power of 2 from 4 to 256: %s \n", value);
+         return 0;
+      }
+      options.cdc_depth = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "read_stages")) {
+      if ((num < 1) || (num > 4)) {
+         fprintf(stderr, "read_stages must be from 1 to 4: %s \n", value);
+         return 0;
+      }
+      options.read_stages = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "read_ram")) {
+      if (num > 1) {
+         fprintf(stderr, "read_ram must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.read_ram = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "stream_slice")) {
+      if (num > 1) {
+         fprintf(stderr, "stream_slice must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.stream_slice = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "testbench")) {
+      if (num > 1) {
+         fprintf(stderr, "testbench must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.testbench = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "replay")) {
+      if (num > 1) {
+         fprintf(stderr, "replay must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.replay = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "scatter_gather")) {
+      if (num > 1) {
+         fprintf(stderr, "scatter_gather must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.scatter_gather = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "resources")) {
+      if (num > 1) {
+         fprintf(stderr, "resources must be 0 or 1: %s \n", value);
+         return 0;
+      }
+      options.resources = num;
+      return 1;
+   }
+   if (0 == strcmp(name, "cores")) {
+      if (num > 32) {
+         fprintf(stderr, "cores must be from 0 to 32: %s \n", value);
+         return 0;
+      }
+      options.cores = num;
+      return 1;
+   }
+
+   fprintf(stderr, "Unknown option %s \n", name);
+   return 0;
+}
+
+
+static int parse_option(char *line, int line_no)
+{
+   char name[STRLEN];
+   char *value;
+
+   strcpy(name, line);
+   value = strchr(name, '=');
+   *value++ = 0;
+   clean_whitespace(name);
+   clean_whitespace(value);
+
+   if (!valid_signal_name(name)) {
+      fprintf(stderr, "Invalid option name at line %d: %s \n", line_no, name);
+      return 0;
+   }
+   return set_option(name, value);
+}
+
 
 static signal_struct *parse_interface(char *filename)
 {
@@ -159,6 +704,18 @@ static signal_struct *parse_interface(char *filename)
     *
     * <signal_name>, <width>, [signed | unsigned], [input | output], [wires | channel | master]
     *
+    * or a memory, depth in words:
+    *
+    * <memory_name>, <width>, [signed | unsigned], [input | output], memory, <depth>
+    *
+    * or a stream, optionally with a TDATA width:
+    *
+    * <stream_name>, <width>, [signed | unsigned], [input | output], stream [, <tdata_bits>]
+    *
+    * or an option setting:
+    *
+    * <option_name> = <value>
+    *
     */
 
    FILE *if_spec;
@@ -170,6 +727,7 @@ static signal_struct *parse_interface(char *filename)
    char signed_str[STRLEN];
    char input_str[STRLEN];
    char wire_str[STRLEN];
+   char depth_str[STRLEN];
    signal_struct *ret_val = NULL;
    signal_struct *signals;
    signal_struct *parent;
@@ -188,6 +746,11 @@ static signal_struct *parse_interface(char *filename)
       if (strlen(line) == 0) continue;
       if (comment(line)) continue;
 
+      if (strchr(line, '=')) {
+         if (!parse_option(line, line_no)) return NULL;
+         continue;
+      }
+
       signal_name[0] = 0;
       r = strtok(line, ",");
       if (r) strcpy(signal_name, r);
@@ -213,6 +776,11 @@ static signal_struct *parse_interface(char *filename)
       if (r) strcpy(wire_str, r);
       clean_whitespace(wire_str);
 
+      depth_str[0] = 0;
+      r = strtok(NULL, ",");
+      if (r) strcpy(depth_str, r);
+      clean_whitespace(depth_str);
+
       if (!valid_signal_name(signal_name)) {
          fprintf(stderr, "Invalid signal name at line %d: %s \n", line_no, signal_name);
          return ret_val;
@@ -233,11 +801,25 @@ static signal_struct *parse_interface(char *filename)
          return ret_val;
       }
 
-      if (!valid_wire_str(wire_str) && !valid_channel_str(wire_str) && !valid_master_str(wire_str)) {
+      if (!valid_wire_str(wire_str) && !valid_channel_str(wire_str) && !valid_master_str(wire_str) &&
+          !valid_memory_str(wire_str) && !valid_stream_str(wire_str)) {
          fprintf(stderr, "Invalid wire string at line %d: %s \n", line_no, wire_str);
          return ret_val;
       }
+
+      if (valid_memory_str(wire_str) &&
+          (!valid_number_str(depth_str) || (atoi(depth_str) < 2) || (atoi(depth_str) > (1 << 24)))) {
+         fprintf(stderr, "Invalid memory depth at line %d: %s \n", line_no, depth_str);
+         return ret_val;
+      }
     
+      // TDATA holds a whole number of byte aligned elements
+      if (valid_stream_str(wire_str) && strlen(depth_str) &&
+          (!valid_width_str(depth_str) || (atoi(depth_str) % (8 * ((atoi(width_str) + 7) / 8))))) {
+         fprintf(stderr, "Invalid stream TDATA width at line %d: %s \n", line_no, depth_str);
+         return ret_val;
+      }
+
       signals = (signal_struct *) malloc (sizeof(signal_struct));
       if (signals == NULL) {
          fprintf(stderr, "Unable to allocate memory for signal struct \n");
@@ -252,6 +834,11 @@ static signal_struct *parse_interface(char *filename)
       signals->is_wire   = (0 == strcmp(lowercase(wire_str),   "wire"   )) ? 1 : 0;
       signals->is_channel= (0 == strcmp(lowercase(wire_str),   "channel")) ? 1 : 0;
       signals->is_master = (0 == strcmp(lowercase(wire_str),   "master" )) ? 1 : 0;
+      signals->is_memory = (0 == strcmp(lowercase(wire_str),   "memory" )) ? 1 : 0;
+      signals->is_stream = (0 == strcmp(lowercase(wire_str),   "stream" )) ? 1 : 0;
+      signals->depth  = (signals->is_memory) ? atoi(depth_str) : 0;
+      signals->stream_bits = 8 * ((signals->width + 7) / 8);
+      if (signals->is_stream && strlen(depth_str)) signals->stream_bits = atoi(depth_str);
       signals->next   = NULL;
 
       if (ret_val == NULL) {
@@ -274,6 +861,12 @@ static signal_struct *parse_interface(char *filename)
 }
 
 
+static int in_register_bank(signal_struct *sp)
+{
+    return sp->is_wire || sp->is_channel;
+}
+
+
 static int has_master(signal_struct *signals)
 {
     signal_struct *sp;
@@ -302,7 +895,21 @@ static int master_width(signal_struct *signals)
 }
 
 
-static int register_count(signal_struct *signals)
+static signal_struct *find_signal(signal_struct *signals, char *name)
+{
+    signal_struct *sp;
+    
+    sp = signals;
+
+    while (sp) {
+        if (0 == strcmp(sp->signal_name, name)) return sp;
+        sp = sp->next;
+    }
+    return NULL;
+}
+
+
+static int channel_count(signal_struct *signals)
 {
     signal_struct *sp;
     int count = 0;
@@ -310,126 +917,399 @@ static int register_count(signal_struct *signals)
     sp = signals;
 
     while (sp) {
-        if (sp->is_wire) count++;
-        if (sp->is_channel) count+=2;
-        if (sp->is_master) count+=3;
+        if (sp->is_channel) count++;
         sp = sp->next;
     }
-
     return count;
 }
 
 
-static void print_defines(FILE *txt, signal_struct *signals)
+static int memory_count(signal_struct *signals)
 {
-    // todo, open a file for this
-    //
-    fprintf(txt, "`define bw_bits      3                                                 \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, "`define m_bits       4                                                 \n");
-    fprintf(txt, "`define id_bits      4                                                 \n");
-    fprintf(txt, "`define slave_id_bits 7                                                \n");
-    fprintf(txt, "`define addr_bits   32                                                 \n");
-    fprintf(txt, "`define len_bits     8                                                 \n");
-    fprintf(txt, "`define data_bits    (8 * (1 << `bw_bits))                             \n");
-    fprintf(txt, "`define strb_bits    (`data_bits/8)                                    \n");
-    fprintf(txt, "`define size_bits    3                                                 \n");
-    fprintf(txt, "`define burst_bits   2                                                 \n");
-    fprintf(txt, "`define lock_bits    1                                                 \n");
-    fprintf(txt, "`define cache_bits   4                                                 \n");
-    fprintf(txt, "`define prot_bits    3                                                 \n");
-    fprintf(txt, "`define resp_bits    2                                                 \n");
-    fprintf(txt, "`define ruser_bits   7                                                 \n");
-    fprintf(txt, "`define wuser_bits   9                                                 \n");
-    fprintf(txt, "`define snoop_bits   3                                                 \n");
-    fprintf(txt, "`define region_bits  4                                                 \n");
-    fprintf(txt, "`define qos_bits     4                                                 \n");
-    fprintf(txt, "                                                                       \n");
+    signal_struct *sp;
+    int count = 0;
 
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory) count++;
+        sp = sp->next;
+    }
+    return count;
 }
 
 
-static void print_intro(FILE *txt, signal_struct *signals, char *instance_name)
+static int packet_count(signal_struct *signals)
 {
-    int master = has_master(signals);
+    // output streams, each with a <NAME>_PACKET register
 
-    fprintf(txt, "module cat_accel_%s (                                                  \n", instance_name);
-    fprintf(txt, "  input          clock,                                                \n");
-    fprintf(txt, "  input          resetn,                                               \n");
-    fprintf(txt, "  input  [15-`bw_bits:0]  read_addr,                                            \n");
-    fprintf(txt, "  output [`data_bits-1:0]  read_data,                                            \n");
-    fprintf(txt, "  input          oe,                                                   \n");
-    fprintf(txt, "  input  [15-`bw_bits:0]  write_addr,                                           \n");
-    fprintf(txt, "  input  [`data_bits-1:0]  write_data,                                           \n");
-    fprintf(txt, "  input  [`strb_bits-1:0]   be,                                                   \n");
-    fprintf(txt, "  input          we                                                    \n");
-    if (master) {
-        fprintf(txt, "  ,                                                                    \n");
-        fprintf(txt, "  output [`id_bits-1:0]           AWID,                                \n");
-        fprintf(txt, "  output [`addr_bits-1:0]         AWADDR,                              \n");
-        fprintf(txt, "  output [`len_bits-1:0]          AWLEN,                               \n");
-        fprintf(txt, "  output [`size_bits-1:0]         AWSIZE,                              \n");
-        fprintf(txt, "  output [`burst_bits-1:0]        AWBURST,                             \n");
-        fprintf(txt, "  output [`lock_bits-1:0]         AWLOCK,                              \n");
-        fprintf(txt, "  output [`cache_bits-1:0]        AWCACHE,                             \n");
-        fprintf(txt, "  output [`prot_bits-1:0]         AWPROT,                              \n");
-        fprintf(txt, "  output [`region_bits-1:0]       AWREGION,                            \n");
-        fprintf(txt, "  output [`qos_bits-1:0]          AWQOS,                               \n");
-        fprintf(txt, "  output                          AWVALID,                             \n");
-        fprintf(txt, "  input                           AWREADY,                             \n");
-        fprintf(txt, "                                                                       \n");
-        fprintf(txt, "  output [`id_bits-1:0]           WID,                                 \n");
-        fprintf(txt, "  output [`data_bits-1:0]         WDATA,                               \n");
-        fprintf(txt, "  output [`strb_bits-1:0]         WSTRB,                               \n");
-        fprintf(txt, "  output                          WLAST,                               \n");
-        fprintf(txt, "  output                          WVALID,                              \n");
-        fprintf(txt, "  input                           WREADY,                              \n");
-        fprintf(txt, "                                                                       \n");
-        fprintf(txt, "  input  [`id_bits-1:0]           BID,                                 \n");
-        fprintf(txt, "  input  [`resp_bits-1:0]         BRESP,                               \n");
-        fprintf(txt, "  input                           BVALID,                              \n");
-        fprintf(txt, "  output                          BREADY,                              \n");
-        fprintf(txt, "                                                                       \n");
-        fprintf(txt, "  output [`id_bits-1:0]           ARID,                                \n");
-        fprintf(txt, "  output [`addr_bits-1:0]         ARADDR,                              \n");
-        fprintf(txt, "  output [`len_bits-1:0]          ARLEN,                               \n");
-        fprintf(txt, "  output [`size_bits-1:0]         ARSIZE,                              \n");
-        fprintf(txt, "  output [`burst_bits-1:0]        ARBURST,                             \n");
-        fprintf(txt, "  output [`lock_bits-1:0]         ARLOCK,                              \n");
-        fprintf(txt, "  output [`cache_bits-1:0]        ARCACHE,                             \n");
-        fprintf(txt, "  output [`prot_bits-1:0]         ARPROT,                              \n");
-        fprintf(txt, "  output [`region_bits-1:0]       ARREGION,                            \n");
-        fprintf(txt, "  output [`qos_bits-1:0]          ARQOS,                               \n");
-        fprintf(txt, "  output                          ARVALID,                             \n");
-        fprintf(txt, "  input                           ARREADY,                             \n");
-        fprintf(txt, "                                                                       \n");
-        fprintf(txt, "  input  [`id_bits-1:0]           RID,                                 \n");
-        fprintf(txt, "  input  [`data_bits-1:0]         RDATA,                               \n");
-        fprintf(txt, "  input  [`resp_bits-1:0]         RRESP,                               \n");
-        fprintf(txt, "  input                           RLAST,                               \n");
-        fprintf(txt, "  input                           RVALID,                              \n");
-        fprintf(txt, "  output                          RREADY                               \n");
-        fprintf(txt, "                                                                       \n");
+    signal_struct *sp;
+    int count = 0;
+
+    sp = signals;
+    while (sp) {
+        if (sp->is_stream && !sp->is_input) count++;
+        sp = sp->next;
     }
-    fprintf(txt, ");                                                                     \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, " reg     [63:0]  register_bank[%d:0];                                  \n", register_count(signals)-1);
-    fprintf(txt, " reg     [63:0]  rd_reg;                                               \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, " reg             ready_out = 1'b1;                                     \n");
-    fprintf(txt, " reg             resp_out = 2'b00;                                     \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, " wire    [15-`bw_bits:0]  read_address;                                \n");
-    fprintf(txt, " wire    [15-`bw_bits:0]  write_address;                               \n");
+    return count;
+}
+
+
+static int log2_ceil(int n)
+{
+    int bits = 0;
+
+    while ((1 << bits) < n) bits++;
+    return bits;
+}
+
+
+static int has_dma(void)
+{
+    return options.dma_in[0] || options.dma_out[0];
+}
+
+
+static int dma_register_count(void)
+{
+    // ADDR_LOW, ADDR_HIGH, COUNT and STATUS for each engine
+    return ((options.dma_in[0]) ? 4 : 0) + ((options.dma_out[0]) ? 4 : 0);
+}
+
+
+static int sg_register_count(void)
+{
+    // LIST_LOW, LIST_HIGH, COUNT and STATUS of the scatter-gather unit
+    return (options.scatter_gather) ? 4 : 0;
+}
+
+
+static int dma_elem_bits(signal_struct *sp)
+{
+    // a channel element sits in memory in the next power of 2 bytes
+    return 8 << log2_ceil((sp->width + 7) / 8);
+}
+
+
+static int memory_window_bits(signal_struct *signals)
+{
+    // word address bits of each window in the slave address space, the
+    // registers take window 0 and each memory the next one in spec order
+
+    signal_struct *sp;
+    int bits = 16 - options.bw_bits;
+
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory && (log2_ceil(sp->depth) > bits)) bits = log2_ceil(sp->depth);
+        sp = sp->next;
+    }
+    return bits;
+}
+
+
+static int slave_bits(signal_struct *signals)
+{
+    // byte address bits decoded by the generated module
+
+    if (!memory_count(signals)) return 16;
+    return memory_window_bits(signals) + log2_ceil(memory_count(signals) + 1) + options.bw_bits;
+}
+
+
+static int register_count(signal_struct *signals)
+{
+    signal_struct *sp;
+    int count = 0;
+
+    sp = signals;
+
+    while (sp) {
+        if (sp->is_wire) count++;
+        if (sp->is_channel) count+=2;
+        if (sp->is_master) count+=3;
+        sp = sp->next;
+    }
+    if (options.cores) count += 3 + options.cores;
+    count += (channel_count(signals) + 31) / 32;
+    count += packet_count(signals);
+    count += dma_register_count();
+    count += sg_register_count();
+
+    return count;
+}
+
+
+static int host_written(signal_struct *signals, int index)
+{
+    // 1 when only the host writes register index, so a copy of the
+    // register taken at write time reads back the same value
+
+    signal_struct *sp;
+    int offset = 0;
+    int host;
+
+    sp = signals;
+
+    while (sp) {
+        if (in_register_bank(sp)) {
+            host = sp->is_input && (sp->is_wire ||
+                   !(options.cores && (0 == strcmp(sp->signal_name, options.job_channel))));
+            if (offset++ == index) return host;
+            if (sp->is_channel && (offset++ == index)) return 0;
+        }
+        sp = sp->next;
+    }
+    if (has_master(signals)) offset += 3;
+    if (options.cores) {
+        offset += 3;
+        if ((index >= offset) && (index < offset + options.cores)) return 1;
+        offset += options.cores;
+    }
+    offset += (channel_count(signals) + 31) / 32;
+    if ((index >= offset) && (index < offset + packet_count(signals))) return 1;
+    offset += packet_count(signals);
+    if (index >= offset) return ((index - offset) % 4) != 3;   // DMA and SG STATUS are updated by the engines
+    return 0;
+}
+
+
+static int read_stages(signal_struct *signals)
+{
+    // read_stages less any stage that would be left without address bits
+
+    int count = register_count(signals);
+    int bits = 1;
+
+    int k;
+
+    while ((1 << bits) < count) bits++;
+    k = (bits + options.read_stages - 1) / options.read_stages;
+    return (bits + k - 1) / k;
+}
+
+
+static int read_latency(signal_struct *signals)
+{
+    if (options.read_ram) return 2;
+    return read_stages(signals);
+}
+
+
+static void print_defines(FILE *txt, signal_struct *signals)
+{
+    // bus geometry is a parameter of each generated module, so differently
+    // sized interfaces can share a simulation without colliding defines
+
+    fprintf(txt, " #(                                                                    \n");
+    fprintf(txt, "  parameter BW_BITS      = %d,                                         \n", options.bw_bits);
+    fprintf(txt, "  parameter DATA_BITS    = (8 * (1 << BW_BITS)),                       \n");
+    fprintf(txt, "  parameter STRB_BITS    = (DATA_BITS/8),                              \n");
+    fprintf(txt, "  parameter ID_BITS      = %d,                                         \n", options.id_bits);
+    if (options.awuser_bits) fprintf(txt, "  parameter AWUSER_BITS  = %d,                                         \n", options.awuser_bits);
+    if (options.wuser_bits)  fprintf(txt, "  parameter WUSER_BITS   = %d,                                         \n", options.wuser_bits);
+    if (options.buser_bits)  fprintf(txt, "  parameter BUSER_BITS   = %d,                                         \n", options.buser_bits);
+    if (options.aruser_bits) fprintf(txt, "  parameter ARUSER_BITS  = %d,                                         \n", options.aruser_bits);
+    if (options.ruser_bits)  fprintf(txt, "  parameter RUSER_BITS   = %d,                                         \n", options.ruser_bits);
+    fprintf(txt, "  parameter ADDR_BITS    = %d,                                         \n", options.addr_bits);
+    fprintf(txt, "  parameter SLAVE_BITS   = %d                                          \n", slave_bits(signals));
+    fprintf(txt, " )                                                                     \n");
+}
+
+
+static void print_user_signal(FILE *txt, char *name, char *param, int bits, int is_input)
+{
+    if (bits) {
+        fprintf(txt, "  %s [%s-1:0]%*s%s,%*s\n", is_input ? "input ":"output", param, 20-(int)strlen(param), "", name, 29-(int)strlen(name), "");
+    }
+}
+
+
+static char *axi_field_width(int channel, axi_field *f, char *buf)
+{
+    int user_bits[5];
+
+    if (f->width) return f->width;
+
+    user_bits[0] = options.awuser_bits;
+    user_bits[1] = options.wuser_bits;
+    user_bits[2] = options.buser_bits;
+    user_bits[3] = options.aruser_bits;
+    user_bits[4] = options.ruser_bits;
+
+    if (user_bits[channel]) sprintf(buf, "%sUSER_BITS", axi_channels[channel]);
+    else strcpy(buf, "1");
+    return buf;
+}
+
+
+static void print_user_wires(FILE *txt)
+{
+    // user signals left off the module are tied off for the catapult master
+
+    if (!options.awuser_bits) fprintf(txt, " wire            AWUSER;                                               \n");
+    if (!options.wuser_bits)  fprintf(txt, " wire            WUSER;                                                \n");
+    if (!options.buser_bits)  fprintf(txt, " wire            BUSER = 1'b0;                                         \n");
+    if (!options.aruser_bits) fprintf(txt, " wire            ARUSER;                                               \n");
+    if (!options.ruser_bits)  fprintf(txt, " wire            RUSER = 1'b0;                                         \n");
+}
+
+
+static void print_module_ports(FILE *txt, signal_struct *signals)
+{
+    // stream, master and DMA ports of the generated module, each group
+    // opened by a comma after the port before it
+
+    signal_struct *sp;
+
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream) {
+            char *in  = (sp->is_input) ? "input " : "output";
+            char *out = (sp->is_input) ? "output" : "input ";
+            char range[STRLEN];
+
+            fprintf(txt, "  ,                                                                    \n");
+            sprintf(range, "[%d:0]", sp->stream_bits-1);
+            fprintf(txt, "  %s %-25s%s_TDATA, \n", in, range, sp->signal_name);
+            sprintf(range, "[%d:0]", sp->stream_bits/8-1);
+            fprintf(txt, "  %s %-25s%s_TKEEP, \n", in, range, sp->signal_name);
+            fprintf(txt, "  %s %-25s%s_TLAST, \n", in, "", sp->signal_name);
+            fprintf(txt, "  %s %-25s%s_TVALID, \n", in, "", sp->signal_name);
+            fprintf(txt, "  %s %-25s%s_TREADY \n", out, "", sp->signal_name);
+        }
+    }
+    if (has_master(signals)) {
+        fprintf(txt, "  ,                                                                    \n");
+        fprintf(txt, "  output [ID_BITS-1:0]            AWID,                                \n");
+        fprintf(txt, "  output [ADDR_BITS-1:0]          AWADDR,                              \n");
+        fprintf(txt, "  output [7:0]                    AWLEN,                               \n");
+        fprintf(txt, "  output [2:0]                    AWSIZE,                              \n");
+        fprintf(txt, "  output [1:0]                    AWBURST,                             \n");
+        fprintf(txt, "  output [0:0]                    AWLOCK,                              \n");
+        fprintf(txt, "  output [3:0]                    AWCACHE,                             \n");
+        fprintf(txt, "  output [2:0]                    AWPROT,                              \n");
+        fprintf(txt, "  output [3:0]                    AWREGION,                            \n");
+        fprintf(txt, "  output [3:0]                    AWQOS,                               \n");
+        print_user_signal(txt, "AWUSER", "AWUSER_BITS", options.awuser_bits, 0);
+        fprintf(txt, "  output                          AWVALID,                             \n");
+        fprintf(txt, "  input                           AWREADY,                             \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  output [ID_BITS-1:0]            WID,                                 \n");
+        fprintf(txt, "  output [DATA_BITS-1:0]          WDATA,                               \n");
+        fprintf(txt, "  output [STRB_BITS-1:0]          WSTRB,                               \n");
+        print_user_signal(txt, "WUSER", "WUSER_BITS", options.wuser_bits, 0);
+        fprintf(txt, "  output                          WLAST,                               \n");
+        fprintf(txt, "  output                          WVALID,                              \n");
+        fprintf(txt, "  input                           WREADY,                              \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  input  [ID_BITS-1:0]            BID,                                 \n");
+        fprintf(txt, "  input  [1:0]                    BRESP,                               \n");
+        print_user_signal(txt, "BUSER", "BUSER_BITS", options.buser_bits, 1);
+        fprintf(txt, "  input                           BVALID,                              \n");
+        fprintf(txt, "  output                          BREADY,                              \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  output [ID_BITS-1:0]            ARID,                                \n");
+        fprintf(txt, "  output [ADDR_BITS-1:0]          ARADDR,                              \n");
+        fprintf(txt, "  output [7:0]                    ARLEN,                               \n");
+        fprintf(txt, "  output [2:0]                    ARSIZE,                              \n");
+        fprintf(txt, "  output [1:0]                    ARBURST,                             \n");
+        fprintf(txt, "  output [0:0]                    ARLOCK,                              \n");
+        fprintf(txt, "  output [3:0]                    ARCACHE,                             \n");
+        fprintf(txt, "  output [2:0]                    ARPROT,                              \n");
+        fprintf(txt, "  output [3:0]                    ARREGION,                            \n");
+        fprintf(txt, "  output [3:0]                    ARQOS,                               \n");
+        print_user_signal(txt, "ARUSER", "ARUSER_BITS", options.aruser_bits, 0);
+        fprintf(txt, "  output                          ARVALID,                             \n");
+        fprintf(txt, "  input                           ARREADY,                             \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  input  [ID_BITS-1:0]            RID,                                 \n");
+        fprintf(txt, "  input  [DATA_BITS-1:0]          RDATA,                               \n");
+        fprintf(txt, "  input  [1:0]                    RRESP,                               \n");
+        print_user_signal(txt, "RUSER", "RUSER_BITS", options.ruser_bits, 1);
+        fprintf(txt, "  input                           RLAST,                               \n");
+        fprintf(txt, "  input                           RVALID,                              \n");
+        fprintf(txt, "  output                          RREADY                               \n");
+        fprintf(txt, "                                                                       \n");
+    }
+    if (has_dma()) {
+        fprintf(txt, "  ,                                                                    \n");
+        fprintf(txt, "  output [ID_BITS-1:0]            DMA_AWID,                            \n");
+        fprintf(txt, "  output [ADDR_BITS-1:0]          DMA_AWADDR,                          \n");
+        fprintf(txt, "  output [7:0]                    DMA_AWLEN,                           \n");
+        fprintf(txt, "  output [2:0]                    DMA_AWSIZE,                          \n");
+        fprintf(txt, "  output [1:0]                    DMA_AWBURST,                         \n");
+        fprintf(txt, "  output                          DMA_AWVALID,                         \n");
+        fprintf(txt, "  input                           DMA_AWREADY,                         \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  output [DATA_BITS-1:0]          DMA_WDATA,                           \n");
+        fprintf(txt, "  output [STRB_BITS-1:0]          DMA_WSTRB,                           \n");
+        fprintf(txt, "  output                          DMA_WLAST,                           \n");
+        fprintf(txt, "  output                          DMA_WVALID,                          \n");
+        fprintf(txt, "  input                           DMA_WREADY,                          \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  input  [ID_BITS-1:0]            DMA_BID,                             \n");
+        fprintf(txt, "  input  [1:0]                    DMA_BRESP,                           \n");
+        fprintf(txt, "  input                           DMA_BVALID,                          \n");
+        fprintf(txt, "  output                          DMA_BREADY,                          \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  output [ID_BITS-1:0]            DMA_ARID,                            \n");
+        fprintf(txt, "  output [ADDR_BITS-1:0]          DMA_ARADDR,                          \n");
+        fprintf(txt, "  output [7:0]                    DMA_ARLEN,                           \n");
+        fprintf(txt, "  output [2:0]                    DMA_ARSIZE,                          \n");
+        fprintf(txt, "  output [1:0]                    DMA_ARBURST,                         \n");
+        fprintf(txt, "  output                          DMA_ARVALID,                         \n");
+        fprintf(txt, "  input                           DMA_ARREADY,                         \n");
+        fprintf(txt, "                                                                       \n");
+        fprintf(txt, "  input  [ID_BITS-1:0]            DMA_RID,                             \n");
+        fprintf(txt, "  input  [DATA_BITS-1:0]          DMA_RDATA,                           \n");
+        fprintf(txt, "  input  [1:0]                    DMA_RRESP,                           \n");
+        fprintf(txt, "  input                           DMA_RLAST,                           \n");
+        fprintf(txt, "  input                           DMA_RVALID,                          \n");
+        fprintf(txt, "  output                          DMA_RREADY                           \n");
+        fprintf(txt, "                                                                       \n");
+    }
+}
+
+
+static void print_intro(FILE *txt, signal_struct *signals, char *instance_name)
+{
+    int master = has_master(signals);
+
+    fprintf(txt, "module cat_accel_%s                                                    \n", instance_name);
+    print_defines(txt, signals);
+    fprintf(txt, " (                                                                     \n");
+    fprintf(txt, "  input          clock,                                                \n");
+    fprintf(txt, "  input          resetn,                                               \n");
+    if (options.core_clock)
+    fprintf(txt, "  input          core_clock,                                           \n");
+    fprintf(txt, "  input  [SLAVE_BITS-BW_BITS-1:0] read_addr,                           \n");
+    fprintf(txt, "  output [DATA_BITS-1:0]  read_data,                                   \n");
+    fprintf(txt, "  input          oe,                                                   \n");
+    fprintf(txt, "  input  [SLAVE_BITS-BW_BITS-1:0] write_addr,                          \n");
+    fprintf(txt, "  input  [DATA_BITS-1:0]  write_data,                                  \n");
+    fprintf(txt, "  input  [STRB_BITS-1:0]  be,                                          \n");
+    fprintf(txt, "  input          we                                                    \n");
+    print_module_ports(txt, signals);
+    fprintf(txt, ");                                                                     \n");
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, " reg     [DATA_BITS-1:0]  register_bank[%d:0];                         \n", register_count(signals)-1);
+    fprintf(txt, " reg     [DATA_BITS-1:0]  rd_reg;                                      \n");
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, " reg             ready_out = 1'b1;                                     \n");
+    fprintf(txt, " reg             resp_out = 2'b00;                                     \n");
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, " wire    [SLAVE_BITS-BW_BITS-1:0] read_address;                        \n");
+    fprintf(txt, " wire    [SLAVE_BITS-BW_BITS-1:0] write_address;                       \n");
     fprintf(txt, " wire            read_enable = oe;                                     \n");
     fprintf(txt, " wire            write_enable = we;                                    \n");
     fprintf(txt, "                                                                       \n");
+    if (!memory_count(signals))
     fprintf(txt, " assign read_data = rd_reg;                                            \n");
     fprintf(txt, "                                                                       \n");
-    fprintf(txt, " assign read_address = read_addr[15:0];                                \n");
-    fprintf(txt, " assign write_address = write_addr[15:0];                              \n");
+    fprintf(txt, " assign read_address = read_addr;                                      \n");
+    fprintf(txt, " assign write_address = write_addr;                                    \n");
     fprintf(txt, "                                                                       \n");
+    if (master) print_user_wires(txt);
 }
 
 static void print_signals(FILE *txt, signal_struct *signals)
@@ -447,7 +1327,7 @@ static void print_signals(FILE *txt, signal_struct *signals)
         fprintf(txt, " \n");
     }
     while (sp) {
-        if (!sp->is_master) { 
+        if (in_register_bank(sp)) { 
            if (sp->width > 1) {
               fprintf(txt, " wire [%3d:0] %s; \n", sp->width-1, sp->signal_name);
            } else {
@@ -457,53 +1337,208 @@ static void print_signals(FILE *txt, signal_struct *signals)
               fprintf(txt, " wire         %s_tz; \n", sp->signal_name);
            } 
            if (sp->is_channel) {
-              fprintf(txt, " %4s         %s_ready; \n", sp->is_input?"wire":"reg ", sp->signal_name);
+              fprintf(txt, " %4s         %s_ready; \n", (sp->is_input || (0 == strcmp(sp->signal_name, options.dma_out)))?"wire":"reg ", sp->signal_name);
+              if (0 == strcmp(sp->signal_name, options.dma_out))
+              fprintf(txt, " reg          %s_host_ready; \n", sp->signal_name);
               fprintf(txt, " %4s         %s_valid; \n", sp->is_input?"reg ":"wire", sp->signal_name);
            }
         } 
         sp = sp->next;
     }
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory) {
+           if (sp->is_input) {
+              fprintf(txt, " wire [%3d:0] %s_radr; \n", log2_ceil(sp->depth)-1, sp->signal_name);
+              fprintf(txt, " wire         %s_re; \n", sp->signal_name);
+              fprintf(txt, " reg  [%3d:0] %s_q; \n", sp->width-1, sp->signal_name);
+           } else {
+              fprintf(txt, " wire [%3d:0] %s_wadr; \n", log2_ceil(sp->depth)-1, sp->signal_name);
+              fprintf(txt, " wire         %s_we; \n", sp->signal_name);
+              fprintf(txt, " wire [%3d:0] %s_d; \n", sp->width-1, sp->signal_name);
+           }
+        }
+        sp = sp->next;
+    }
     if (master) {
         fprintf(txt, "                                     \n");
-        fprintf(txt, " wire [ `addr_bits-1:0] addr_offset; \n");
+        fprintf(txt, " wire [ADDR_BITS-1:0]   addr_offset; \n");
         fprintf(txt, " wire [ 31:0]           burst_size;  \n");
         fprintf(txt, " wire [  2:0]           m_wstate;    \n");
         fprintf(txt, "                                     \n");
     }
+    if (options.core_clock) {
+        char buf[STRLEN];
+        axi_field *f;
+        int ch;
+
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " // catapult side of the clock crossing \n");
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " reg  [  1:0]           core_reset_sync; \n");
+        fprintf(txt, " wire                   core_resetn; \n");
+        sp = signals;
+        while (sp) {
+            if (in_register_bank(sp)) {
+                if (sp->width > 1) fprintf(txt, " wire [%3d:0] c_%s; \n", sp->width-1, sp->signal_name);
+                else               fprintf(txt, " wire         c_%s; \n", sp->signal_name);
+                if (sp->is_channel) {
+                    fprintf(txt, " wire         c_%s_ready; \n", sp->signal_name);
+                    fprintf(txt, " wire         c_%s_valid; \n", sp->signal_name);
+                }
+            }
+            sp = sp->next;
+        }
+        if (master) {
+            fprintf(txt, " wire [ADDR_BITS-1:0]   c_addr_offset; \n");
+            fprintf(txt, " wire [ 31:0]           c_burst_size; \n");
+            for (ch=0; ch<5; ch++) {
+                for (f=axi_fields[ch]; f->name; f++) {
+                    fprintf(txt, " wire [%s-1:0] c_%s%s; \n", axi_field_width(ch, f, buf), axi_channels[ch], f->name);
+                }
+                fprintf(txt, " wire         c_%sVALID; \n", axi_channels[ch]);
+                fprintf(txt, " wire         c_%sREADY; \n", axi_channels[ch]);
+            }
+        }
+    }
+    if (options.scatter_gather) {
+        char buf[STRLEN];
+        axi_field *f;
+        int ch;
+
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " // master side of the scatter-gather unit \n");
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " wire                   sg_error; \n");
+        for (ch=0; ch<5; ch++) {
+            for (f=axi_fields[ch]; f->name; f++) {
+                fprintf(txt, " wire [%s-1:0] s_%s%s; \n", axi_field_width(ch, f, buf), axi_channels[ch], f->name);
+            }
+            fprintf(txt, " wire         s_%sVALID; \n", axi_channels[ch]);
+            fprintf(txt, " wire         s_%sREADY; \n", axi_channels[ch]);
+        }
+    }
+    if (options.dma_in[0]) {
+        sp = find_signal(signals, options.dma_in);
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " wire                   dma_rd_active; \n");
+        fprintf(txt, " wire                   dma_rd_queued; \n");
+        fprintf(txt, " wire                   dma_rd_error; \n");
+        fprintf(txt, " wire [ 15:0]           dma_rd_done; \n");
+        fprintf(txt, " wire [%3d:0]           dma_rd_data; \n", dma_elem_bits(sp)-1);
+        fprintf(txt, " wire                   dma_rd_valid; \n");
+        fprintf(txt, " wire                   dma_rd_dispatch; \n");
+    }
+    if (options.dma_out[0]) {
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " wire                   dma_wr_active; \n");
+        fprintf(txt, " wire                   dma_wr_queued; \n");
+        fprintf(txt, " wire                   dma_wr_error; \n");
+        fprintf(txt, " wire [ 15:0]           dma_wr_done; \n");
+        fprintf(txt, " wire                   dma_wr_iready; \n");
+    }
+    if (options.cores) {
+        fprintf(txt, "                                     \n");
+        fprintf(txt, " reg  [%2d:0]           slot_pending;\n", options.cores-1);
+        fprintf(txt, " reg  [  4:0]           slot_last;   \n");
+        fprintf(txt, " reg  [  4:0]           slot_sel;    \n");
+        fprintf(txt, " reg                    slot_found;  \n");
+        fprintf(txt, " wire                   slot_dispatch;\n");
+        fprintf(txt, " integer                slot_i;      \n");
+        fprintf(txt, "                                     \n");
+    }
 }
 
 
-static void print_register_map(FILE *txt, signal_struct *signals)
+static int register_name(signal_struct *signals, int index, char *buf)
 {
+    // name of register index in the register map, 0 past the last register
+
     signal_struct *sp;
-    char buf[STRLEN];
+    static const char *dma_regs[] = { "ADDR_LOW", "ADDR_HIGH", "COUNT", "STATUS" };
+    static const char *sg_regs[]  = { "LIST_LOW", "LIST_HIGH", "COUNT", "STATUS" };
     int offset = 0;
+    int i;
 
-    sp = signals;
+    for (sp=signals; sp; sp=sp->next) {
+        if (in_register_bank(sp)) {
+            if (offset++ == index) {
+                uppercase(sp->signal_name, buf);
+                return 1;
+            }
+            if (sp->is_channel && (offset++ == index)) {
+                strcat(uppercase(sp->signal_name, buf), (sp->is_input) ? "_READY" : "_VALID");
+                return 1;
+            }
+        }
+    }
+    if (has_master(signals)) {
+        if (index - offset < 3) {
+            strcpy(buf, (index == offset) ? "ADDR_OFFSET_LOW" : (index == offset + 1) ? "ADDR_OFFSET_HIGH" : "BURST_SIZE");
+            return 1;
+        }
+        offset += 3;
+    }
+    if (options.cores) {
+        if (index - offset < 3 + options.cores) {
+            if (index - offset < 3) strcpy(buf, (index == offset) ? "TICKET" : (index == offset + 1) ? "SERVING" : "SLOT_PENDING");
+            else sprintf(buf, "SLOT_%d", index - offset - 3);
+            return 1;
+        }
+        offset += 3 + options.cores;
+    }
+    if (index - offset < (channel_count(signals) + 31) / 32) {
+        sprintf(buf, "CHANNEL_STATUS_%d", index - offset);
+        return 1;
+    }
+    offset += (channel_count(signals) + 31) / 32;
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream && !sp->is_input && (offset++ == index)) {
+            strcat(uppercase(sp->signal_name, buf), "_PACKET");
+            return 1;
+        }
+    }
+    for (i=0; i<2; i++) {
+        if (!((i == 0) ? options.dma_in : options.dma_out)[0]) continue;
+        if (index - offset < 4) {
+            sprintf(buf, "DMA_%s_%s", (i == 0) ? "RD" : "WR", dma_regs[index - offset]);
+            return 1;
+        }
+        offset += 4;
+    }
+    if (options.scatter_gather && (index - offset < 4)) {
+        sprintf(buf, "SG_%s", sg_regs[index - offset]);
+        return 1;
+    }
+    return 0;
+}
 
-    if (sp) {
+
+static int register_index(signal_struct *signals, char *name)
+{
+    char buf[STRLEN];
+    int index;
+
+    for (index=0; register_name(signals, index, buf); index++) {
+        if (0 == strcmp(buf, name)) return index;
+    }
+    return -1;
+}
+
+
+static void print_register_map(FILE *txt, signal_struct *signals)
+{
+    char buf[STRLEN];
+    int i;
+
+    if (signals) {
         fprintf(txt, " \n");
         fprintf(txt, " // register map \n");
         fprintf(txt, " \n");
     }
 
-    while (sp) {
-        if (!sp->is_master) {
-            fprintf(txt, " `define %-20s %3d \n", uppercase(sp->signal_name, buf), offset++);
-            if (sp->is_channel) {
-                if (sp->is_input) {
-                   fprintf(txt, " `define %-20s %3d \n", strcat(uppercase(sp->signal_name, buf), "_READY"), offset++);
-                } else {
-                   fprintf(txt, " `define %-20s %3d \n", strcat(uppercase(sp->signal_name, buf), "_VALID"), offset++);
-                }
-            }
-        }
-        sp = sp->next;
-    }
-    if (has_master(signals)) {
-       fprintf(txt, " `define ADDR_OFFSET_LOW      %3d \n", offset++);
-       fprintf(txt, " `define ADDR_OFFSET_HIGH     %3d \n", offset++);
-       fprintf(txt, " `define BURST_SIZE           %3d \n", offset++);
+    for (i=0; register_name(signals, i, buf); i++) {
+        fprintf(txt, " `define %-20s %3d \n", buf, i);
     }
     fprintf(txt, " \n");
 
@@ -525,7 +1560,7 @@ static void print_assignments(FILE *txt, signal_struct *signals)
     }
 
     while (sp) {
-        if (!sp->is_master) {
+        if (in_register_bank(sp)) {
             if (sp->is_input) {
                 if (sp->width == 1) {
                     fprintf(txt, " assign %-20s = register_bank[`%s][0]; \n", 
@@ -548,36 +1583,187 @@ static void print_assignments(FILE *txt, signal_struct *signals)
     if (has_master(signals)) {
         fprintf(txt, "                                                                                              \n");
         fprintf(txt, " assign addr_offset[31:0]               = register_bank[`ADDR_OFFSET_LOW];                    \n");
-        //fprintf(txt, " assign addr_offset[`addr_bits-1:32]    = register_bank[`ADDR_OFFSET_HIGH][`addr_bits-33:0];  \n");
+        if (options.addr_bits > 32)
+        fprintf(txt, " assign addr_offset[ADDR_BITS-1:32]     = register_bank[`ADDR_OFFSET_HIGH][ADDR_BITS-33:0];   \n");
         fprintf(txt, " assign burst_size                      = register_bank[`BURST_SIZE];                         \n");
         fprintf(txt, "                                                                                              \n");
     }
+    if (options.dma_in[0]) {
+        fprintf(txt, " wire [ 63:0]           dma_rd_addr = {register_bank[`DMA_RD_ADDR_HIGH][31:0], register_bank[`DMA_RD_ADDR_LOW][31:0]}; \n");
+        fprintf(txt, " wire                   dma_rd_start = write_enable && (write_address == `DMA_RD_COUNT) && (write_data[31:0] != 0); \n");
+    }
+    if (options.dma_out[0]) {
+        fprintf(txt, " wire [ 63:0]           dma_wr_addr = {register_bank[`DMA_WR_ADDR_HIGH][31:0], register_bank[`DMA_WR_ADDR_LOW][31:0]}; \n");
+        fprintf(txt, " wire                   dma_wr_start = write_enable && (write_address == `DMA_WR_COUNT) && (write_data[31:0] != 0); \n");
+    }
+    if (options.scatter_gather) {
+        fprintf(txt, " wire [ 63:0]           sg_list = {register_bank[`SG_LIST_HIGH][31:0], register_bank[`SG_LIST_LOW][31:0]}; \n");
+    }
     fprintf(txt, " \n");
 }
 
 
-static void print_register_accesses(FILE *txt, signal_struct *signals)
+static void print_read_case(FILE *txt, char *target, char *source, char *sel, int bits, int base, int count, int limit)
 {
-    signal_struct *sp;
-    char buf[STRLEN];
+    // one mux of the read tree: target takes source[base+m] for the
+    // implemented entries m selected by sel, anything else reads as 0
 
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, " always @(posedge clock or negedge resetn) begin                       \n");
-    fprintf(txt, "   if (resetn == 1'b0) begin                                           \n");
-    fprintf(txt, "     rd_reg <= 32'h00000000;                                           \n");
-    fprintf(txt, "   end else begin                                                      \n");
-    fprintf(txt, "     if (read_enable) begin                                            \n");
-    fprintf(txt, "       rd_reg <= register_bank[read_address];                          \n");
-    fprintf(txt, "     end                                                               \n");
-    fprintf(txt, "   end                                                                 \n");
-    fprintf(txt, " end                                                                   \n");
-    fprintf(txt, "                                                                       \n");
-    fprintf(txt, " always @(posedge clock or negedge resetn) begin                       \n");
-    fprintf(txt, "   if (resetn == 1'b0) begin                                           \n");
+    int m;
 
-    sp = signals;
-    while (sp) {
-        if (!sp->is_master) {
+    fprintf(txt, "     case (%s) \n", sel);
+    for (m=0; (m < (1 << bits)) && (base + m < limit) && (m < count); m++) {
+        fprintf(txt, "       %d'd%d: %s <= %s[%d]; \n", bits, m, target, source, base + m);
+    }
+    fprintf(txt, "       default: %s <= {DATA_BITS {1'b0}}; \n", target);
+    fprintf(txt, "     endcase \n");
+}
+
+
+static void print_read_mux(FILE *txt, signal_struct *signals)
+{
+    int count = register_count(signals);
+    int stages = read_stages(signals);
+    int bits = 1;
+    int k;
+    int groups;
+    int prev;
+    int i, j, g;
+    char target[STRLEN];
+    char source[STRLEN];
+    char sel[STRLEN];
+
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, " // read_data follows oe by %d cycle%s, the rd_latency of axi_slave_interface \n",
+                 read_latency(signals), (read_latency(signals) == 1) ? "" : "s");
+
+    if (options.read_ram) {
+
+        // host written registers read back from a block RAM copy, valid once
+        // written since reset, the rest through a mux over their addresses only
+
+        fprintf(txt, " \n");
+        fprintf(txt, " (* ram_style = \"block\" *) reg [DATA_BITS-1:0] rd_ram[%d:0]; \n", count-1);
+        fprintf(txt, " reg     [%d:0]            rd_ram_valid; \n", count-1);
+        fprintf(txt, " reg     [DATA_BITS-1:0]  rd_ram_q; \n");
+        fprintf(txt, " reg     [DATA_BITS-1:0]  rd_hw_q; \n");
+        fprintf(txt, " reg                      rd_ram_ok; \n");
+        fprintf(txt, " reg                      rd_use_ram; \n");
+        fprintf(txt, " \n");
+        fprintf(txt, " always @(posedge clock) begin \n");
+        fprintf(txt, "   if (write_enable && (write_address < %d)) rd_ram[write_address] <= write_data; \n", count);
+        fprintf(txt, "   rd_ram_q <= rd_ram[read_address]; \n");
+        fprintf(txt, " end \n");
+        fprintf(txt, " \n");
+        fprintf(txt, " always @(posedge clock or negedge resetn) begin \n");
+        fprintf(txt, "   if (resetn == 1'b0) begin \n");
+        fprintf(txt, "     rd_ram_valid <= %d'd0; \n", count);
+        fprintf(txt, "     rd_ram_ok    <= 1'b0; \n");
+        fprintf(txt, "     rd_use_ram   <= 1'b0; \n");
+        fprintf(txt, "     rd_hw_q      <= {DATA_BITS {1'b0}}; \n");
+        fprintf(txt, "     rd_reg       <= {DATA_BITS {1'b0}}; \n");
+        fprintf(txt, "   end else begin \n");
+        fprintf(txt, "     if (write_enable && (write_address < %d)) rd_ram_valid[write_address] <= 1'b1; \n", count);
+        fprintf(txt, "     rd_ram_ok <= (read_address < %d) ? rd_ram_valid[read_address] : 1'b0; \n", count);
+        fprintf(txt, "     case (read_address) \n");
+        for (i=0; i<count; i++) {
+            if (host_written(signals, i)) fprintf(txt, "       %d: rd_use_ram <= 1'b1; \n", i);
+        }
+        fprintf(txt, "       default: rd_use_ram <= 1'b0; \n");
+        fprintf(txt, "     endcase \n");
+        fprintf(txt, "     case (read_address) \n");
+        for (i=0; i<count; i++) {
+            if (!host_written(signals, i)) fprintf(txt, "       %d: rd_hw_q <= register_bank[%d]; \n", i, i);
+        }
+        fprintf(txt, "       default: rd_hw_q <= {DATA_BITS {1'b0}}; \n");
+        fprintf(txt, "     endcase \n");
+        fprintf(txt, "     rd_reg <= (rd_use_ram) ? ((rd_ram_ok) ? rd_ram_q : {DATA_BITS {1'b0}}) : rd_hw_q; \n");
+        fprintf(txt, "   end \n");
+        fprintf(txt, " end \n");
+        return;
+    }
+
+    if (stages == 1) {
+        fprintf(txt, " always @(posedge clock or negedge resetn) begin                       \n");
+        fprintf(txt, "   if (resetn == 1'b0) begin                                           \n");
+        fprintf(txt, "     rd_reg <= 32'h00000000;                                           \n");
+        fprintf(txt, "   end else begin                                                      \n");
+        fprintf(txt, "     if (read_enable) begin                                            \n");
+        fprintf(txt, "       rd_reg <= register_bank[read_address];                          \n");
+        fprintf(txt, "     end                                                               \n");
+        fprintf(txt, "   end                                                                 \n");
+        fprintf(txt, " end                                                                   \n");
+        return;
+    }
+
+    // a tree of 2^k:1 muxes, one register stage per level, decoding only
+    // the implemented registers.  Address bits and the range check travel
+    // down the tree with the data.
+
+    while ((1 << bits) < count) bits++;
+    k = (bits + stages - 1) / stages;
+
+    fprintf(txt, " // read mux, %d stages of %d:1 over %d registers \n", stages, 1 << k, count);
+    fprintf(txt, " \n");
+    groups = count;
+    for (j=1; j<stages; j++) {
+        groups = (groups + (1 << k) - 1) >> k;
+        fprintf(txt, " reg     [DATA_BITS-1:0]  rd_s%d[%d:0]; \n", j, groups-1);
+        fprintf(txt, " reg     [SLAVE_BITS-BW_BITS-1:0] rd_a%d; \n", j);
+        fprintf(txt, " reg                      rd_ok%d; \n", j);
+    }
+    fprintf(txt, " \n");
+
+    fprintf(txt, " always @(posedge clock) begin \n");
+    fprintf(txt, "     rd_a1  <= read_address; \n");
+    fprintf(txt, "     rd_ok1 <= (read_address < %d) ? 1'b1 : 1'b0; \n", count);
+    for (j=2; j<stages; j++) {
+        fprintf(txt, "     rd_a%d  <= rd_a%d; \n", j, j-1);
+        fprintf(txt, "     rd_ok%d <= rd_ok%d; \n", j, j-1);
+    }
+    prev = count;
+    for (j=1; j<stages; j++) {
+        groups = (prev + (1 << k) - 1) >> k;
+        if (j == 1) sprintf(source, "register_bank");
+        else        sprintf(source, "rd_s%d", j-1);
+        if (j == 1) sprintf(sel, "read_address[%d:0]", k-1);
+        else        sprintf(sel, "rd_a%d[%d:%d]", j-1, j*k-1, (j-1)*k);
+        for (g=0; g<groups; g++) {
+            sprintf(target, "rd_s%d[%d]", j, g);
+            print_read_case(txt, target, source, sel, k, g << k, 1 << k, prev);
+        }
+        prev = groups;
+    }
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+
+    fprintf(txt, " always @(posedge clock or negedge resetn) begin \n");
+    fprintf(txt, "   if (resetn == 1'b0) begin \n");
+    fprintf(txt, "     rd_reg <= {DATA_BITS {1'b0}}; \n");
+    fprintf(txt, "   end else if (!rd_ok%d) begin \n", stages-1);
+    fprintf(txt, "     rd_reg <= {DATA_BITS {1'b0}}; \n");
+    fprintf(txt, "   end else begin \n");
+    sprintf(source, "rd_s%d", stages-1);
+    sprintf(sel, "rd_a%d[%d:%d]", stages-1, bits-1, (stages-1)*k);
+    print_read_case(txt, "rd_reg", source, sel, bits - (stages-1)*k, 0, prev, prev);
+    fprintf(txt, "   end \n");
+    fprintf(txt, " end \n");
+}
+
+
+static void print_register_accesses(FILE *txt, signal_struct *signals)
+{
+    signal_struct *sp;
+    char buf[STRLEN];
+    int i;
+
+    print_read_mux(txt, signals);
+    fprintf(txt, "                                                                       \n");
+    fprintf(txt, " always @(posedge clock or negedge resetn) begin                       \n");
+    fprintf(txt, "   if (resetn == 1'b0) begin                                           \n");
+
+    sp = signals;
+    while (sp) {
+        if (in_register_bank(sp)) {
             fprintf(txt, "       register_bank[`%s] <= 32'h00000000; \n", uppercase(sp->signal_name, buf));
             if (sp->is_channel) {
                 if (sp->is_input) {
@@ -597,6 +1783,37 @@ static void print_register_accesses(FILE *txt, signal_struct *signals)
         fprintf(txt, "       register_bank[`BURST_SIZE] <= 32'h0000000F;                     \n");
         fprintf(txt, "                                                                       \n");
     }
+    if (options.cores) {
+        fprintf(txt, "       register_bank[`TICKET] <= 32'h00000000;                         \n");
+        fprintf(txt, "       register_bank[`SERVING] <= 32'h00000000;                        \n");
+        fprintf(txt, "       register_bank[`SLOT_PENDING] <= 32'h00000000;                   \n");
+        for (i=0; i<options.cores; i++) {
+            fprintf(txt, "       register_bank[`SLOT_%d] <= 32'h00000000; \n", i);
+        }
+    }
+    for (i=0; i<(channel_count(signals) + 31) / 32; i++) {
+        fprintf(txt, "       register_bank[`CHANNEL_STATUS_%d] <= 32'h00000000; \n", i);
+    }
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream && !sp->is_input) {
+            fprintf(txt, "       register_bank[`%s] <= 32'h00000000; \n", strcat(uppercase(sp->signal_name, buf), "_PACKET"));
+        }
+    }
+    for (i=0; i<2; i++) {
+        char *e = (i == 0) ? "RD" : "WR";
+
+        if (!((i == 0) ? options.dma_in : options.dma_out)[0]) continue;
+        fprintf(txt, "       register_bank[`DMA_%s_ADDR_LOW] <= 32'h00000000; \n", e);
+        fprintf(txt, "       register_bank[`DMA_%s_ADDR_HIGH] <= 32'h00000000; \n", e);
+        fprintf(txt, "       register_bank[`DMA_%s_COUNT] <= 32'h00000000; \n", e);
+        fprintf(txt, "       register_bank[`DMA_%s_STATUS] <= 32'h00000000; \n", e);
+    }
+    if (options.scatter_gather) {
+        fprintf(txt, "       register_bank[`SG_LIST_LOW] <= 32'h00000000; \n");
+        fprintf(txt, "       register_bank[`SG_LIST_HIGH] <= 32'h00000000; \n");
+        fprintf(txt, "       register_bank[`SG_COUNT] <= 32'h00000000; \n");
+        fprintf(txt, "       register_bank[`SG_STATUS] <= 32'h00000000; \n");
+    }
     fprintf(txt, "   end else begin                                                      \n");
     fprintf(txt, "     if (write_enable) begin                                           \n");
     fprintf(txt, "       if (write_address < %d) begin                                   \n", register_count(signals));
@@ -606,7 +1823,7 @@ static void print_register_accesses(FILE *txt, signal_struct *signals)
 
     sp = signals;
     while (sp) {
-        if (!sp->is_master) {
+        if (in_register_bank(sp)) {
             if (!sp->is_input) {
                 fprintf(txt, "       register_bank[`%s] <= %s; \n", uppercase(sp->signal_name, buf), sp->signal_name);
             }
@@ -621,15 +1838,391 @@ static void print_register_accesses(FILE *txt, signal_struct *signals)
         sp = sp->next;
     }
 
+    // every channel flag packed into CHANNEL_STATUS words, input channels
+    // give their ready and output channels their valid, bit 0 first in spec order
+    for (i=0; i<channel_count(signals); i+=32) {
+        int bits = channel_count(signals) - i;
+        int n = 0;
+
+        if (bits > 32) bits = 32;
+        fprintf(txt, "       register_bank[`CHANNEL_STATUS_%d] <= {", i / 32);
+        if (bits < 32) fprintf(txt, "%d'd0", 32 - bits);
+        for (n=bits-1; n>=0; n--) {
+            int k = 0;
+            sp = signals;
+            while (sp) {
+                if (sp->is_channel && (k++ == i + n)) {
+                    fprintf(txt, "%s%s_%s", ((n == bits-1) && (bits == 32)) ? "" : ", ",
+                                 sp->signal_name, (sp->is_input) ? "ready" : "valid");
+                }
+                sp = sp->next;
+            }
+        }
+        fprintf(txt, "}; \n");
+    }
+
+    if (options.cores) {
+        // a read of TICKET hands out the value and moves it on, a write of
+        // SERVING moves the ticket being served on, whatever is written
+        fprintf(txt, "       if (read_enable && (read_address == `TICKET)) begin             \n");
+        fprintf(txt, "         register_bank[`TICKET] <= register_bank[`TICKET] + 1;         \n");
+        fprintf(txt, "       end                                                             \n");
+        fprintf(txt, "       if (write_enable && (write_address == `SERVING)) begin          \n");
+        fprintf(txt, "         register_bank[`SERVING] <= register_bank[`SERVING] + 1;       \n");
+        fprintf(txt, "       end                                                             \n");
+        fprintf(txt, "       register_bank[`SLOT_PENDING] <= slot_pending;                   \n");
+        fprintf(txt, "       if (slot_dispatch) begin                                        \n");
+        fprintf(txt, "         register_bank[`%s] <= register_bank[`SLOT_0 + slot_sel]; \n", uppercase(options.job_channel, buf));
+        fprintf(txt, "       end                                                             \n");
+    }
+
+    if (options.dma_in[0]) {
+        fprintf(txt, "       register_bank[`DMA_RD_STATUS] <= {dma_rd_done, 13'd0, dma_rd_error, \n");
+        fprintf(txt, "                                        dma_rd_queued || (dma_rd_start && dma_rd_active), dma_rd_active || dma_rd_start}; \n");
+        fprintf(txt, "       if (dma_rd_dispatch) begin                                      \n");
+        fprintf(txt, "         register_bank[`%s] <= dma_rd_data; \n", uppercase(options.dma_in, buf));
+        fprintf(txt, "       end                                                             \n");
+    }
+    if (options.dma_out[0]) {
+        fprintf(txt, "       register_bank[`DMA_WR_STATUS] <= {dma_wr_done, 13'd0, dma_wr_error, \n");
+        fprintf(txt, "                                        dma_wr_queued || (dma_wr_start && dma_wr_active), dma_wr_active || dma_wr_start}; \n");
+    }
+    if (options.scatter_gather) {
+        fprintf(txt, "       register_bank[`SG_STATUS] <= {31'd0, sg_error};                 \n");
+    }
+
     fprintf(txt, "   end                                                                 \n");
     fprintf(txt, " end                                                                   \n");
     fprintf(txt, "                                                                       \n");
 }
 
+static void print_memories(FILE *txt, signal_struct *signals)
+{
+    // each memory is a dual port RAM, one port on the slave for the host and
+    // one for the catapult instance.  Host reads come back through the same
+    // number of stages as register reads so read_data keeps one latency.
+
+    signal_struct *sp;
+    int window = memory_window_bits(signals);
+    int region_bits = log2_ceil(memory_count(signals) + 1);
+    int latency = read_latency(signals);
+    int region = 0;
+    int abits;
+    int i;
+
+    if (!memory_count(signals)) return;
+
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory) {
+            region++;
+            abits = log2_ceil(sp->depth);
+            fprintf(txt, " \n");
+            fprintf(txt, " // memory %s, %d words at word address 0x%x \n", sp->signal_name, sp->depth, region << window);
+            fprintf(txt, " \n");
+            fprintf(txt, " (* ram_style = \"block\" *) reg [%d:0] %s_mem[%d:0]; \n", sp->width-1, sp->signal_name, sp->depth-1);
+            fprintf(txt, " reg     [DATA_BITS-1:0]  %s_host_q; \n", sp->signal_name);
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge clock) begin \n");
+            fprintf(txt, "   if (write_enable && (write_address[SLAVE_BITS-BW_BITS-1:%d] == %d) && (write_address[%d:0] < %d)) begin \n",
+                         window, region, abits-1, sp->depth);
+            fprintf(txt, "     %s_mem[write_address[%d:0]] <= write_data[%d:0]; \n", sp->signal_name, abits-1, sp->width-1);
+            fprintf(txt, "   end \n");
+            fprintf(txt, "   %s_host_q <= %s_mem[read_address[%d:0]]; \n", sp->signal_name, sp->signal_name, abits-1);
+            fprintf(txt, " end \n");
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge %s) begin \n", (options.core_clock) ? "core_clock" : "clock");
+            if (sp->is_input) {
+                fprintf(txt, "   if (%s_re) %s_q <= %s_mem[%s_radr]; \n", sp->signal_name, sp->signal_name, sp->signal_name, sp->signal_name);
+            } else {
+                fprintf(txt, "   if (%s_we) %s_mem[%s_wadr] <= %s_d; \n", sp->signal_name, sp->signal_name, sp->signal_name, sp->signal_name);
+            }
+            fprintf(txt, " end \n");
+        }
+        sp = sp->next;
+    }
+
+    fprintf(txt, " \n");
+    fprintf(txt, " // host read data, window 0 is the register bank \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " reg     [%d:0]            mem_rd_region[%d:0]; \n", region_bits-1, latency-1);
+    if (latency > 1)
+    fprintf(txt, " reg     [DATA_BITS-1:0]  mem_rd_data[%d:1]; \n", latency-1);
+    fprintf(txt, " reg     [DATA_BITS-1:0]  mem_rd_q; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(*) begin \n");
+    fprintf(txt, "   case (mem_rd_region[0]) \n");
+    region = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory) {
+            fprintf(txt, "     %d: mem_rd_q = %s_host_q; \n", ++region, sp->signal_name);
+        }
+        sp = sp->next;
+    }
+    fprintf(txt, "     default: mem_rd_q = {DATA_BITS {1'b0}}; \n");
+    fprintf(txt, "   endcase \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(posedge clock) begin \n");
+    fprintf(txt, "   mem_rd_region[0] <= read_address[SLAVE_BITS-BW_BITS-1:%d]; \n", window);
+    for (i=1; i<latency; i++) {
+        fprintf(txt, "   mem_rd_region[%d] <= mem_rd_region[%d]; \n", i, i-1);
+        if (i == 1) fprintf(txt, "   mem_rd_data[1] <= mem_rd_q; \n");
+        else        fprintf(txt, "   mem_rd_data[%d] <= mem_rd_data[%d]; \n", i, i-1);
+    }
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    if (latency == 1) {
+        fprintf(txt, " assign read_data = (mem_rd_region[0] != 0) ? mem_rd_q : rd_reg; \n");
+    } else {
+        fprintf(txt, " assign read_data = (mem_rd_region[%d] != 0) ? mem_rd_data[%d] : rd_reg; \n", latency-1, latency-1);
+    }
+    fprintf(txt, " \n");
+}
+
+
+static void print_streams(FILE *txt, signal_struct *signals)
+{
+    // each stream port is wired to the catapult channel through one beat
+    // register, which splits a TDATA beat into elements for an input stream
+    // and packs elements into a beat for an output stream, one element per
+    // cycle either way.  Elements without their first TKEEP byte are skipped
+    // and input TLAST is ignored.  An output beat is sent when full or at the
+    // end of a packet of <NAME>_PACKET elements, which also raises TLAST.
+
+    signal_struct *sp;
+    char buf[STRLEN];
+    char *clk = (options.core_clock) ? "core_clock"  : "clock";
+    char *rst = (options.core_clock) ? "core_resetn" : "resetn";
+    char *n;
+    int elem;       // element bits in TDATA, rounded up to whole bytes
+    int per_beat;
+    int idx_bits;
+
+    for (sp=signals; sp; sp=sp->next) {
+        if (!sp->is_stream) continue;
+
+        n = sp->signal_name;
+        elem = 8 * ((sp->width + 7) / 8);
+        per_beat = sp->stream_bits / elem;
+        idx_bits = (per_beat > 1) ? log2_ceil(per_beat) : 1;
+
+        fprintf(txt, " \n");
+        fprintf(txt, " // stream %s, %d element%s of %d bits per %d bit beat \n", n, per_beat, (per_beat == 1) ? "" : "s", sp->width, sp->stream_bits);
+        fprintf(txt, " \n");
+        fprintf(txt, " wire [%3d:0] %s; \n", sp->width-1, n);
+        fprintf(txt, " wire         %s_valid; \n", n);
+        fprintf(txt, " wire         %s_ready; \n", n);
+        fprintf(txt, " %s [%3d:0] %s_tdata; \n", (sp->is_input) ? "wire" : "reg ", sp->stream_bits-1, n);
+        fprintf(txt, " %s [%3d:0] %s_tkeep; \n", (sp->is_input) ? "wire" : "reg ", sp->stream_bits/8-1, n);
+        fprintf(txt, " %s         %s_tvalid; \n", (sp->is_input) ? "wire" : "reg ", n);
+        fprintf(txt, " wire         %s_tready; \n", n);
+        fprintf(txt, " reg  [%3d:0] %s_idx; \n", idx_bits-1, n);
+
+        if (sp->is_input) {
+            fprintf(txt, " reg  [%3d:0] %s_beat; \n", sp->stream_bits-1, n);
+            fprintf(txt, " reg  [%3d:0] %s_keep; \n", sp->stream_bits/8-1, n);
+            fprintf(txt, " reg          %s_held; \n", n);
+            fprintf(txt, " \n");
+            fprintf(txt, " wire         %s_kept    = %s_keep[%s_idx * %d]; \n", n, n, n, elem / 8);
+            fprintf(txt, " wire         %s_advance = %s_held && (!%s_kept || %s_ready); \n", n, n, n, n);
+            fprintf(txt, " wire         %s_last    = (%s_idx == %d) ? 1'b1 : 1'b0; \n", n, n, per_beat-1);
+            fprintf(txt, " \n");
+            fprintf(txt, " assign %s        = %s_beat[%s_idx * %d +: %d]; \n", n, n, n, elem, sp->width);
+            fprintf(txt, " assign %s_valid  = %s_held && %s_kept; \n", n, n, n);
+            fprintf(txt, " assign %s_tready = !%s_held || (%s_advance && %s_last); \n", n, n, n, n);
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge %s or negedge %s) begin \n", clk, rst);
+            fprintf(txt, "   if (%s == 1'b0) begin \n", rst);
+            fprintf(txt, "     %s_held <= 1'b0; \n", n);
+            fprintf(txt, "     %s_idx  <= 0; \n", n);
+            fprintf(txt, "   end else if (%s_tvalid && %s_tready) begin \n", n, n);
+            fprintf(txt, "     %s_beat <= %s_tdata; \n", n, n);
+            fprintf(txt, "     %s_keep <= %s_tkeep; \n", n, n);
+            fprintf(txt, "     %s_held <= 1'b1; \n", n);
+            fprintf(txt, "     %s_idx  <= 0; \n", n);
+            fprintf(txt, "   end else if (%s_advance) begin \n", n);
+            fprintf(txt, "     if (%s_last) %s_held <= 1'b0; \n", n, n);
+            fprintf(txt, "     else %s_idx <= %s_idx + 1; \n", n, n);
+            fprintf(txt, "   end \n");
+            fprintf(txt, " end \n");
+        } else {
+            fprintf(txt, " reg          %s_tlast; \n", n);
+            fprintf(txt, " reg  [ 31:0] %s_count; \n", n);
+            fprintf(txt, " wire [ 31:0] %s_packet; \n", n);
+            fprintf(txt, " wire [%3d:0] %s_elem    = %s; \n", elem-1, n, n);
+            fprintf(txt, " wire         %s_take    = %s_valid && %s_ready; \n", n, n, n);
+            fprintf(txt, " wire         %s_end     = (%s_packet != 0) && (%s_count == %s_packet - 1); \n", n, n, n, n);
+            fprintf(txt, " \n");
+            fprintf(txt, " assign %s_ready = !%s_tvalid || %s_tready; \n", n, n, n);
+            fprintf(txt, " \n");
+            if (options.core_clock) {
+                fprintf(txt, " cdc_bus_sync #(32) %s_packet_cdc ( \n", n);
+                fprintf(txt, "    .SCLK (clock), .SRESETn (resetn), .SDATA (register_bank[`%s_PACKET]), \n", uppercase(n, buf));
+                fprintf(txt, "    .DCLK (core_clock), .DRESETn (core_resetn), .DDATA (%s_packet) \n", n);
+                fprintf(txt, " ); \n");
+            } else {
+                fprintf(txt, " assign %s_packet = register_bank[`%s_PACKET]; \n", n, uppercase(n, buf));
+            }
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge %s or negedge %s) begin \n", clk, rst);
+            fprintf(txt, "   if (%s == 1'b0) begin \n", rst);
+            fprintf(txt, "     %s_tvalid <= 1'b0; \n", n);
+            fprintf(txt, "     %s_tlast  <= 1'b0; \n", n);
+            fprintf(txt, "     %s_idx    <= 0; \n", n);
+            fprintf(txt, "     %s_count  <= 0; \n", n);
+            fprintf(txt, "   end else begin \n");
+            fprintf(txt, "     if (%s_tvalid && %s_tready) %s_tvalid <= 1'b0; \n", n, n, n);
+            fprintf(txt, "     if (%s_take) begin \n", n);
+            fprintf(txt, "       if (%s_idx == 0) begin \n", n);
+            fprintf(txt, "         %s_tdata <= %s_elem; \n", n, n);
+            fprintf(txt, "         %s_tkeep <= {%d {1'b1}}; \n", n, elem / 8);
+            fprintf(txt, "       end else begin \n");
+            fprintf(txt, "         %s_tdata[%s_idx * %d +: %d] <= %s_elem; \n", n, n, elem, elem, n);
+            fprintf(txt, "         %s_tkeep[%s_idx * %d +: %d] <= {%d {1'b1}}; \n", n, n, elem / 8, elem / 8, elem / 8);
+            fprintf(txt, "       end \n");
+            fprintf(txt, "       %s_count <= (%s_end) ? 0 : %s_count + 1; \n", n, n, n);
+            fprintf(txt, "       if ((%s_idx == %d) || %s_end) begin \n", n, per_beat-1, n);
+            fprintf(txt, "         %s_tvalid <= 1'b1; \n", n);
+            fprintf(txt, "         %s_tlast  <= %s_end; \n", n, n);
+            fprintf(txt, "         %s_idx    <= 0; \n", n);
+            fprintf(txt, "       end else begin \n");
+            fprintf(txt, "         %s_idx    <= %s_idx + 1; \n", n, n);
+            fprintf(txt, "       end \n");
+            fprintf(txt, "     end \n");
+            fprintf(txt, "   end \n");
+            fprintf(txt, " end \n");
+        }
+        fprintf(txt, " \n");
+
+        // the port side, straight through or through a two entry bus_fifo
+        // that registers both TVALID and TREADY
+        if (options.stream_slice) {
+            fprintf(txt, " wire         %s_slice_full; \n", n);
+            fprintf(txt, " \n");
+            if (sp->is_input) {
+                fprintf(txt, " bus_fifo #(%d, 2) %s_slice ( \n", sp->stream_bits + sp->stream_bits/8, n);
+                fprintf(txt, "    .CLK (%s), .RESET_N (%s), \n", clk, rst);
+                fprintf(txt, "    .DATA_STROBE (%s_TVALID), .DATA_IN ({%s_TKEEP, %s_TDATA}), \n", n, n, n);
+                fprintf(txt, "    .DATA_READY (%s_tvalid), .DATA_OUT ({%s_tkeep, %s_tdata}), .DATA_ACK (%s_tready), \n", n, n, n, n);
+                fprintf(txt, "    .FULL (%s_slice_full), .ALMOST_FULL (), .ALMOST_EMPTY () \n", n);
+                fprintf(txt, " ); \n");
+                fprintf(txt, " \n");
+                fprintf(txt, " assign %s_TREADY = !%s_slice_full; \n", n, n);
+            } else {
+                fprintf(txt, " bus_fifo #(%d, 2) %s_slice ( \n", sp->stream_bits + sp->stream_bits/8 + 1, n);
+                fprintf(txt, "    .CLK (%s), .RESET_N (%s), \n", clk, rst);
+                fprintf(txt, "    .DATA_STROBE (%s_tvalid), .DATA_IN ({%s_tlast, %s_tkeep, %s_tdata}), \n", n, n, n, n);
+                fprintf(txt, "    .DATA_READY (%s_TVALID), .DATA_OUT ({%s_TLAST, %s_TKEEP, %s_TDATA}), .DATA_ACK (%s_TREADY), \n", n, n, n, n, n);
+                fprintf(txt, "    .FULL (%s_slice_full), .ALMOST_FULL (), .ALMOST_EMPTY () \n", n);
+                fprintf(txt, " ); \n");
+                fprintf(txt, " \n");
+                fprintf(txt, " assign %s_tready = !%s_slice_full; \n", n, n);
+            }
+        } else {
+            if (sp->is_input) {
+                fprintf(txt, " assign %s_tdata  = %s_TDATA; \n", n, n);
+                fprintf(txt, " assign %s_tkeep  = %s_TKEEP; \n", n, n);
+                fprintf(txt, " assign %s_tvalid = %s_TVALID; \n", n, n);
+                fprintf(txt, " assign %s_TREADY = %s_tready; \n", n, n);
+            } else {
+                fprintf(txt, " assign %s_TDATA  = %s_tdata; \n", n, n);
+                fprintf(txt, " assign %s_TKEEP  = %s_tkeep; \n", n, n);
+                fprintf(txt, " assign %s_TLAST  = %s_tlast; \n", n, n);
+                fprintf(txt, " assign %s_TVALID = %s_tvalid; \n", n, n);
+                fprintf(txt, " assign %s_tready = %s_TREADY; \n", n, n);
+            }
+        }
+    }
+}
+
+
+static void print_dma(FILE *txt, signal_struct *signals)
+{
+    // the read engine feeds dma_in through its data register, in the cycle
+    // the channel empties, so the catapult instance can take an element
+    // every cycle.  The write engine drains dma_out alongside the host
+    // ready.  STATUS shows a START from the cycle after the write, before
+    // the engine itself does.  An engine left out has its half of the port
+    // tied off.
+
+    signal_struct *sp;
+    char buf[STRLEN];
+
+    if (!has_dma()) return;
+
+    fprintf(txt, " \n");
+    fprintf(txt, " // DMA engines \n");
+    fprintf(txt, " \n");
+
+    if (options.dma_in[0]) {
+        sp = find_signal(signals, options.dma_in);
+        uppercase(options.dma_in, buf);
+        fprintf(txt, " \n");
+        fprintf(txt, " assign dma_rd_dispatch = dma_rd_valid && (!%s_valid || %s_ready) && !(write_enable && (write_address == `%s)); \n",
+                     options.dma_in, options.dma_in, buf);
+        fprintf(txt, " \n");
+        fprintf(txt, " axi_dma_read #(BW_BITS, ADDR_BITS, ID_BITS, %d) dma_rd ( \n", dma_elem_bits(sp));
+        fprintf(txt, "    .CLK (clock), .RESETn (resetn), \n");
+        fprintf(txt, "    .START (dma_rd_start), .ADDR (dma_rd_addr[ADDR_BITS-1:0]), .COUNT (write_data[31:0]), \n");
+        fprintf(txt, "    .CLEAR (write_enable && (write_address == `DMA_RD_STATUS)), \n");
+        fprintf(txt, "    .ACTIVE (dma_rd_active), .QUEUED (dma_rd_queued), .ERROR (dma_rd_error), .DONE_COUNT (dma_rd_done), \n");
+        fprintf(txt, "    .ARID (DMA_ARID), .ARADDR (DMA_ARADDR), .ARLEN (DMA_ARLEN), .ARSIZE (DMA_ARSIZE), .ARBURST (DMA_ARBURST), \n");
+        fprintf(txt, "    .ARVALID (DMA_ARVALID), .ARREADY (DMA_ARREADY), \n");
+        fprintf(txt, "    .RID (DMA_RID), .RDATA (DMA_RDATA), .RRESP (DMA_RRESP), .RLAST (DMA_RLAST), \n");
+        fprintf(txt, "    .RVALID (DMA_RVALID), .RREADY (DMA_RREADY), \n");
+        fprintf(txt, "    .ODATA (dma_rd_data), .OVALID (dma_rd_valid), .OREADY (dma_rd_dispatch) \n");
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+    } else {
+        fprintf(txt, " assign DMA_ARID    = {ID_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_ARADDR  = {ADDR_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_ARLEN   = 8'd0; \n");
+        fprintf(txt, " assign DMA_ARSIZE  = BW_BITS; \n");
+        fprintf(txt, " assign DMA_ARBURST = 2'b01; \n");
+        fprintf(txt, " assign DMA_ARVALID = 1'b0; \n");
+        fprintf(txt, " assign DMA_RREADY  = 1'b1; \n");
+        fprintf(txt, " \n");
+    }
+
+    if (options.dma_out[0]) {
+        sp = find_signal(signals, options.dma_out);
+        fprintf(txt, " \n");
+        fprintf(txt, " axi_dma_write #(BW_BITS, ADDR_BITS, ID_BITS, %d) dma_wr ( \n", dma_elem_bits(sp));
+        fprintf(txt, "    .CLK (clock), .RESETn (resetn), \n");
+        fprintf(txt, "    .START (dma_wr_start), .ADDR (dma_wr_addr[ADDR_BITS-1:0]), .COUNT (write_data[31:0]), \n");
+        fprintf(txt, "    .CLEAR (write_enable && (write_address == `DMA_WR_STATUS)), \n");
+        fprintf(txt, "    .ACTIVE (dma_wr_active), .QUEUED (dma_wr_queued), .ERROR (dma_wr_error), .DONE_COUNT (dma_wr_done), \n");
+        fprintf(txt, "    .AWID (DMA_AWID), .AWADDR (DMA_AWADDR), .AWLEN (DMA_AWLEN), .AWSIZE (DMA_AWSIZE), .AWBURST (DMA_AWBURST), \n");
+        fprintf(txt, "    .AWVALID (DMA_AWVALID), .AWREADY (DMA_AWREADY), \n");
+        fprintf(txt, "    .WDATA (DMA_WDATA), .WSTRB (DMA_WSTRB), .WLAST (DMA_WLAST), .WVALID (DMA_WVALID), .WREADY (DMA_WREADY), \n");
+        fprintf(txt, "    .BID (DMA_BID), .BRESP (DMA_BRESP), .BVALID (DMA_BVALID), .BREADY (DMA_BREADY), \n");
+        fprintf(txt, "    .IDATA (%s), .IVALID (%s_valid), .IREADY (dma_wr_iready) \n", options.dma_out, options.dma_out);
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+    } else {
+        fprintf(txt, " assign DMA_AWID    = {ID_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_AWADDR  = {ADDR_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_AWLEN   = 8'd0; \n");
+        fprintf(txt, " assign DMA_AWSIZE  = BW_BITS; \n");
+        fprintf(txt, " assign DMA_AWBURST = 2'b01; \n");
+        fprintf(txt, " assign DMA_AWVALID = 1'b0; \n");
+        fprintf(txt, " assign DMA_WDATA   = {DATA_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_WSTRB   = {STRB_BITS {1'b0}}; \n");
+        fprintf(txt, " assign DMA_WLAST   = 1'b0; \n");
+        fprintf(txt, " assign DMA_WVALID  = 1'b0; \n");
+        fprintf(txt, " assign DMA_BREADY  = 1'b1; \n");
+        fprintf(txt, " \n");
+    }
+}
+
+
 static void print_ready_valids(FILE *txt, signal_struct *signals)
 {
     signal_struct *sp;
     char buf[STRLEN];
+    char ready[NAMELEN];
 
     sp = signals;
 
@@ -646,29 +2239,46 @@ static void print_ready_valids(FILE *txt, signal_struct *signals)
                 fprintf(txt, "             %s_valid <= 1'b1; \n", sp->signal_name);
                 fprintf(txt, "          end \n");
                 fprintf(txt, "       end \n");
+                if (options.cores && (0 == strcmp(sp->signal_name, options.job_channel))) {
+                    fprintf(txt, "       if (slot_dispatch) begin \n");
+                    fprintf(txt, "          %s_valid <= 1'b1; \n", sp->signal_name);
+                    fprintf(txt, "       end \n");
+                }
                 fprintf(txt, "       if (%s_valid && %s_ready) begin \n", sp->signal_name, sp->signal_name);
                 fprintf(txt, "          %s_valid <= 1'b0; \n", sp->signal_name);
                 fprintf(txt, "       end \n");
+                if (0 == strcmp(sp->signal_name, options.dma_in)) {
+                    fprintf(txt, "       if (dma_rd_dispatch) begin \n");
+                    fprintf(txt, "          %s_valid <= 1'b1; \n", sp->signal_name);
+                    fprintf(txt, "       end \n");
+                }
                 fprintf(txt, "    end \n");
                 fprintf(txt, " end \n");
                 fprintf(txt, " \n");
             } else {
+                // a channel drained by the DMA takes the engine's ready as well
+                if (0 == strcmp(sp->signal_name, options.dma_out)) snprintf(ready, sizeof(ready), "%s_host_ready", sp->signal_name);
+                else                                               snprintf(ready, sizeof(ready), "%s_ready", sp->signal_name);
                 fprintf(txt, " \n");
                 fprintf(txt, " always @(posedge clock or negedge resetn) begin \n");
                 fprintf(txt, "    if (!resetn) begin \n");
-                fprintf(txt, "       %s_ready <= 1'b0; \n", sp->signal_name);
+                fprintf(txt, "       %s <= 1'b0; \n", ready);
                 fprintf(txt, "    end else begin \n");
                 fprintf(txt, "       if (read_enable) begin \n");
                 fprintf(txt, "          if (read_address == `%s) begin \n", uppercase(sp->signal_name, buf));
-                fprintf(txt, "             %s_ready <= 1'b1; \n", sp->signal_name);
+                fprintf(txt, "             %s <= 1'b1; \n", ready);
                 fprintf(txt, "          end \n");
                 fprintf(txt, "       end \n");
                 fprintf(txt, "       if (%s_valid && %s_ready) begin \n", sp->signal_name, sp->signal_name);
-                fprintf(txt, "          %s_ready <= 1'b0; \n", sp->signal_name);
+                fprintf(txt, "          %s <= 1'b0; \n", ready);
                 fprintf(txt, "       end \n");
                 fprintf(txt, "    end \n");
                 fprintf(txt, " end \n");
                 fprintf(txt, " \n");
+                if (0 == strcmp(sp->signal_name, options.dma_out)) {
+                    fprintf(txt, " assign %s_ready = %s || dma_wr_iready; \n", sp->signal_name, ready);
+                    fprintf(txt, " \n");
+                }
             }
         }
         sp = sp->next;
@@ -676,196 +2286,3682 @@ static void print_ready_valids(FILE *txt, signal_struct *signals)
 }
 
 
-static void print_catapult_instantiation(FILE *txt, signal_struct *signals, char *instance_name, char *module_name)
+static void print_job_slots(FILE *txt, signal_struct *signals)
 {
-    signal_struct *sp;
+    char buf[STRLEN];
 
-    fprintf(txt, " %s %s ( \n", instance_name, module_name);
-    fprintf(txt, "    .clk (clock), \n");
-    fprintf(txt, "    .arst_n (resetn), \n");
+    if (!options.cores) return;
 
-    sp = signals;
+    // each core owns a SLOT register.  A write marks the slot pending, and
+    // pending slots are passed round robin into the job channel whenever it
+    // is empty, so cores submit jobs without taking a lock.
 
-    while (sp) {
-        fprintf(txt, " \n");
-        if (sp->is_wire) {
-            fprintf(txt, "    .%s_rsc_dat (%s), \n", sp->signal_name, sp->signal_name);
-            fprintf(txt, "    .%s_rsc_triosy_lz (%s_tz)", sp->signal_name, sp->signal_name);
-        } 
-        if (sp->is_channel) {
-            fprintf(txt, "    .%s_rsc_dat (%s), \n", sp->signal_name, sp->signal_name);
-            fprintf(txt, "    .%s_rsc_vld (%s_valid), \n", sp->signal_name, sp->signal_name);
-            fprintf(txt, "    .%s_rsc_rdy (%s_ready)", sp->signal_name, sp->signal_name);
-        }
-        if (sp->is_master) {
-            fprintf(txt, "    .%s_rsc_m_wstate        (m_wstate),                  \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_m_wCaughtUp     (caught_up),                 \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_cfgTimeout      (0),                         \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_cfgrBurstSize   (burst_size),                \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_cfgwBurstSize   (burst_size),                \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_cfgrBaseAddress (addr_offset),               \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_cfgwBaseAddress (addr_offset),               \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_AWREADY  (AWREADY),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWVALID  (AWVALID),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWUSER   (AWUSER),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWREGION (AWREGION),                         \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWQOS    (AWQOS),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWPROT   (AWPROT),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWCACHE  (AWCACHE),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWLOCK   (AWLOCK),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWBURST  (AWBURST),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWSIZE   (AWSIZE),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWLEN    (AWLEN),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWADDR   (AWADDR),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_AWID     (AWID),                             \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_WREADY   (WREADY),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_WVALID   (WVALID),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_WUSER    (WUSER),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_WLAST    (WLAST),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_WSTRB    (WSTRB),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_WDATA    (WDATA),                            \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_BREADY   (BREADY),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_BVALID   (BVALID),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_BUSER    (BUSER),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_BRESP    (BRESP),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_BID      (BID),                              \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_ARREADY  (ARREADY),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARVALID  (ARVALID),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARUSER   (ARUSER),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARREGION (ARREGION),                         \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARQOS    (ARQOS),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARPROT   (ARPROT),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARCACHE  (ARCACHE),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARLOCK   (ARLOCK),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARBURST  (ARBURST),                          \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARSIZE   (ARSIZE),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARLEN    (ARLEN),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARADDR   (ARADDR),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_ARID     (ARID),                             \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_RREADY   (RREADY),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RVALID   (RVALID),                           \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RUSER    (RUSER),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RLAST    (RLAST),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RRESP    (RRESP),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RDATA    (RDATA),                            \n", sp->signal_name);
-            fprintf(txt, "    .%s_rsc_RID      (RID),                              \n", sp->signal_name);
-            fprintf(txt, "                                                         \n");
-            fprintf(txt, "    .%s_rsc_triosy_lz (%s_triosy_lz)", sp->signal_name, sp->signal_name);
-        }
-        if (sp->next) fprintf(txt, ", \n");
-        else fprintf(txt, " \n");
-        
-        sp = sp->next;
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(*) begin \n");
+    fprintf(txt, "    slot_found = 1'b0; \n");
+    fprintf(txt, "    slot_sel   = slot_last; \n");
+    fprintf(txt, "    for (slot_i=%d; slot_i>0; slot_i=slot_i-1) begin \n", options.cores);
+    fprintf(txt, "       if (slot_pending[(slot_last + slot_i) %% %d]) begin \n", options.cores);
+    fprintf(txt, "          slot_found = 1'b1; \n");
+    fprintf(txt, "          slot_sel   = (slot_last + slot_i) %% %d; \n", options.cores);
+    fprintf(txt, "       end \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " assign slot_dispatch = slot_found && !%s_valid && !(write_enable && (write_address == `%s)); \n",
+                 options.job_channel, uppercase(options.job_channel, buf));
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(posedge clock or negedge resetn) begin \n");
+    fprintf(txt, "    if (!resetn) begin \n");
+    fprintf(txt, "       slot_pending <= %d'd0; \n", options.cores);
+    fprintf(txt, "       slot_last    <= 5'd%d; \n", options.cores-1);
+    fprintf(txt, "    end else begin \n");
+    fprintf(txt, "       if (slot_dispatch) begin \n");
+    fprintf(txt, "          slot_pending[slot_sel] <= 1'b0; \n");
+    fprintf(txt, "          slot_last <= slot_sel; \n");
+    fprintf(txt, "       end \n");
+    fprintf(txt, "       if (write_enable && (write_address >= `SLOT_0) && (write_address < `SLOT_0 + %d)) begin \n", options.cores);
+    fprintf(txt, "          slot_pending[write_address - `SLOT_0] <= 1'b1; \n");
+    fprintf(txt, "       end \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+}
+
+
+static void print_axi_payload(FILE *txt, int channel, char *prefix)
+{
+    axi_field *f;
+
+    fprintf(txt, "{");
+    for (f=axi_fields[channel]; f->name; f++) {
+        fprintf(txt, "%s%s%s%s", (f == axi_fields[channel]) ? "" : ", ", prefix, axi_channels[channel], f->name);
     }
-    fprintf(txt, " ); \n");
+    fprintf(txt, "}");
 }
 
 
-static void print_epilog(FILE *txt)
+// the channel that starts a job on the core and the one it finishes on,
+// held back at the clock crossing until the wires beside them have crossed
+
+static int cdc_ordered(signal_struct *sp)
 {
-    fprintf(txt, " endmodule \n");
+    if (!sp->is_channel) return 0;
+    if (sp->is_input) return (0 == strcmp(sp->signal_name, options.job_channel));
+    return (0 == strcmp(sp->signal_name, "done"));
 }
 
 
-static void print_header_file(FILE *txt, signal_struct *signals, int accelerator_base_address)
+static void print_cdc_idle(FILE *txt, signal_struct *signals, int is_input)
+{
+    signal_struct *sp;
+    char *sep = "";
+
+    fprintf(txt, " wire         cdc_%s_idle = ", (is_input) ? "in" : "out");
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_wire && (sp->is_input == is_input)) {
+            fprintf(txt, "%s%s_cdc_idle", sep, sp->signal_name);
+            sep = " \n                           && ";
+        }
+    }
+    if (is_input && has_master(signals)) {
+        fprintf(txt, "%saddr_offset_cdc_idle", sep);
+        sep = " \n                           && ";
+        fprintf(txt, "%sburst_size_cdc_idle", sep);
+    }
+    if (!*sep) fprintf(txt, "1'b1");
+    fprintf(txt, "; \n");
+}
+
+
+static void print_clock_crossing(FILE *txt, signal_struct *signals)
 {
     signal_struct *sp;
-    int index = 0;
     char buf[STRLEN];
-    int i;
-    const int offset = 30;
+    axi_field *f;
+    int ch;
 
-    sp = signals;
+    if (!options.core_clock) return;
 
-    fprintf(txt, "/*************************************************************************** \n");
-    fprintf(txt, " *  accelerator interface header                                             \n");
-    fprintf(txt, " ***************************************************************************/\n");
-    fprintf(txt, "   \n");
-    fprintf(txt, "#define ACCEL_ADDR ((volatile unsigned int *) 0x%08x) \n", accelerator_base_address);
-    fprintf(txt, "   \n");
-    fprintf(txt, "   \n");
-    fprintf(txt, "// register map \n");
-    fprintf(txt, "   \n");
+    // the register bank stays on the bus clock.  Wires cross through
+    // cdc_bus_sync, channels and the master port through async FIFOs, and the
+    // core reset is asserted with resetn and released on core_clock.
+    //
+    // A wire and a channel take separate paths, so the job channel is not
+    // pushed until every bus side wire (and the master's addr_offset and
+    // burst_size) has reached the core, and done is not pushed until every
+    // core side wire has reached the bus.  A job starts on the wires written
+    // before it, in whole, and the host reads the wires the core wrote before
+    // done.  Other channels are not held, and a core wire that never settles
+    // holds done with it.
+
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(posedge core_clock or negedge resetn) begin \n");
+    fprintf(txt, "    if (!resetn) begin \n");
+    fprintf(txt, "       core_reset_sync <= 2'b00; \n");
+    fprintf(txt, "    end else begin \n");
+    fprintf(txt, "       core_reset_sync <= {core_reset_sync[0], 1'b1}; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " assign core_resetn = core_reset_sync[1]; \n");
+    fprintf(txt, " \n");
 
+    sp = signals;
     while (sp) {
-        if (!sp->is_master) {
-            fprintf(txt, "#define %s_REG", uppercase(sp->signal_name, buf));
-            for (i=strlen(sp->signal_name); i<offset; i++) fprintf(txt, " ");
-            fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
-            if (sp->is_channel) {
-                if (sp->is_input) {
-                    fprintf(txt, "#define %s_READY_REG", uppercase(sp->signal_name, buf));
-                    for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                    fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
-                } else {
-                    fprintf(txt, "#define %s_VALID_REG", uppercase(sp->signal_name, buf));
-                    for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                    fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
-                }
+        if (sp->is_wire) {
+            fprintf(txt, " wire         %s_cdc_idle; \n", sp->signal_name);
+            fprintf(txt, " \n");
+            fprintf(txt, " cdc_bus_sync #(%d) %s_cdc ( \n", sp->width, sp->signal_name);
+            if (sp->is_input) {
+                fprintf(txt, "    .SCLK (clock), .SRESETn (resetn), .SDATA (%s), .SIDLE (%s_cdc_idle), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .DCLK (core_clock), .DRESETn (core_resetn), .DDATA (c_%s) \n", sp->signal_name);
+            } else {
+                fprintf(txt, "    .SCLK (core_clock), .SRESETn (core_resetn), .SDATA (c_%s), .SIDLE (%s_cdc_idle), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .DCLK (clock), .DRESETn (resetn), .DDATA (%s) \n", sp->signal_name);
             }
+            fprintf(txt, " ); \n");
+            fprintf(txt, " \n");
         }
         sp = sp->next;
     }
+
     if (has_master(signals)) {
-        fprintf(txt, "#define ADDR_OFFSET_LOW_REG");
-        for (i=strlen("ADDR_OFFSET_LOW_REG"); i<offset+4; i++) fprintf(txt, " ");
-        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
+        fprintf(txt, " wire         addr_offset_cdc_idle; \n");
+        fprintf(txt, " wire         burst_size_cdc_idle; \n");
+        fprintf(txt, " \n");
+        fprintf(txt, " cdc_bus_sync #(ADDR_BITS) addr_offset_cdc ( \n");
+        fprintf(txt, "    .SCLK (clock), .SRESETn (resetn), .SDATA (addr_offset), .SIDLE (addr_offset_cdc_idle), \n");
+        fprintf(txt, "    .DCLK (core_clock), .DRESETn (core_resetn), .DDATA (c_addr_offset) \n");
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+        fprintf(txt, " cdc_bus_sync #(32) burst_size_cdc ( \n");
+        fprintf(txt, "    .SCLK (clock), .SRESETn (resetn), .SDATA (burst_size), .SIDLE (burst_size_cdc_idle), \n");
+        fprintf(txt, "    .DCLK (core_clock), .DRESETn (core_resetn), .DDATA (c_burst_size) \n");
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+    }
 
-        fprintf(txt, "#define ADDR_OFFSET_HIGH_REG");
-        for (i=strlen("ADDR_OFFSET_HIGH_REG"); i<offset+4; i++) fprintf(txt, " ");
-        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
+    print_cdc_idle(txt, signals, 1);
+    print_cdc_idle(txt, signals, 0);
+    fprintf(txt, " \n");
 
-        fprintf(txt, "#define BURST_SIZE_REG");
-        for (i=strlen("BURST_SIZE_REG"); i<offset+4; i++) fprintf(txt, " ");
-        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", index++);
+    // an ordered channel offers its word, and takes the FIFO's ready, only
+    // while the wires of its side are idle
+
+    sp = signals;
+    while (sp) {
+        if (sp->is_channel) {
+            char *wp = (sp->is_input) ? ""   : "c_";   // write side of the FIFO
+            char *rp = (sp->is_input) ? "c_" : "";
+            char *idle = (sp->is_input) ? "cdc_in_idle" : "cdc_out_idle";
+
+            if (cdc_ordered(sp)) {
+                fprintf(txt, " wire         %s%s_wready; \n", wp, sp->signal_name);
+                fprintf(txt, " \n");
+                fprintf(txt, " assign %s%s_ready = %s%s_wready && %s; \n", wp, sp->signal_name, wp, sp->signal_name, idle);
+                fprintf(txt, " \n");
+            }
+            fprintf(txt, " async_fifo #(%d, %d) %s_cdc ( \n", sp->width, options.cdc_depth, sp->signal_name);
+            if (sp->is_input) fprintf(txt, "    .WCLK (clock), .WRESETn (resetn), \n");
+            else              fprintf(txt, "    .WCLK (core_clock), .WRESETn (core_resetn), \n");
+            if (cdc_ordered(sp)) {
+                fprintf(txt, "    .WVALID (%s%s_valid && %s), .WDATA (%s%s), .WREADY (%s%s_wready), \n",
+                        wp, sp->signal_name, idle, wp, sp->signal_name, wp, sp->signal_name);
+            } else {
+                fprintf(txt, "    .WVALID (%s%s_valid), .WDATA (%s%s), .WREADY (%s%s_ready), \n",
+                        wp, sp->signal_name, wp, sp->signal_name, wp, sp->signal_name);
+            }
+            if (sp->is_input) fprintf(txt, "    .RCLK (core_clock), .RRESETn (core_resetn), \n");
+            else              fprintf(txt, "    .RCLK (clock), .RRESETn (resetn), \n");
+            fprintf(txt, "    .RVALID (%s%s_valid), .RDATA (%s%s), .RREADY (%s%s_ready) \n",
+                    rp, sp->signal_name, rp, sp->signal_name, rp, sp->signal_name);
+            fprintf(txt, " ); \n");
+            fprintf(txt, " \n");
+        }
+        sp = sp->next;
+    }
+
+    if (has_master(signals)) {
+
+        fprintf(txt, " axi_cdc_bridge #( \n");
+        for (ch=0; ch<5; ch++) {
+            fprintf(txt, "    .%s_bits (", lowercase(strcpy(buf, axi_channels[ch])));
+            for (f=axi_fields[ch]; f->name; f++) {
+                fprintf(txt, "%s%s", (f == axi_fields[ch]) ? "" : " + ", axi_field_width(ch, f, buf));
+            }
+            fprintf(txt, "), \n");
+        }
+        fprintf(txt, "    .depth (%d) \n", options.cdc_depth);
+        fprintf(txt, " ) master_cdc ( \n");
+        fprintf(txt, "    .CORE_CLK (core_clock), .CORE_RESETn (core_resetn), \n");
+        fprintf(txt, "    .BUS_CLK (clock), .BUS_RESETn (resetn)");
+        for (ch=0; ch<5; ch++) {
+            char *from = ((ch == 2) || (ch == 4)) ? "BUS"  : "CORE";
+            char *to   = ((ch == 2) || (ch == 4)) ? "CORE" : "BUS";
+            char *bp   = (options.scatter_gather) ? "s_" : "";   // bus side, the scatter-gather unit when there is one
+            char *fp   = ((ch == 2) || (ch == 4)) ? bp     : "c_";
+            char *tp   = ((ch == 2) || (ch == 4)) ? "c_"   : bp;
+
+            fprintf(txt, ", \n \n");
+            fprintf(txt, "    .%s_%s_DATA (", from, axi_channels[ch]);
+            print_axi_payload(txt, ch, fp);
+            fprintf(txt, "), \n");
+            fprintf(txt, "    .%s_%s_VALID (%s%sVALID), .%s_%s_READY (%s%sREADY), \n",
+                         from, axi_channels[ch], fp, axi_channels[ch], from, axi_channels[ch], fp, axi_channels[ch]);
+            fprintf(txt, "    .%s_%s_DATA (", to, axi_channels[ch]);
+            print_axi_payload(txt, ch, tp);
+            fprintf(txt, "), \n");
+            fprintf(txt, "    .%s_%s_VALID (%s%sVALID), .%s_%s_READY (%s%sREADY)",
+                         to, axi_channels[ch], tp, axi_channels[ch], to, axi_channels[ch], tp, axi_channels[ch]);
+        }
+        fprintf(txt, " \n");
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+    }
+}
+
+
+static void print_scatter_gather(FILE *txt, signal_struct *signals)
+{
+    // axi_sg_remap sits between the master port and the bus on the bus
+    // clock, so it reads the segment list through the same port.  It drives
+    // the addresses, the handshakes and the responses it makes itself, the
+    // other fields of the master pass straight through.
+
+    static const char *driven[] = { "AWADDR", "BID", "BRESP", "ARID", "ARADDR", "ARLEN", "ARSIZE", "ARBURST",
+                                    "RID", "RDATA", "RRESP", "RLAST", NULL };
+    char name[STRLEN];
+    axi_field *f;
+    int ch;
+    int i;
+
+    if (!options.scatter_gather) return;
+
+    fprintf(txt, " \n");
+    fprintf(txt, " // scatter-gather remap of the master port \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " axi_sg_remap #(BW_BITS, ADDR_BITS, ID_BITS) sg_remap ( \n");
+    fprintf(txt, "    .CLK (clock), .RESETn (resetn), \n");
+    fprintf(txt, "    .LIST (sg_list[ADDR_BITS-1:0]), .COUNT (register_bank[`SG_COUNT]), \n");
+    fprintf(txt, "    .FLUSH (write_enable && (write_address == `SG_COUNT)), \n");
+    fprintf(txt, "    .CLEAR (write_enable && (write_address == `SG_STATUS)), .ERROR (sg_error), \n");
+    fprintf(txt, "    .S_AWID (s_AWID), .S_AWADDR (s_AWADDR), .S_AWVALID (s_AWVALID), .S_AWREADY (s_AWREADY), \n");
+    fprintf(txt, "    .M_AWADDR (AWADDR), .M_AWVALID (AWVALID), .M_AWREADY (AWREADY), \n");
+    fprintf(txt, "    .S_WLAST (s_WLAST), .S_WVALID (s_WVALID), .S_WREADY (s_WREADY), \n");
+    fprintf(txt, "    .M_WVALID (WVALID), .M_WREADY (WREADY), \n");
+    fprintf(txt, "    .S_BID (s_BID), .S_BRESP (s_BRESP), .S_BVALID (s_BVALID), .S_BREADY (s_BREADY), \n");
+    fprintf(txt, "    .M_BID (BID), .M_BRESP (BRESP), .M_BVALID (BVALID), .M_BREADY (BREADY), \n");
+    fprintf(txt, "    .S_ARID (s_ARID), .S_ARADDR (s_ARADDR), .S_ARLEN (s_ARLEN), .S_ARSIZE (s_ARSIZE), .S_ARBURST (s_ARBURST), \n");
+    fprintf(txt, "    .S_ARVALID (s_ARVALID), .S_ARREADY (s_ARREADY), \n");
+    fprintf(txt, "    .M_ARID (ARID), .M_ARADDR (ARADDR), .M_ARLEN (ARLEN), .M_ARSIZE (ARSIZE), .M_ARBURST (ARBURST), \n");
+    fprintf(txt, "    .M_ARVALID (ARVALID), .M_ARREADY (ARREADY), \n");
+    fprintf(txt, "    .S_RID (s_RID), .S_RDATA (s_RDATA), .S_RRESP (s_RRESP), .S_RLAST (s_RLAST), \n");
+    fprintf(txt, "    .S_RVALID (s_RVALID), .S_RREADY (s_RREADY), \n");
+    fprintf(txt, "    .M_RID (RID), .M_RDATA (RDATA), .M_RRESP (RRESP), .M_RLAST (RLAST), \n");
+    fprintf(txt, "    .M_RVALID (RVALID), .M_RREADY (RREADY) \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+
+    for (ch=0; ch<5; ch++) {
+        for (f=axi_fields[ch]; f->name; f++) {
+            sprintf(name, "%s%s", axi_channels[ch], f->name);
+            for (i=0; driven[i] && strcmp(driven[i], name); i++);
+            if (driven[i]) continue;
+            if ((ch == 2) || (ch == 4)) fprintf(txt, " assign s_%-10s = %s; \n", name, name);
+            else                        fprintf(txt, " assign %-12s = s_%s; \n", name, name);
+        }
+    }
+    fprintf(txt, " \n");
+}
+
+
+static void print_catapult_instantiation(FILE *txt, signal_struct *signals, char *instance_name, char *module_name)
+{
+    signal_struct *sp;
+    char *cp = (options.core_clock) ? "c_" : "";   // signals on the catapult side of the clock crossing
+    char *mp = (options.core_clock) ? "c_" : (options.scatter_gather) ? "s_" : "";   // its master port
+
+    fprintf(txt, " %s %s ( \n", instance_name, module_name);
+    if (options.core_clock) {
+        fprintf(txt, "    .clk (core_clock), \n");
+        fprintf(txt, "    .arst_n (core_resetn), \n");
+    } else {
+        fprintf(txt, "    .clk (clock), \n");
+        fprintf(txt, "    .arst_n (resetn), \n");
+    }
+
+    sp = signals;
+
+    while (sp) {
+        fprintf(txt, " \n");
+        if (sp->is_wire) {
+            fprintf(txt, "    .%s_rsc_dat (%s%s), \n", sp->signal_name, cp, sp->signal_name);
+            fprintf(txt, "    .%s_rsc_triosy_lz (%s_tz)", sp->signal_name, sp->signal_name);
+        } 
+        if (sp->is_channel) {
+            fprintf(txt, "    .%s_rsc_dat (%s%s), \n", sp->signal_name, cp, sp->signal_name);
+            fprintf(txt, "    .%s_rsc_vld (%s%s_valid), \n", sp->signal_name, cp, sp->signal_name);
+            fprintf(txt, "    .%s_rsc_rdy (%s%s_ready)", sp->signal_name, cp, sp->signal_name);
+        }
+        if (sp->is_stream) {
+            fprintf(txt, "    .%s_rsc_dat (%s), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_rsc_vld (%s_valid), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_rsc_rdy (%s_ready)", sp->signal_name, sp->signal_name);
+        }
+        if (sp->is_memory) {
+            // the RAM is dual clocked, so memories need no clock crossing
+            if (sp->is_input) {
+                fprintf(txt, "    .%s_rsc_radr (%s_radr), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .%s_rsc_re (%s_re), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .%s_rsc_q (%s_q), \n", sp->signal_name, sp->signal_name);
+            } else {
+                fprintf(txt, "    .%s_rsc_wadr (%s_wadr), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .%s_rsc_we (%s_we), \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "    .%s_rsc_d (%s_d), \n", sp->signal_name, sp->signal_name);
+            }
+            fprintf(txt, "    .%s_rsc_triosy_lz (%s_triosy_lz)", sp->signal_name, sp->signal_name);
+        }
+        if (sp->is_master) {
+            fprintf(txt, "    .%s_rsc_m_wstate        (m_wstate),                  \n", sp->signal_name);
+            fprintf(txt, "    .%s_rsc_m_wCaughtUp     (caught_up),                 \n", sp->signal_name);
+            fprintf(txt, "    .%s_rsc_cfgTimeout      (0),                         \n", sp->signal_name);
+            fprintf(txt, "    .%s_rsc_cfgrBurstSize   (%sburst_size),              \n", sp->signal_name, cp);
+            fprintf(txt, "    .%s_rsc_cfgwBurstSize   (%sburst_size),              \n", sp->signal_name, cp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_cfgrBaseAddress (%saddr_offset),             \n", sp->signal_name, cp);
+            fprintf(txt, "    .%s_rsc_cfgwBaseAddress (%saddr_offset),             \n", sp->signal_name, cp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_AWREADY  (%sAWREADY),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWVALID  (%sAWVALID),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWUSER   (%sAWUSER),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWREGION (%sAWREGION),                       \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWQOS    (%sAWQOS),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWPROT   (%sAWPROT),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWCACHE  (%sAWCACHE),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWLOCK   (%sAWLOCK),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWBURST  (%sAWBURST),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWSIZE   (%sAWSIZE),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWLEN    (%sAWLEN),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWADDR   (%sAWADDR),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_AWID     (%sAWID),                           \n", sp->signal_name, mp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_WREADY   (%sWREADY),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_WVALID   (%sWVALID),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_WUSER    (%sWUSER),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_WLAST    (%sWLAST),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_WSTRB    (%sWSTRB),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_WDATA    (%sWDATA),                          \n", sp->signal_name, mp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_BREADY   (%sBREADY),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_BVALID   (%sBVALID),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_BUSER    (%sBUSER),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_BRESP    (%sBRESP),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_BID      (%sBID),                            \n", sp->signal_name, mp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_ARREADY  (%sARREADY),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARVALID  (%sARVALID),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARUSER   (%sARUSER),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARREGION (%sARREGION),                       \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARQOS    (%sARQOS),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARPROT   (%sARPROT),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARCACHE  (%sARCACHE),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARLOCK   (%sARLOCK),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARBURST  (%sARBURST),                        \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARSIZE   (%sARSIZE),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARLEN    (%sARLEN),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARADDR   (%sARADDR),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_ARID     (%sARID),                           \n", sp->signal_name, mp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_RREADY   (%sRREADY),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RVALID   (%sRVALID),                         \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RUSER    (%sRUSER),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RLAST    (%sRLAST),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RRESP    (%sRRESP),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RDATA    (%sRDATA),                          \n", sp->signal_name, mp);
+            fprintf(txt, "    .%s_rsc_RID      (%sRID),                            \n", sp->signal_name, mp);
+            fprintf(txt, "                                                         \n");
+            fprintf(txt, "    .%s_rsc_triosy_lz (%s_triosy_lz)", sp->signal_name, sp->signal_name);
+        }
+        if (sp->next) fprintf(txt, ", \n");
+        else fprintf(txt, " \n");
+        
+        sp = sp->next;
+    }
+    fprintf(txt, " ); \n");
+}
+
+
+static void print_epilog(FILE *txt)
+{
+    fprintf(txt, " endmodule \n");
+}
+
+
+static void print_header_clock(FILE *txt)
+{
+    fprintf(txt, "// ACCEL_TIME() times the trace and the statistics below, nanoseconds from \n");
+    fprintf(txt, "// CLOCK_MONOTONIC unless defined first, only differences of it are used \n\n");
+    fprintf(txt, "#if defined(ACCEL_TRACE) || defined(ACCEL_STATS) \n");
+    fprintf(txt, "#ifndef ACCEL_TIME \n");
+    fprintf(txt, "#include <time.h> \n");
+    fprintf(txt, "static inline unsigned int accel_time(void) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    struct timespec t; \n");
+    fprintf(txt, "    clock_gettime(CLOCK_MONOTONIC, &t); \n");
+    fprintf(txt, "    return (unsigned int) (t.tv_sec * 1000000000ull + t.tv_nsec); \n");
+    fprintf(txt, "} \n");
+    fprintf(txt, "#define ACCEL_TIME()                     accel_time() \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "#endif \n\n");
+}
+
+
+static void print_header_trace(FILE *txt)
+{
+    const int stride = 1 << (options.bw_bits - 2);   // 32 bit words per register slot
+
+    // every register access in the macros below goes through ACCEL_READ and
+    // ACCEL_WRITE (print_header_access), so with ACCEL_TRACE each one is
+    // logged to a ring buffer the replay bench of the replay option reads back
+
+    fprintf(txt, "// define ACCEL_TRACE to log each register access made by these macros to a \n");
+    fprintf(txt, "// ring of the last ACCEL_TRACE_SIZE accesses, and ACCEL_TRACE_IMPL in one \n");
+    fprintf(txt, "// source file to allocate it.  ACCEL_TRACE_TIME() stamps them, ACCEL_TIME() \n");
+    fprintf(txt, "// unless defined first.  With <stdio.h> included first \n");
+    fprintf(txt, "// accel_trace_save() writes the ring out for the replay bench. \n\n");
+    fprintf(txt, "#ifdef ACCEL_TRACE \n\n");
+    fprintf(txt, "#ifndef ACCEL_TRACE_SIZE \n");
+    fprintf(txt, "#define ACCEL_TRACE_SIZE                 4096 \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "#ifndef ACCEL_TRACE_TIME \n");
+    fprintf(txt, "#define ACCEL_TRACE_TIME()               ACCEL_TIME() \n");
+    fprintf(txt, "#endif \n\n");
+    fprintf(txt, "#define ACCEL_TRACE_MAGIC                0x52544341u \n");
+    fprintf(txt, "#define ACCEL_TRACE_WRITE                0x80000000u \n\n");
+    fprintf(txt, "typedef struct { \n");
+    fprintf(txt, "    unsigned int time;      // ACCEL_TRACE_TIME() as the access starts \n");
+    fprintf(txt, "    unsigned int reg;       // register number, ACCEL_TRACE_WRITE set for a write \n");
+    fprintf(txt, "    unsigned int value; \n");
+    fprintf(txt, "} accel_trace_record; \n\n");
+    fprintf(txt, "extern accel_trace_record accel_trace_buf[ACCEL_TRACE_SIZE]; \n");
+    fprintf(txt, "extern unsigned int accel_trace_count; \n");
+    fprintf(txt, "#ifdef ACCEL_TRACE_IMPL \n");
+    fprintf(txt, "accel_trace_record accel_trace_buf[ACCEL_TRACE_SIZE]; \n");
+    fprintf(txt, "unsigned int accel_trace_count; \n");
+    fprintf(txt, "#endif \n\n");
+    fprintf(txt, "static inline void accel_trace_put(unsigned int time, unsigned int reg, unsigned int value) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    accel_trace_record *r = &accel_trace_buf[accel_trace_count++ %% ACCEL_TRACE_SIZE]; \n");
+    fprintf(txt, "    r->time = time; \n");
+    fprintf(txt, "    r->reg = reg; \n");
+    fprintf(txt, "    r->value = value; \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "static inline unsigned int accel_trace_read(volatile unsigned int *reg) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    unsigned int time = ACCEL_TRACE_TIME(); \n");
+    fprintf(txt, "    unsigned int value = *reg; \n");
+    fprintf(txt, "    accel_trace_put(time, (unsigned int) (reg - ACCEL_ADDR) / %d, value); \n", stride);
+    fprintf(txt, "    return value; \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "static inline void accel_trace_write(volatile unsigned int *reg, unsigned int value) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    accel_trace_put(ACCEL_TRACE_TIME(), ACCEL_TRACE_WRITE | ((unsigned int) (reg - ACCEL_ADDR) / %d), value); \n", stride);
+    fprintf(txt, "    *reg = value; \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "#ifdef EOF \n");
+    fprintf(txt, "// magic, records, records lost off the ring, 0, then the records oldest first \n");
+    fprintf(txt, "static inline int accel_trace_save(FILE *f) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    unsigned int n = (accel_trace_count < ACCEL_TRACE_SIZE) ? accel_trace_count : ACCEL_TRACE_SIZE; \n");
+    fprintf(txt, "    unsigned int first = accel_trace_count - n; \n");
+    fprintf(txt, "    unsigned int head[4]; \n");
+    fprintf(txt, "    unsigned int i; \n\n");
+    fprintf(txt, "    head[0] = ACCEL_TRACE_MAGIC; \n");
+    fprintf(txt, "    head[1] = n; \n");
+    fprintf(txt, "    head[2] = first; \n");
+    fprintf(txt, "    head[3] = 0; \n");
+    fprintf(txt, "    if (fwrite(head, sizeof(head), 1, f) != 1) return -1; \n");
+    fprintf(txt, "    for (i=first; i!=accel_trace_count; i++) { \n");
+    fprintf(txt, "        if (fwrite(&accel_trace_buf[i %% ACCEL_TRACE_SIZE], sizeof(accel_trace_record), 1, f) != 1) return -1; \n");
+    fprintf(txt, "    } \n");
+    fprintf(txt, "    return 0; \n");
+    fprintf(txt, "} \n");
+    fprintf(txt, "#endif \n\n");
+    fprintf(txt, "#endif \n\n");
+}
+
+
+static void print_header_stats(FILE *txt, signal_struct *signals)
+{
+    char name[STRLEN];
+    int count = register_count(signals);
+    int i;
+
+    // per register counts of the accesses made through ACCEL_READ,
+    // ACCEL_WRITE and ACCEL_POLL.  A poll that succeeds on its first read
+    // costs one read and no clock reads, so only time actually spent
+    // spinning is timed.
+
+    fprintf(txt, "// define ACCEL_STATS to count the reads and writes of each register made by \n");
+    fprintf(txt, "// these macros, the polls that had to wait, the reads they spun for and the \n");
+    fprintf(txt, "// ACCEL_TIME() they took, and ACCEL_STATS_IMPL in one source file to \n");
+    fprintf(txt, "// allocate the counts.  They are plain per process counters.  With \n");
+    fprintf(txt, "// <stdio.h> included first accel_stats_report() prints them. \n\n");
+    fprintf(txt, "#ifdef ACCEL_STATS \n\n");
+    fprintf(txt, "#define ACCEL_REGISTERS                  %d \n\n", count);
+    fprintf(txt, "typedef struct { \n");
+    fprintf(txt, "    unsigned int reads;             // including the reads of polls \n");
+    fprintf(txt, "    unsigned int writes; \n");
+    fprintf(txt, "    unsigned int waits;             // polls not satisfied by their first read \n");
+    fprintf(txt, "    unsigned int spins;             // reads of those polls after the first \n");
+    fprintf(txt, "    unsigned long long spin_time;   // ACCEL_TIME() spent in them \n");
+    fprintf(txt, "} accel_stats_entry; \n\n");
+    fprintf(txt, "extern accel_stats_entry accel_stats[ACCEL_REGISTERS]; \n");
+    fprintf(txt, "#ifdef ACCEL_STATS_IMPL \n");
+    fprintf(txt, "accel_stats_entry accel_stats[ACCEL_REGISTERS]; \n");
+    fprintf(txt, "#endif \n\n");
+    fprintf(txt, "static inline void accel_stats_reset(void) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    unsigned int i; \n\n");
+    fprintf(txt, "    for (i=0; i<ACCEL_REGISTERS; i++) { \n");
+    fprintf(txt, "        accel_stats[i].reads = 0; \n");
+    fprintf(txt, "        accel_stats[i].writes = 0; \n");
+    fprintf(txt, "        accel_stats[i].waits = 0; \n");
+    fprintf(txt, "        accel_stats[i].spins = 0; \n");
+    fprintf(txt, "        accel_stats[i].spin_time = 0; \n");
+    fprintf(txt, "    } \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "#ifdef EOF \n");
+    fprintf(txt, "// one line per register used, with its share of the total spin time \n");
+    fprintf(txt, "static inline void accel_stats_report(FILE *f) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    static const char *const names[ACCEL_REGISTERS] = { \n");
+    for (i=0; register_name(signals, i, name); i++) {
+        fprintf(txt, "        \"%s\"%s \n", name, (i < count - 1) ? "," : "");
+    }
+    fprintf(txt, "    }; \n");
+    fprintf(txt, "    unsigned long long total = 0; \n");
+    fprintf(txt, "    unsigned int i; \n\n");
+    fprintf(txt, "    for (i=0; i<ACCEL_REGISTERS; i++) total += accel_stats[i].spin_time; \n");
+    fprintf(txt, "    fprintf(f, \"%%-24s %%10s %%10s %%10s %%10s %%14s %%6s\\n\", \"register\", \"reads\", \"writes\", \"waits\", \"spins\", \"spin time\", \"%%\"); \n");
+    fprintf(txt, "    for (i=0; i<ACCEL_REGISTERS; i++) { \n");
+    fprintf(txt, "        if (accel_stats[i].reads + accel_stats[i].writes == 0) continue; \n");
+    fprintf(txt, "        fprintf(f, \"%%-24s %%10u %%10u %%10u %%10u %%14llu %%6.1f\\n\", names[i], \n");
+    fprintf(txt, "                accel_stats[i].reads, accel_stats[i].writes, accel_stats[i].waits, accel_stats[i].spins, \n");
+    fprintf(txt, "                accel_stats[i].spin_time, total ? 100.0 * accel_stats[i].spin_time / total : 0.0); \n");
+    fprintf(txt, "    } \n");
+    fprintf(txt, "} \n");
+    fprintf(txt, "#endif \n\n");
+    fprintf(txt, "#endif \n\n");
+}
+
+
+static void print_header_access(FILE *txt)
+{
+    const int stride = 1 << (options.bw_bits - 2);   // 32 bit words per register slot
+
+    // the one place registers are read and written, plain volatile
+    // accesses unless ACCEL_TRACE or ACCEL_STATS hook them.  ACCEL_POLL
+    // reads R until (R & MASK) == VALUE.
+
+    fprintf(txt, "#if defined(ACCEL_TRACE) || defined(ACCEL_STATS) \n\n");
+    fprintf(txt, "static inline unsigned int accel_read(volatile unsigned int *reg) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "#ifdef ACCEL_STATS \n");
+    fprintf(txt, "    unsigned int r = (unsigned int) (reg - ACCEL_ADDR) / %d; \n", stride);
+    fprintf(txt, "    if (r < ACCEL_REGISTERS) accel_stats[r].reads++; \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "#ifdef ACCEL_TRACE \n");
+    fprintf(txt, "    return accel_trace_read(reg); \n");
+    fprintf(txt, "#else \n");
+    fprintf(txt, "    return *reg; \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "static inline void accel_write(volatile unsigned int *reg, unsigned int value) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "#ifdef ACCEL_STATS \n");
+    fprintf(txt, "    unsigned int r = (unsigned int) (reg - ACCEL_ADDR) / %d; \n", stride);
+    fprintf(txt, "    if (r < ACCEL_REGISTERS) accel_stats[r].writes++; \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "#ifdef ACCEL_TRACE \n");
+    fprintf(txt, "    accel_trace_write(reg, value); \n");
+    fprintf(txt, "#else \n");
+    fprintf(txt, "    *reg = value; \n");
+    fprintf(txt, "#endif \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "#define ACCEL_READ(R)                    accel_read(&(R)) \n");
+    fprintf(txt, "#define ACCEL_WRITE(R, X)                accel_write(&(R), (X)) \n\n");
+    fprintf(txt, "#else \n\n");
+    fprintf(txt, "#define ACCEL_READ(R)                    (R) \n");
+    fprintf(txt, "#define ACCEL_WRITE(R, X)                ((R) = (X)) \n\n");
+    fprintf(txt, "#endif \n\n");
+
+    fprintf(txt, "#ifdef ACCEL_STATS \n\n");
+    fprintf(txt, "static inline void accel_poll(volatile unsigned int *reg, unsigned int mask, unsigned int value) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    unsigned int r = (unsigned int) (reg - ACCEL_ADDR) / %d; \n", stride);
+    fprintf(txt, "    unsigned int spins = 0; \n");
+    fprintf(txt, "    unsigned int start; \n\n");
+    fprintf(txt, "    if ((accel_read(reg) & mask) == value) return; \n");
+    fprintf(txt, "    start = ACCEL_TIME(); \n");
+    fprintf(txt, "    do spins++; while ((accel_read(reg) & mask) != value); \n");
+    fprintf(txt, "    if (r < ACCEL_REGISTERS) { \n");
+    fprintf(txt, "        accel_stats[r].waits++; \n");
+    fprintf(txt, "        accel_stats[r].spins += spins; \n");
+    fprintf(txt, "        accel_stats[r].spin_time += (unsigned int) (ACCEL_TIME() - start); \n");
+    fprintf(txt, "    } \n");
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "#define ACCEL_POLL(R, MASK, VALUE)       accel_poll(&(R), (MASK), (VALUE)) \n\n");
+    fprintf(txt, "#else \n\n");
+    fprintf(txt, "#define ACCEL_POLL(R, MASK, VALUE)       while ((ACCEL_READ(R) & (MASK)) != (VALUE)) \n\n");
+    fprintf(txt, "#endif \n\n");
+}
+
+
+static void print_header_shadow(FILE *txt, signal_struct *signals)
+{
+    signal_struct *sp;
+    char buf[STRLEN];
+    int count = 0;
+    int index;
+    int i;
+    const int offset = 30;
+
+    // only the host writes input wires, so with ACCEL_SHADOW their SET_ and
+    // GET_ work on a copy in memory and ACCEL_FLUSH writes the changed ones
+    // to the device.  Outputs and the ready/valid flags always read the device.
+
+    sp = signals;
+    while (sp) {
+        if (sp->is_wire && sp->is_input) count++;
+        sp = sp->next;
+    }
+
+    fprintf(txt, "// host written registers, define ACCEL_SHADOW to keep a copy in memory and \n");
+    fprintf(txt, "// ACCEL_SHADOW_IMPL in one source file to allocate it \n\n");
+    fprintf(txt, "#ifdef ACCEL_SHADOW \n\n");
+    if (count) {
+        fprintf(txt, "extern unsigned int accel_shadow[%d]; \n", count);
+        fprintf(txt, "extern unsigned int accel_dirty[%d]; \n", (count + 31) / 32);
+        fprintf(txt, "#ifdef ACCEL_SHADOW_IMPL \n");
+        fprintf(txt, "unsigned int accel_shadow[%d]; \n", count);
+        fprintf(txt, "unsigned int accel_dirty[%d]; \n", (count + 31) / 32);
+        fprintf(txt, "#endif \n\n");
+    }
+
+    index = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_wire && sp->is_input) {
+            fprintf(txt, "#define SET_%s(X) ", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+            fprintf(txt, " { accel_shadow[%d] = X; accel_dirty[%d] |= 1u << %d; } \n", index, index / 32, index % 32);
+            fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+            fprintf(txt, " { X = accel_shadow[%d]; } \n", index);
+            index++;
+        }
+        sp = sp->next;
+    }
+
+    fprintf(txt, "\n");
+    fprintf(txt, "static inline void accel_flush(void) \n");
+    fprintf(txt, "{ \n");
+    index = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_wire && sp->is_input) {
+            fprintf(txt, "    if (accel_dirty[%d] & (1u << %d)) ACCEL_WRITE(%s_REG, accel_shadow[%d]); \n", index / 32, index % 32, uppercase(sp->signal_name, buf), index);
+            index++;
+        }
+        sp = sp->next;
+    }
+    for (i=0; i<(count + 31) / 32; i++) fprintf(txt, "    accel_dirty[%d] = 0; \n", i);
+    fprintf(txt, "} \n\n");
+
+    // after a reset of the device, or to pick up values another driver wrote
+    fprintf(txt, "static inline void accel_shadow_load(void) \n");
+    fprintf(txt, "{ \n");
+    index = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_wire && sp->is_input) {
+            fprintf(txt, "    accel_shadow[%d] = ACCEL_READ(%s_REG); \n", index++, uppercase(sp->signal_name, buf));
+        }
+        sp = sp->next;
+    }
+    for (i=0; i<(count + 31) / 32; i++) fprintf(txt, "    accel_dirty[%d] = 0; \n", i);
+    fprintf(txt, "} \n\n");
+    fprintf(txt, "#define ACCEL_FLUSH                      accel_flush() \n\n");
+
+    fprintf(txt, "#else \n\n");
+    sp = signals;
+    while (sp) {
+        if (sp->is_wire && sp->is_input) {
+            fprintf(txt, "#define SET_%s(X) ", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+            fprintf(txt, " { ACCEL_WRITE(%s_REG, X); } \n", uppercase(sp->signal_name, buf));
+            fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+            fprintf(txt, " { X = ACCEL_READ(%s_REG); } \n", uppercase(sp->signal_name, buf));
+        }
+        sp = sp->next;
+    }
+    fprintf(txt, "\n");
+    fprintf(txt, "#define ACCEL_FLUSH                      do { } while (0) \n\n");
+    fprintf(txt, "#endif \n\n");
+}
+
+
+static void print_header_status(FILE *txt, signal_struct *signals)
+{
+    signal_struct *sp;
+    char buf[STRLEN];
+    int index;
+    int i;
+    const int offset = 30;
+
+    if (!channel_count(signals)) return;
+
+    // one CHANNEL_STATUS read shows every channel that can move, so
+    // accel_service() handles them all for the cost of one read per 32
+    // channels.  An input handler returns non-zero when it has a value to
+    // send, an output handler is passed the value read.
+
+    fprintf(txt, "\n");
+    index = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_channel) {
+            fprintf(txt, "#define %s_STATUS_BIT", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-7; i++) fprintf(txt, " ");
+            fprintf(txt, " %d \n", index++);
+        }
+        sp = sp->next;
+    }
+
+    fprintf(txt, "\n");
+    fprintf(txt, "typedef struct { \n");
+    sp = signals;
+    while (sp) {
+        if (sp->is_channel) {
+            if (sp->is_input) fprintf(txt, "    int  (*%s)(unsigned int *value); \n", sp->signal_name);
+            else              fprintf(txt, "    void (*%s)(unsigned int value); \n", sp->signal_name);
+        }
+        sp = sp->next;
+    }
+    fprintf(txt, "} accel_handlers; \n");
+    fprintf(txt, "\n");
+    fprintf(txt, "static inline int accel_service(const accel_handlers *h) \n");
+    fprintf(txt, "{ \n");
+    fprintf(txt, "    unsigned int status; \n");
+    fprintf(txt, "    unsigned int value; \n");
+    fprintf(txt, "    int serviced = 0; \n");
+    index = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_channel) {
+            if ((index % 32) == 0) {
+                fprintf(txt, "\n");
+                fprintf(txt, "    status = ACCEL_READ(CHANNEL_STATUS_%d_REG); \n", index / 32);
+            }
+            uppercase(sp->signal_name, buf);
+            if (sp->is_input) {
+                fprintf(txt, "    if (h->%s && (status & (1u << %d)) && h->%s(&value)) { ACCEL_FLUSH; ACCEL_WRITE(%s_REG, value); serviced++; } \n",
+                             sp->signal_name, index % 32, sp->signal_name, buf);
+            } else {
+                fprintf(txt, "    if (h->%s && (status & (1u << %d))) { h->%s(ACCEL_READ(%s_REG)); serviced++; } \n",
+                             sp->signal_name, index % 32, sp->signal_name, buf);
+            }
+            index++;
+        }
+        sp = sp->next;
+    }
+    fprintf(txt, "    return serviced; \n");
+    fprintf(txt, "} \n");
+}
+
+
+static void print_header_file(FILE *txt, signal_struct *signals, int accelerator_base_address)
+{
+    signal_struct *sp;
+    int index = 0;
+    char buf[NAMELEN];
+    int i;
+    int n;
+    const int offset = 30;
+    const int stride = 1 << (options.bw_bits - 2);   // 32 bit words per register slot
+
+    sp = signals;
+
+    fprintf(txt, "/*************************************************************************** \n");
+    fprintf(txt, " *  accelerator interface header                                             \n");
+    fprintf(txt, " ***************************************************************************/\n");
+    fprintf(txt, "   \n");
+    fprintf(txt, "#define ACCEL_ADDR ((volatile unsigned int *) 0x%08x) \n", accelerator_base_address);
+    fprintf(txt, "   \n");
+    fprintf(txt, "   \n");
+    fprintf(txt, "// register map \n");
+    fprintf(txt, "   \n");
+
+    while (sp) {
+        if (in_register_bank(sp)) {
+            fprintf(txt, "#define %s_REG", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset; i++) fprintf(txt, " ");
+            fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+            if (sp->is_channel) {
+                if (sp->is_input) {
+                    fprintf(txt, "#define %s_READY_REG", uppercase(sp->signal_name, buf));
+                    for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+                    fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+                } else {
+                    fprintf(txt, "#define %s_VALID_REG", uppercase(sp->signal_name, buf));
+                    for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+                    fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+                }
+            }
+        }
+        sp = sp->next;
+    }
+    if (has_master(signals)) {
+        fprintf(txt, "#define ADDR_OFFSET_LOW_REG");
+        for (i=strlen("ADDR_OFFSET_LOW_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+
+        fprintf(txt, "#define ADDR_OFFSET_HIGH_REG");
+        for (i=strlen("ADDR_OFFSET_HIGH_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+
+        fprintf(txt, "#define BURST_SIZE_REG");
+        for (i=strlen("BURST_SIZE_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+    }
+    if (options.cores) {
+        fprintf(txt, "#define TICKET_REG");
+        for (i=strlen("TICKET_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+
+        fprintf(txt, "#define SERVING_REG");
+        for (i=strlen("SERVING_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+
+        fprintf(txt, "#define SLOT_PENDING_REG");
+        for (i=strlen("SLOT_PENDING_REG"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+
+        fprintf(txt, "#define SLOT_REG(N)");
+        for (i=strlen("SLOT_REG(N)"); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d + %d * (N))) \n", stride * index, stride);
+        index += options.cores;
+    }
+    for (n=0; n<(channel_count(signals) + 31) / 32; n++) {
+        sprintf(buf, "CHANNEL_STATUS_%d_REG", n);
+        fprintf(txt, "#define %s", buf);
+        for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+        fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+    }
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream && !sp->is_input) {
+            fprintf(txt, "#define %s_PACKET_REG", uppercase(sp->signal_name, buf));
+            for (i=strlen(sp->signal_name); i<offset-7; i++) fprintf(txt, " ");
+            fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+        }
+    }
+    for (n=0; n<2; n++) {
+        static const char *dma_regs[] = { "ADDR_LOW", "ADDR_HIGH", "COUNT", "STATUS" };
+        int r;
+
+        if (!((n == 0) ? options.dma_in : options.dma_out)[0]) continue;
+        for (r=0; r<4; r++) {
+            sprintf(buf, "DMA_%s_%s_REG", (n == 0) ? "RD" : "WR", dma_regs[r]);
+            fprintf(txt, "#define %s", buf);
+            for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+            fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+        }
+    }
+    if (options.scatter_gather) {
+        static const char *sg_regs[] = { "LIST_LOW", "LIST_HIGH", "COUNT", "STATUS" };
+
+        for (n=0; n<4; n++) {
+            sprintf(buf, "SG_%s_REG", sg_regs[n]);
+            fprintf(txt, "#define %s", buf);
+            for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+            fprintf(txt, " (*(ACCEL_ADDR + %d)) \n", stride * index++);
+        }
+    }
+
+    // memories, one element per bus word, the byte offset is for loading
+    // them with a DMA engine
+    n = 0;
+    sp = signals;
+    while (sp) {
+        if (sp->is_memory) {
+            n++;
+            if (n == 1) fprintf(txt, "\n// memories \n\n");
+            snprintf(buf, sizeof(buf), "%s_MEM(N)", sp->signal_name);
+            fprintf(txt, "#define %s", uppercase(buf, buf));
+            for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+            fprintf(txt, " (*(ACCEL_ADDR + %d + %d * (N))) \n", stride * (n << memory_window_bits(signals)), stride);
+            snprintf(buf, sizeof(buf), "%s_MEM_OFFSET", sp->signal_name);
+            fprintf(txt, "#define %s", uppercase(buf, buf));
+            for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+            fprintf(txt, " 0x%08x \n", (n << memory_window_bits(signals)) << options.bw_bits);
+            snprintf(buf, sizeof(buf), "%s_DEPTH", sp->signal_name);
+            fprintf(txt, "#define %s", uppercase(buf, buf));
+            for (i=strlen(buf); i<offset+4; i++) fprintf(txt, " ");
+            fprintf(txt, " %d \n", sp->depth);
+        }
+        sp = sp->next;
+    }
+    fprintf(txt, "\n\n\n");
+    fprintf(txt, "// convenience macros \n\n");
+
+    print_header_clock(txt);
+    print_header_trace(txt);
+    print_header_stats(txt, signals);
+    print_header_access(txt);
+    print_header_shadow(txt, signals);
+
+    sp = signals;
+    while (sp) {
+        if (in_register_bank(sp)) {
+           if (sp->is_channel && (0 == strcmp(sp->signal_name, "go"))) {
+               fprintf(txt, "#define GO                               { ACCEL_FLUSH; ACCEL_POLL(GO_READY_REG, 1u, 1u); ACCEL_WRITE(GO_REG, 1); } \n");
+           }
+           else if (sp->is_channel && (0 == strcmp(sp->signal_name, "done"))) {
+               fprintf(txt, "#define WAIT_FOR_DONE                    { ACCEL_POLL(DONE_VALID_REG, 1u, 1u); volatile unsigned int x = ACCEL_READ(DONE_REG); } \n");
+           }
+           else {
+                if (sp->is_input) {
+                    if (sp->is_channel) {
+                        fprintf(txt, "#define SET_%s(X) ", uppercase(sp->signal_name, buf));
+                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+                        fprintf(txt, " { ACCEL_FLUSH; ACCEL_POLL(%s_READY_REG, 1u, 1u); ACCEL_WRITE(%s_REG, X); } \n", uppercase(sp->signal_name, buf), uppercase(sp->signal_name, buf));
+                    }
+                } else {
+                    if (sp->is_channel) {
+                        fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
+                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+                        fprintf(txt, " { ACCEL_POLL(%s_VALID_REG, 1u, 1u); X = ACCEL_READ(%s_REG); } \n", uppercase(sp->signal_name, buf), uppercase(sp->signal_name, buf));
+                    } else {
+                        fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
+                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
+                        fprintf(txt, " { X = ACCEL_READ(%s_REG); } \n", uppercase(sp->signal_name, buf));
+                    }
+                }
+           }
+       }
+       sp = sp->next;
+    }
+
+    if (options.cores) {
+        // ACCEL_LOCK/ACCEL_UNLOCK bracket a run of register writes that must
+        // not interleave with another core, SUBMIT_JOB needs no lock
+        fprintf(txt, "\n");
+        fprintf(txt, "#define ACCEL_CORES                      %d \n", options.cores);
+        fprintf(txt, "#define ACCEL_LOCK                       { unsigned int accel_ticket = ACCEL_READ(TICKET_REG); ACCEL_POLL(SERVING_REG, ~0u, accel_ticket); } \n");
+        fprintf(txt, "#define ACCEL_UNLOCK                     { ACCEL_FLUSH; ACCEL_WRITE(SERVING_REG, 1); } \n");
+        fprintf(txt, "#define SUBMIT_JOB(CORE, X)              { ACCEL_POLL(SLOT_PENDING_REG, 1u << (CORE), 0); ACCEL_WRITE(SLOT_REG(CORE), X); } \n");
+    }
+
+    if (has_dma()) {
+        // a START while one transfer runs is queued behind it, so waiting
+        // only for the queue slot chains buffers back to back
+        fprintf(txt, "\n");
+        fprintf(txt, "#define DMA_ACTIVE                       0x1 \n");
+        fprintf(txt, "#define DMA_QUEUED                       0x2 \n");
+        fprintf(txt, "#define DMA_ERROR                        0x4 \n");
+        fprintf(txt, "#define DMA_DONE_COUNT(S)                ((S) >> 16) \n");
+    }
+    for (n=0; n<2; n++) {
+        char *e = (n == 0) ? "RD" : "WR";
+
+        if (!((n == 0) ? options.dma_in : options.dma_out)[0]) continue;
+        fprintf(txt, "#define DMA_%s_START(ADDR, N)            { ACCEL_FLUSH; ACCEL_POLL(DMA_%s_STATUS_REG, DMA_QUEUED, 0); ACCEL_WRITE(DMA_%s_ADDR_LOW_REG, (unsigned int) (ADDR)); ",
+                     e, e, e);
+        fprintf(txt, "ACCEL_WRITE(DMA_%s_ADDR_HIGH_REG, (unsigned int) ((unsigned long long) (ADDR) >> 32)); ACCEL_WRITE(DMA_%s_COUNT_REG, (N)); } \n", e, e);
+        fprintf(txt, "#define DMA_%s_WAIT                      { ACCEL_POLL(DMA_%s_STATUS_REG, DMA_ACTIVE | DMA_QUEUED, 0); } \n", e, e);
+    }
+
+    if (options.scatter_gather) {
+        // the master addresses the buffer from OFFSET, its byte offset in the
+        // first segment, so segment boundaries fall on 4KB in linear
+        // addresses too.  Every segment but the last is whole 4KB pages.
+        fprintf(txt, "\n");
+        fprintf(txt, "typedef struct { unsigned long long addr; unsigned int length; unsigned int reserved; } accel_sg_segment; \n");
+        fprintf(txt, "#define SG_PAGE                          4096 \n");
+        fprintf(txt, "#define SG_ERROR                         0x1 \n");
+        fprintf(txt, "#define SG_START(LIST, N, OFFSET)        { ACCEL_FLUSH; ACCEL_WRITE(ADDR_OFFSET_LOW_REG, (unsigned int) (OFFSET)); ACCEL_WRITE(ADDR_OFFSET_HIGH_REG, 0); ");
+        fprintf(txt, "ACCEL_WRITE(SG_LIST_LOW_REG, (unsigned int) (LIST)); ACCEL_WRITE(SG_LIST_HIGH_REG, (unsigned int) ((unsigned long long) (LIST) >> 32)); ");
+        fprintf(txt, "ACCEL_WRITE(SG_COUNT_REG, (N)); } \n");
+        fprintf(txt, "#define SG_CLEAR                         { ACCEL_WRITE(SG_STATUS_REG, 0); } \n");
+    }
+
+    print_header_status(txt, signals);
+}
+ 
+               
+// testbench: a stand-in for the catapult instance, an AXI master bus
+// functional model on axi_slave_interface and a memory on the DMA port
+
+static const char *tb_slave_port[][2] = {
+   {"AWMASTER", "1"}, {"AWID", "ID_BITS"}, {"AWADDR", "SLAVE_BITS"}, {"AWLEN", "8"}, {"AWSIZE", "3"}, {"AWBURST", "2"},
+   {"AWLOCK", "1"}, {"AWCACHE", "4"}, {"AWPROT", "3"}, {"AWVALID", "1"}, {"AWREADY", "1"},
+   {"WMASTER", "1"}, {"WID", "ID_BITS"}, {"WDATA", "DATA_BITS"}, {"WSTRB", "STRB_BITS"}, {"WLAST", "1"},
+   {"WVALID", "1"}, {"WREADY", "1"},
+   {"BMASTER", "1"}, {"BID", "ID_BITS"}, {"BRESP", "2"}, {"BVALID", "1"}, {"BREADY", "1"},
+   {"ARMASTER", "1"}, {"ARID", "ID_BITS"}, {"ARADDR", "SLAVE_BITS"}, {"ARLEN", "8"}, {"ARSIZE", "3"}, {"ARBURST", "2"},
+   {"ARLOCK", "1"}, {"ARCACHE", "4"}, {"ARPROT", "3"}, {"ARVALID", "1"}, {"ARREADY", "1"},
+   {"RMASTER", "1"}, {"RID", "ID_BITS"}, {"RDATA", "DATA_BITS"}, {"RRESP", "2"}, {"RLAST", "1"},
+   {"RVALID", "1"}, {"RREADY", "1"},
+   {NULL, NULL}
+};
+
+static const char *lite_slave_port[][2] = {
+   {"AWADDR", "SLAVE_BITS"}, {"AWPROT", "3"}, {"AWVALID", "1"}, {"AWREADY", "1"},
+   {"WDATA", "DATA_BITS"}, {"WSTRB", "STRB_BITS"}, {"WVALID", "1"}, {"WREADY", "1"},
+   {"BRESP", "2"}, {"BVALID", "1"}, {"BREADY", "1"},
+   {"ARADDR", "SLAVE_BITS"}, {"ARPROT", "3"}, {"ARVALID", "1"}, {"ARREADY", "1"},
+   {"RDATA", "DATA_BITS"}, {"RRESP", "2"}, {"RVALID", "1"}, {"RREADY", "1"},
+   {NULL, NULL}
+};
+
+static const char *tb_dma_port[][2] = {
+   {"AWID", "ID_BITS"}, {"AWADDR", "ADDR_BITS"}, {"AWLEN", "8"}, {"AWSIZE", "3"}, {"AWBURST", "2"},
+   {"AWVALID", "1"}, {"AWREADY", "1"},
+   {"WDATA", "DATA_BITS"}, {"WSTRB", "STRB_BITS"}, {"WLAST", "1"}, {"WVALID", "1"}, {"WREADY", "1"},
+   {"BID", "ID_BITS"}, {"BRESP", "2"}, {"BVALID", "1"}, {"BREADY", "1"},
+   {"ARID", "ID_BITS"}, {"ARADDR", "ADDR_BITS"}, {"ARLEN", "8"}, {"ARSIZE", "3"}, {"ARBURST", "2"},
+   {"ARVALID", "1"}, {"ARREADY", "1"},
+   {"RID", "ID_BITS"}, {"RDATA", "DATA_BITS"}, {"RRESP", "2"}, {"RLAST", "1"}, {"RVALID", "1"}, {"RREADY", "1"},
+   {NULL, NULL}
+};
+
+
+static signal_struct *tb_go(signal_struct *signals)
+{
+    // the go channel when the spec also has done, as used by GO and
+    // WAIT_FOR_DONE in the header, and neither is taken by a DMA engine.  Go
+    // may be the job channel, fed from the job slots.
+
+    signal_struct *go = find_signal(signals, "go");
+    signal_struct *done = find_signal(signals, "done");
+
+    if (!go || !go->is_channel || !go->is_input || (0 == strcmp(options.dma_in, "go"))) return NULL;
+    if (!done || !done->is_channel || done->is_input || (0 == strcmp(options.dma_out, "done"))) return NULL;
+    return go;
+}
+
+
+static char *tb_range(int width, char *buf)
+{
+    if (width > 1) sprintf(buf, "[%d:0]", width-1);
+    else strcpy(buf, "");
+    return buf;
+}
+
+
+static char *tb_slice(int width, char *buf)
+{
+    // low bits of a 32 bit count to compare with a value of width bits
+    if (width < 32) sprintf(buf, "[%d:0]", width-1);
+    else strcpy(buf, "");
+    return buf;
+}
+
+
+static char *tb_pattern(int width, char *buf)
+{
+    // 0101.. over width bits, the value the stand-in drives on output wires
+    int digits = (width + 3) / 4;
+    char *p;
+    int i;
+
+    p = buf + sprintf(buf, "%d'h%x", width, 0x5 & ((1 << (width - 4 * (digits - 1))) - 1));
+    for (i=1; i<digits; i++) *p++ = '5';
+    *p = 0;
+    return buf;
+}
+
+
+static void print_stub_port(FILE *txt, int decl, char *dir, char *range, char *name, char *port)
+{
+    if (decl) fprintf(txt, " %-6s %-20s %s_rsc_%s; \n", dir, range, name, port);
+    else      fprintf(txt, ", \n    %s_rsc_%s", name, port);
+}
+
+
+static void print_stub_ports(FILE *txt, signal_struct *signals, int decl)
+{
+    // the ports print_catapult_instantiation connects, names first then declarations
+
+    signal_struct *sp;
+    char range[STRLEN];
+    char port[STRLEN];
+    char buf[STRLEN];
+    char *in;
+    char *out;
+    axi_field *f;
+    int ch;
+
+    for (sp=signals; sp; sp=sp->next) {
+        in  = (sp->is_input) ? "input" : "output";
+        out = (sp->is_input) ? "output" : "input";
+        tb_range(sp->width, range);
+        if (sp->is_wire) {
+            print_stub_port(txt, decl, in, range, sp->signal_name, "dat");
+            print_stub_port(txt, decl, "output", "", sp->signal_name, "triosy_lz");
+        }
+        if (sp->is_channel || sp->is_stream) {
+            print_stub_port(txt, decl, in, range, sp->signal_name, "dat");
+            print_stub_port(txt, decl, in, "", sp->signal_name, "vld");
+            print_stub_port(txt, decl, out, "", sp->signal_name, "rdy");
+        }
+        if (sp->is_memory) {
+            tb_range(log2_ceil(sp->depth), buf);
+            if (sp->is_input) {
+                print_stub_port(txt, decl, "output", buf, sp->signal_name, "radr");
+                print_stub_port(txt, decl, "output", "", sp->signal_name, "re");
+                print_stub_port(txt, decl, "input", range, sp->signal_name, "q");
+            } else {
+                print_stub_port(txt, decl, "output", buf, sp->signal_name, "wadr");
+                print_stub_port(txt, decl, "output", "", sp->signal_name, "we");
+                print_stub_port(txt, decl, "output", range, sp->signal_name, "d");
+            }
+            print_stub_port(txt, decl, "output", "", sp->signal_name, "triosy_lz");
+        }
+        if (sp->is_master) {
+            print_stub_port(txt, decl, "output", "[2:0]", sp->signal_name, "m_wstate");
+            print_stub_port(txt, decl, "output", "", sp->signal_name, "m_wCaughtUp");
+            print_stub_port(txt, decl, "input", "[31:0]", sp->signal_name, "cfgTimeout");
+            print_stub_port(txt, decl, "input", "[31:0]", sp->signal_name, "cfgrBurstSize");
+            print_stub_port(txt, decl, "input", "[31:0]", sp->signal_name, "cfgwBurstSize");
+            print_stub_port(txt, decl, "input", "[ADDR_BITS-1:0]", sp->signal_name, "cfgrBaseAddress");
+            print_stub_port(txt, decl, "input", "[ADDR_BITS-1:0]", sp->signal_name, "cfgwBaseAddress");
+            for (ch=0; ch<5; ch++) {
+                // B and R come back to the master
+                char *fwd  = ((ch == 2) || (ch == 4)) ? "input" : "output";
+                char *back = ((ch == 2) || (ch == 4)) ? "output" : "input";
+
+                for (f=axi_fields[ch]; f->name; f++) {
+                    sprintf(range, "[%s-1:0]", axi_field_width(ch, f, buf));
+                    sprintf(port, "%s%s", axi_channels[ch], f->name);
+                    print_stub_port(txt, decl, fwd, range, sp->signal_name, port);
+                }
+                sprintf(port, "%sVALID", axi_channels[ch]);
+                print_stub_port(txt, decl, fwd, "", sp->signal_name, port);
+                sprintf(port, "%sREADY", axi_channels[ch]);
+                print_stub_port(txt, decl, back, "", sp->signal_name, port);
+            }
+            print_stub_port(txt, decl, "output", "", sp->signal_name, "triosy_lz");
+        }
+    }
+}
+
+
+static void print_tb_stub(FILE *txt, signal_struct *signals, char *instance_name)
+{
+    signal_struct *sp;
+    signal_struct *go = tb_go(signals);
+    char buf[STRLEN];
+    char *n;
+    axi_field *f;
+    int ch;
+
+    fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "// stand-in for the catapult instance, define TB_CATAPULT_RTL to simulate \n");
+    fprintf(txt, "// the catapult RTL instead.  Input channels and streams take an element \n");
+    fprintf(txt, "// every cycle and count the ones that differ from the element count, \n");
+    fprintf(txt, "// output channels and streams offer the element count every cycle, done \n");
+    fprintf(txt, "// follows each go by STUB_LATENCY cycles, output wires hold 0101.. and \n");
+    fprintf(txt, "// output memories are written with their addresses after reset.  The \n");
+    fprintf(txt, "// master port stays idle. \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "module %s ( \n", instance_name);
+    fprintf(txt, "    clk, \n");
+    fprintf(txt, "    arst_n");
+    print_stub_ports(txt, signals, 0);
+    fprintf(txt, " \n");
+    fprintf(txt, "); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " parameter STUB_LATENCY = 100; \n");
+    if (has_master(signals)) {
+        fprintf(txt, " parameter ID_BITS      = %d; \n", options.id_bits);
+        fprintf(txt, " parameter ADDR_BITS    = %d; \n", options.addr_bits);
+        fprintf(txt, " parameter DATA_BITS    = %d; \n", 8 << options.bw_bits);
+        fprintf(txt, " parameter STRB_BITS    = %d; \n", 1 << options.bw_bits);
+        if (options.awuser_bits) fprintf(txt, " parameter AWUSER_BITS  = %d; \n", options.awuser_bits);
+        if (options.wuser_bits)  fprintf(txt, " parameter WUSER_BITS   = %d; \n", options.wuser_bits);
+        if (options.buser_bits)  fprintf(txt, " parameter BUSER_BITS   = %d; \n", options.buser_bits);
+        if (options.aruser_bits) fprintf(txt, " parameter ARUSER_BITS  = %d; \n", options.aruser_bits);
+        if (options.ruser_bits)  fprintf(txt, " parameter RUSER_BITS   = %d; \n", options.ruser_bits);
+    }
+    fprintf(txt, " \n");
+    fprintf(txt, " input                       clk; \n");
+    fprintf(txt, " input                       arst_n; \n");
+    print_stub_ports(txt, signals, 1);
+
+    if (go) {
+        fprintf(txt, " \n");
+        fprintf(txt, " reg  [ 31:0] stub_timer; \n");
+        fprintf(txt, " reg          stub_done; \n");
+        fprintf(txt, " \n");
+        fprintf(txt, " always @(posedge clk or negedge arst_n) begin \n");
+        fprintf(txt, "    if (!arst_n) begin \n");
+        fprintf(txt, "       stub_timer <= 0; \n");
+        fprintf(txt, "       stub_done  <= 1'b0; \n");
+        fprintf(txt, "    end else begin \n");
+        fprintf(txt, "       if (go_rsc_vld) stub_timer <= STUB_LATENCY; \n");
+        fprintf(txt, "       else if (stub_timer != 0) stub_timer <= stub_timer - 1; \n");
+        fprintf(txt, "       if (stub_timer == 1) stub_done <= 1'b1; \n");
+        fprintf(txt, "       else if (done_rsc_vld && done_rsc_rdy) stub_done <= 1'b0; \n");
+        fprintf(txt, "    end \n");
+        fprintf(txt, " end \n");
+    }
+
+    for (sp=signals; sp; sp=sp->next) {
+        n = sp->signal_name;
+        fprintf(txt, " \n");
+        if (sp->is_wire) {
+            if (!sp->is_input) fprintf(txt, " assign %s_rsc_dat = %s; \n", n, tb_pattern(sp->width, buf));
+            fprintf(txt, " assign %s_rsc_triosy_lz = 1'b1; \n", n);
+        }
+        if ((sp->is_channel || sp->is_stream) && sp->is_input) {
+            fprintf(txt, " reg  [ 31:0] %s_count; \n", n);
+            fprintf(txt, " reg  [ 31:0] %s_errors; \n", n);
+            fprintf(txt, " \n");
+            fprintf(txt, " assign %s_rsc_rdy = 1'b1; \n", n);
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge clk or negedge arst_n) begin \n");
+            fprintf(txt, "    if (!arst_n) begin \n");
+            fprintf(txt, "       %s_count  <= 0; \n", n);
+            fprintf(txt, "       %s_errors <= 0; \n", n);
+            fprintf(txt, "    end else if (%s_rsc_vld) begin \n", n);
+            fprintf(txt, "       if (%s_rsc_dat != %s_count%s) %s_errors <= %s_errors + 1; \n", n, n, tb_slice(sp->width, buf), n, n);
+            fprintf(txt, "       %s_count <= %s_count + 1; \n", n, n);
+            fprintf(txt, "    end \n");
+            fprintf(txt, " end \n");
+        }
+        if ((sp->is_channel || sp->is_stream) && !sp->is_input) {
+            fprintf(txt, " reg  [ 31:0] %s_count; \n", n);
+            fprintf(txt, " \n");
+            fprintf(txt, " assign %s_rsc_dat = %s_count%s; \n", n, n, tb_slice(sp->width, buf));
+            fprintf(txt, " assign %s_rsc_vld = %s; \n", n, (go && (0 == strcmp(n, "done"))) ? "stub_done" : "1'b1");
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge clk or negedge arst_n) begin \n");
+            fprintf(txt, "    if (!arst_n) %s_count <= 0; \n", n);
+            fprintf(txt, "    else if (%s_rsc_vld && %s_rsc_rdy) %s_count <= %s_count + 1; \n", n, n, n, n);
+            fprintf(txt, " end \n");
+        }
+        if (sp->is_memory) {
+            if (sp->is_input) {
+                fprintf(txt, " assign %s_rsc_radr = 0; \n", n);
+                fprintf(txt, " assign %s_rsc_re = 1'b0; \n", n);
+            } else {
+                fprintf(txt, " reg  [ 31:0] %s_fill; \n", n);
+                fprintf(txt, " \n");
+                fprintf(txt, " assign %s_rsc_wadr = %s_fill[%d:0]; \n", n, n, log2_ceil(sp->depth)-1);
+                fprintf(txt, " assign %s_rsc_we = (%s_fill < %d) ? 1'b1 : 1'b0; \n", n, n, sp->depth);
+                fprintf(txt, " assign %s_rsc_d = %s_fill%s; \n", n, n, tb_slice(sp->width, buf));
+                fprintf(txt, " \n");
+                fprintf(txt, " always @(posedge clk or negedge arst_n) begin \n");
+                fprintf(txt, "    if (!arst_n) %s_fill <= 0; \n", n);
+                fprintf(txt, "    else if (%s_rsc_we) %s_fill <= %s_fill + 1; \n", n, n, n);
+                fprintf(txt, " end \n");
+            }
+            fprintf(txt, " assign %s_rsc_triosy_lz = 1'b1; \n", n);
+        }
+        if (sp->is_master) {
+            fprintf(txt, " assign %s_rsc_m_wstate = 3'd0; \n", n);
+            fprintf(txt, " assign %s_rsc_m_wCaughtUp = 1'b0; \n", n);
+            for (ch=0; ch<5; ch++) {
+                if ((ch == 2) || (ch == 4)) {
+                    fprintf(txt, " assign %s_rsc_%sREADY = 1'b1; \n", n, axi_channels[ch]);
+                    continue;
+                }
+                for (f=axi_fields[ch]; f->name; f++) {
+                    fprintf(txt, " assign %s_rsc_%s%s = 0; \n", n, axi_channels[ch], f->name);
+                }
+                fprintf(txt, " assign %s_rsc_%sVALID = 1'b0; \n", n, axi_channels[ch]);
+            }
+            fprintf(txt, " assign %s_rsc_triosy_lz = 1'b1; \n", n);
+        }
+    }
+    fprintf(txt, " \n");
+    fprintf(txt, "endmodule \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "`endif \n");
+    fprintf(txt, " \n");
+}
+
+
+static void print_tb_port(FILE *txt, const char *port[][2], char *prefix, char *wire_prefix)
+{
+    // connections of an AXI port to the wires of the same name
+    int i;
+
+    for (i=0; port[i][0]; i++) {
+        fprintf(txt, ", \n    .%s%-10s (%s%s)", prefix, port[i][0], wire_prefix, port[i][0]);
+    }
+}
+
+
+static void print_slice_params(FILE *txt, int *slice)
+{
+    // register slice parameters of axi_slave_interface, bypass is its default
+    int c;
+
+    for (c=0; c<5; c++) {
+        if (slice[c]) fprintf(txt, ", .%s(%d)", slice_options[c], slice[c]);
+    }
+}
+
+
+static void print_tb_report(FILE *txt, char *name, char *elements, char *last, int bus)
+{
+    // elements moved since the phase began at cycle first, with the bus
+    // transactions and data beats of the slave port when bus is set
+
+    fprintf(txt, "    $display(\"%s: %%0d elements in %%0d cycles, %%0.3f per cycle", name);
+    if (bus) fprintf(txt, ", %%0.3f transactions and %%0.3f beats per cycle");
+    fprintf(txt, "\", \n");
+    fprintf(txt, "             %s, %s - first, 1.0 * (%s) / (%s - first)", elements, last, elements, last);
+    if (bus) {
+        fprintf(txt, ", \n");
+        fprintf(txt, "             1.0 * (bfm.transactions - first_transactions) / (%s - first), 1.0 * (bfm.beats - first_beats) / (%s - first)", last, last);
+    }
+    fprintf(txt, "); \n");
+}
+
+
+static void print_tb_poll(FILE *txt, signal_struct *signals, char *indent, char *reg, char *until)
+{
+    // reads register reg until the condition on rdata holds
+    fprintf(txt, "%sbfm.read1(%d << BW_BITS, rdata); \n", indent, register_index(signals, reg));
+    fprintf(txt, "%swhile (!(%s)) bfm.read1(%d << BW_BITS, rdata); \n", indent, until, register_index(signals, reg));
+}
+
+
+static void print_tb_bench(FILE *txt, signal_struct *signals, char *instance_name, char *bench_name, int timeout)
+{
+    // the bench shared by the testbench and the trace replay: clocks, the bus
+    // functional model on axi_slave_interface, the memory model on the DMA
+    // port, stream drivers, the generated module and a watchdog
+
+    signal_struct *sp;
+    char buf[STRLEN];
+    char *sclk = (options.core_clock) ? "core_clock" : "clock";
+    char *n;
+    int i;
+
+    fprintf(txt, "module %s; \n", bench_name);
+    fprintf(txt, " \n");
+    fprintf(txt, " parameter ELEMENTS = 64;        // elements through each channel, stream and DMA engine, at most 2048 bus words \n");
+    sprintf(buf, "%d;", timeout);
+    fprintf(txt, " parameter TIMEOUT  = %-10s // clock cycles before the run is abandoned \n", buf);
+    fprintf(txt, " \n");
+    fprintf(txt, " localparam BW_BITS    = %d; \n", options.bw_bits);
+    fprintf(txt, " localparam DATA_BITS  = %d; \n", 8 << options.bw_bits);
+    fprintf(txt, " localparam STRB_BITS  = %d; \n", 1 << options.bw_bits);
+    fprintf(txt, " localparam ID_BITS    = %d; \n", options.id_bits);
+    fprintf(txt, " localparam ADDR_BITS  = %d; \n", options.addr_bits);
+    fprintf(txt, " localparam SLAVE_BITS = %d; \n", slave_bits(signals));
+    fprintf(txt, " \n");
+    fprintf(txt, " reg                    clock = 1'b0; \n");
+    fprintf(txt, " reg                    resetn = 1'b0; \n");
+    if (options.core_clock)
+    fprintf(txt, " reg                    core_clock = 1'b0; \n");
+    fprintf(txt, " reg                    stream_run = 1'b0; \n");
+    fprintf(txt, " reg    [DATA_BITS-1:0] rdata; \n");
+    fprintf(txt, " reg    [DATA_BITS-1:0] word; \n");
+    fprintf(txt, " reg    [ 31:0]         value; \n");
+    fprintf(txt, " integer                cycle = 0; \n");
+    fprintf(txt, " integer                errors = 0; \n");
+    fprintf(txt, " integer                first; \n");
+    fprintf(txt, " integer                first_transactions; \n");
+    fprintf(txt, " integer                first_beats; \n");
+    fprintf(txt, " integer                latency; \n");
+    fprintf(txt, " integer                latency_min; \n");
+    fprintf(txt, " integer                latency_max; \n");
+    fprintf(txt, " integer                i; \n");
+    fprintf(txt, " integer                j; \n");
+    fprintf(txt, " integer                beats; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " always #5 clock = !clock; \n");
+    if (options.core_clock)
+    fprintf(txt, " always #7 core_clock = !core_clock; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(posedge clock) cycle <= cycle + 1; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " function [DATA_BITS-1:0] pattern; \n");
+    fprintf(txt, "    input [31:0] index; \n");
+    fprintf(txt, "    pattern = {(DATA_BITS/32) {32'h5a000000 ^ index}}; \n");
+    fprintf(txt, " endfunction \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " task begin_phase; \n");
+    fprintf(txt, "    begin \n");
+    fprintf(txt, "       first = cycle; \n");
+    fprintf(txt, "       first_transactions = bfm.transactions; \n");
+    fprintf(txt, "       first_beats = bfm.beats; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " endtask \n");
+    fprintf(txt, " \n");
+
+    // the slave port and the SRAM side of axi_slave_interface
+    for (i=0; tb_slave_port[i][0]; i++) {
+        fprintf(txt, " wire [%s-1:0] s_%s; \n", tb_slave_port[i][1], tb_slave_port[i][0]);
+    }
+    fprintf(txt, " \n");
+    fprintf(txt, " wire [SLAVE_BITS-1:0] sram_raddr; \n");
+    fprintf(txt, " wire [DATA_BITS-1:0]  sram_rdata; \n");
+    fprintf(txt, " wire                  sram_oe; \n");
+    fprintf(txt, " wire [SLAVE_BITS-1:0] sram_waddr; \n");
+    fprintf(txt, " wire [DATA_BITS-1:0]  sram_wdata; \n");
+    fprintf(txt, " wire [STRB_BITS-1:0]  sram_be; \n");
+    fprintf(txt, " wire                  sram_we; \n");
+    fprintf(txt, " \n");
+    if (has_dma()) {
+        for (i=0; tb_dma_port[i][0]; i++) {
+            fprintf(txt, " wire [%s-1:0] dma_%s; \n", tb_dma_port[i][1], tb_dma_port[i][0]);
+        }
+        fprintf(txt, " \n");
+    }
+
+    fprintf(txt, " axi_master_bfm #(.masters(1), .width(SLAVE_BITS), .id_bits(ID_BITS), .b_size(BW_BITS)) bfm ( \n");
+    fprintf(txt, "    .ACLK        (clock), \n");
+    fprintf(txt, "    .ARESETn     (resetn)");
+    print_tb_port(txt, tb_slave_port, "", "s_");
+    fprintf(txt, " \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " axi_slave_interface #(.masters(1), .width(SLAVE_BITS), .id_bits(ID_BITS), .p_size(BW_BITS), .b_size(BW_BITS), \n");
+    fprintf(txt, "                       .rd_prefetch(%d), .rd_latency(%d)", read_latency(signals) + 2, read_latency(signals));
+    print_slice_params(txt, options.slice);
+    fprintf(txt, ") slave ( \n");
+    fprintf(txt, "    .ACLK        (clock), \n");
+    fprintf(txt, "    .ARESETn     (resetn)");
+    print_tb_port(txt, tb_slave_port, "", "s_");
+    fprintf(txt, ", \n");
+    fprintf(txt, "    .SRAM_READ_ADDRESS      (sram_raddr), \n");
+    fprintf(txt, "    .SRAM_READ_DATA         (sram_rdata), \n");
+    fprintf(txt, "    .SRAM_OUTPUT_ENABLE     (sram_oe), \n");
+    fprintf(txt, "    .SRAM_WRITE_ADDRESS     (sram_waddr), \n");
+    fprintf(txt, "    .SRAM_WRITE_DATA        (sram_wdata), \n");
+    fprintf(txt, "    .SRAM_WRITE_BYTE_ENABLE (sram_be), \n");
+    fprintf(txt, "    .SRAM_WRITE_STROBE      (sram_we) \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    if (has_dma()) {
+        fprintf(txt, " axi_mem_model #(.bw_bits(BW_BITS), .addr_bits(ADDR_BITS), .id_bits(ID_BITS), .words(4096)) dmem ( \n");
+        fprintf(txt, "    .CLK         (clock), \n");
+        fprintf(txt, "    .RESETn      (resetn)");
+        print_tb_port(txt, tb_dma_port, "", "dma_");
+        fprintf(txt, " \n");
+        fprintf(txt, " ); \n");
+        fprintf(txt, " \n");
+    }
+
+    // streams are driven and drained at a beat per cycle while stream_run is set
+    for (sp=signals; sp; sp=sp->next) {
+        int elem;
+        int per_beat;
+
+        if (!sp->is_stream) continue;
+        n = sp->signal_name;
+        elem = 8 * ((sp->width + 7) / 8);
+        per_beat = sp->stream_bits / elem;
+
+        fprintf(txt, " // stream %s, %d element%s per beat \n", n, per_beat, (per_beat == 1) ? "" : "s");
+        fprintf(txt, " \n");
+        fprintf(txt, " %s [%d:0] %s_TDATA; \n", (sp->is_input) ? "reg " : "wire", sp->stream_bits-1, n);
+        fprintf(txt, " wire [%d:0] %s_TKEEP", sp->stream_bits/8-1, n);
+        if (sp->is_input) fprintf(txt, " = {%d {1'b1}}", sp->stream_bits/8);
+        fprintf(txt, "; \n");
+        fprintf(txt, " wire        %s_TLAST%s; \n", n, (sp->is_input) ? " = 1'b0" : "");
+        fprintf(txt, " %s        %s_TVALID%s; \n", (sp->is_input) ? "reg " : "wire", n, (sp->is_input) ? " = 1'b0" : "");
+        fprintf(txt, " %s        %s_TREADY%s; \n", (sp->is_input) ? "wire" : "reg ", n, (sp->is_input) ? "" : " = 1'b0");
+        fprintf(txt, " integer     %s_done = 0;    // elements %s \n", n, (sp->is_input) ? "sent" : "received");
+        fprintf(txt, " integer     %s_last = 0;    // cycle the last of ELEMENTS went \n", n);
+        fprintf(txt, " integer     %s_lane; \n", n);
+        fprintf(txt, " integer     %s_beats; \n", n);
+        fprintf(txt, " \n");
+        if (sp->is_input) {
+            fprintf(txt, " always @(posedge %s) begin \n", sclk);
+            fprintf(txt, "    %s_beats = (%s_TVALID && %s_TREADY) ? %d : 0; \n", n, n, n, per_beat);
+            fprintf(txt, "    %s_done <= %s_done + %s_beats; \n", n, n, n);
+            fprintf(txt, "    if ((%s_done < ELEMENTS) && (%s_done + %s_beats >= ELEMENTS)) %s_last <= cycle; \n", n, n, n, n);
+            fprintf(txt, "    if (stream_run && (%s_done + %s_beats < ELEMENTS)) begin \n", n, n);
+            fprintf(txt, "       %s_TVALID <= 1'b1; \n", n);
+            fprintf(txt, "       for (%s_lane=0; %s_lane<%d; %s_lane=%s_lane+1) begin \n", n, n, per_beat, n, n);
+            fprintf(txt, "          %s_TDATA[%s_lane * %d +: %d] <= %s_done + %s_beats + %s_lane; \n", n, n, elem, elem, n, n, n);
+            fprintf(txt, "       end \n");
+            fprintf(txt, "    end else begin \n");
+            fprintf(txt, "       %s_TVALID <= 1'b0; \n", n);
+            fprintf(txt, "    end \n");
+            fprintf(txt, " end \n");
+        } else {
+            fprintf(txt, " integer     %s_bad = 0; \n", n);
+            fprintf(txt, " reg  [31:0] %s_want; \n", n);
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge %s) begin \n", sclk);
+            fprintf(txt, "    %s_beats = 0; \n", n);
+            fprintf(txt, "    if (%s_TVALID && %s_TREADY) begin \n", n, n);
+            fprintf(txt, "       for (%s_lane=0; %s_lane<%d; %s_lane=%s_lane+1) begin \n", n, n, per_beat, n, n);
+            fprintf(txt, "          if (%s_TKEEP[%s_lane * %d]) begin \n", n, n, elem / 8);
+            fprintf(txt, "             %s_want = %s_done + %s_beats; \n", n, n, n);
+            fprintf(txt, "             if (%s_TDATA[%s_lane * %d +: %d] != %s_want%s) %s_bad = %s_bad + 1; \n",
+                         n, n, elem, sp->width, n, tb_slice(sp->width, buf), n, n);
+            fprintf(txt, "             %s_beats = %s_beats + 1; \n", n, n);
+            fprintf(txt, "          end \n");
+            fprintf(txt, "       end \n");
+            fprintf(txt, "    end \n");
+            fprintf(txt, "    %s_done <= %s_done + %s_beats; \n", n, n, n);
+            fprintf(txt, "    if ((%s_done < ELEMENTS) && (%s_done + %s_beats >= ELEMENTS)) %s_last <= cycle; \n", n, n, n, n);
+            fprintf(txt, "    %s_TREADY <= stream_run && (%s_done + %s_beats < ELEMENTS); \n", n, n, n);
+            fprintf(txt, " end \n");
+        }
+        fprintf(txt, " \n");
+    }
+
+    fprintf(txt, " cat_accel_%s dut ( \n", instance_name);
+    fprintf(txt, "    .clock       (clock), \n");
+    fprintf(txt, "    .resetn      (resetn), \n");
+    if (options.core_clock)
+    fprintf(txt, "    .core_clock  (core_clock), \n");
+    fprintf(txt, "    .read_addr   (sram_raddr[SLAVE_BITS-1:BW_BITS]), \n");
+    fprintf(txt, "    .read_data   (sram_rdata), \n");
+    fprintf(txt, "    .oe          (sram_oe), \n");
+    fprintf(txt, "    .write_addr  (sram_waddr[SLAVE_BITS-1:BW_BITS]), \n");
+    fprintf(txt, "    .write_data  (sram_wdata), \n");
+    fprintf(txt, "    .be          (sram_be), \n");
+    fprintf(txt, "    .we          (sram_we)");
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream) {
+            fprintf(txt, ", \n");
+            fprintf(txt, "    .%s_TDATA (%s_TDATA), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TKEEP (%s_TKEEP), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TLAST (%s_TLAST), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TVALID (%s_TVALID), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TREADY (%s_TREADY)", sp->signal_name, sp->signal_name);
+        }
+    }
+    if (has_master(signals)) {
+        // the stand-in never uses the master port, it only needs its inputs tied
+        fprintf(txt, ", \n");
+        fprintf(txt, "    .AWREADY     (1'b1), \n");
+        fprintf(txt, "    .WREADY      (1'b1), \n");
+        fprintf(txt, "    .BID         ({ID_BITS {1'b0}}), \n");
+        fprintf(txt, "    .BRESP       (2'b00), \n");
+        if (options.buser_bits)
+        fprintf(txt, "    .BUSER       ({%d {1'b0}}), \n", options.buser_bits);
+        fprintf(txt, "    .BVALID      (1'b0), \n");
+        fprintf(txt, "    .ARREADY     (1'b1), \n");
+        fprintf(txt, "    .RID         ({ID_BITS {1'b0}}), \n");
+        fprintf(txt, "    .RDATA       ({DATA_BITS {1'b0}}), \n");
+        fprintf(txt, "    .RRESP       (2'b00), \n");
+        if (options.ruser_bits)
+        fprintf(txt, "    .RUSER       ({%d {1'b0}}), \n", options.ruser_bits);
+        fprintf(txt, "    .RLAST       (1'b0), \n");
+        fprintf(txt, "    .RVALID      (1'b0)");
+    }
+    if (has_dma()) print_tb_port(txt, tb_dma_port, "DMA_", "dma_");
+    fprintf(txt, " \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+
+    fprintf(txt, " initial begin \n");
+    fprintf(txt, "    repeat (TIMEOUT) @(posedge clock); \n");
+    fprintf(txt, "    $display(\"FAIL: no result after %%0d cycles\", TIMEOUT); \n");
+    fprintf(txt, "    $finish; \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+}
+
+
+static void print_testbench(FILE *txt, signal_struct *signals, char *instance_name, char *module_name)
+{
+    signal_struct *sp;
+    signal_struct *go = tb_go(signals);
+    char buf[NAMELEN];
+    char name[NAMELEN];
+    char upper[STRLEN];
+    char stub[STRLEN];
+    char *n;
+    int count = register_count(signals);
+    int window = memory_window_bits(signals);
+    int max_burst = ((4096 >> options.bw_bits) < 256) ? (4096 >> options.bw_bits) : 256;
+    int streams = 0;
+    int total;
+    int region;
+    int depth;
+    int start;
+    int i;
+    int *tested;
+
+    sprintf(stub, "dut.%s", module_name);
+
+    // registers that only the host writes and nothing else changes: the
+    // input wires and the master configuration
+    tested = (int *) calloc(count, sizeof(int));
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_wire && sp->is_input) tested[register_index(signals, uppercase(sp->signal_name, buf))] = 1;
+        if (sp->is_stream) streams++;
+    }
+    if (has_master(signals)) {
+        tested[register_index(signals, "ADDR_OFFSET_LOW")] = 1;
+        tested[register_index(signals, "ADDR_OFFSET_HIGH")] = 1;
+        tested[register_index(signals, "BURST_SIZE")] = 1;
+    }
+    if (options.scatter_gather) {
+        tested[register_index(signals, "SG_LIST_LOW")] = 1;
+        tested[register_index(signals, "SG_LIST_HIGH")] = 1;
+    }
+
+    fprintf(txt, "`timescale 1ns/1ns \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "// self-checking throughput testbench for cat_accel_%s, written by if_gen_axi. \n", instance_name);
+    fprintf(txt, "// An AXI master bus functional model drives the register bank through \n");
+    fprintf(txt, "// axi_slave_interface at the full rate of the bus, streams are driven and \n");
+    fprintf(txt, "// drained a beat per cycle and the DMA port runs into a memory model.  Each \n");
+    fprintf(txt, "// phase reports elements and bus transactions per clock cycle, and the GO \n");
+    fprintf(txt, "// to DONE latency is measured through the registers.  The run ends with \n");
+    fprintf(txt, "// PASS or FAIL. \n");
+    fprintf(txt, "// \n");
+    fprintf(txt, "//   iverilog -g2012 -I ../verilog -o %s_tb %s_tb.v %s.v ../verilog/*.sv \n", module_name, module_name, module_name);
+    fprintf(txt, "//   verilator --binary --timing -Wno-fatal -I../verilog --top-module %s_tb %s_tb.v %s.v ../verilog/*.sv \n",
+                 module_name, module_name, module_name);
+    fprintf(txt, " \n");
+
+    print_tb_stub(txt, signals, instance_name);
+
+    sprintf(buf, "%s_tb", module_name);
+    print_tb_bench(txt, signals, instance_name, buf, 1000000);
+    fprintf(txt, " initial begin \n");
+    fprintf(txt, "    repeat (8) @(posedge clock); \n");
+    fprintf(txt, "    resetn <= 1'b1; \n");
+    fprintf(txt, "    repeat (8) @(posedge clock); \n");
+
+    // register bank: runs of host written registers in bursts, read back
+    total = 0;
+    for (i=0; i<count; i++) total += tested[i];
+    if (total) {
+        fprintf(txt, " \n");
+        fprintf(txt, "    // register bank, written in bursts and read back \n");
+        fprintf(txt, " \n");
+        fprintf(txt, "    begin_phase; \n");
+        for (i=0; i<2; i++) {
+            for (start=0; start<count; start++) {
+                int length = 0;
+
+                if (!tested[start]) continue;
+                while ((start + length < count) && tested[start + length] && (length < max_burst) &&
+                       ((length == 0) || ((start + length) % max_burst))) length++;
+                if (i == 0) {
+                    fprintf(txt, "    for (j=0; j<%d; j=j+1) bfm.wbuf[j] = pattern(%d + j); \n", length, start);
+                    fprintf(txt, "    bfm.write(%d << BW_BITS, %d); \n", start, length);
+                } else {
+                    fprintf(txt, "    bfm.read(%d << BW_BITS, %d); \n", start, length);
+                    fprintf(txt, "    for (j=0; j<%d; j=j+1) begin \n", length);
+                    fprintf(txt, "       if (bfm.rbuf[j] != pattern(%d + j)) begin \n", start);
+                    fprintf(txt, "          $display(\"ERROR: register %%0d read %%h\", %d + j, bfm.rbuf[j]); \n", start);
+                    fprintf(txt, "          errors = errors + 1; \n");
+                    fprintf(txt, "       end \n");
+                    fprintf(txt, "    end \n");
+                }
+                start += length - 1;
+            }
+        }
+        sprintf(buf, "%d", 2 * total);
+        print_tb_report(txt, "register bank", buf, "cycle", 1);
+
+        // single beat accesses, as control code makes them
+        for (start=0; !tested[start]; start++);
+        fprintf(txt, "    first = cycle; \n");
+        fprintf(txt, "    bfm.write1(%d << BW_BITS, pattern(%d)); \n", start, start);
+        fprintf(txt, "    latency = cycle - first; \n");
+        fprintf(txt, "    first = cycle; \n");
+        fprintf(txt, "    bfm.read1(%d << BW_BITS, rdata); \n", start);
+        fprintf(txt, "    $display(\"register access: write %%0d cycles to BVALID, read %%0d cycles to RVALID\", latency, cycle - first); \n");
+    }
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_wire && !sp->is_input) {
+            fprintf(txt, "    bfm.read1(%d << BW_BITS, rdata); \n", register_index(signals, uppercase(sp->signal_name, buf)));
+            fprintf(txt, "    if (rdata != %s) begin \n", tb_pattern(sp->width, buf));
+            fprintf(txt, "       $display(\"ERROR: %s read %%h\", rdata); \n", sp->signal_name);
+            fprintf(txt, "       errors = errors + 1; \n");
+            fprintf(txt, "    end \n");
+        }
+    }
+
+    if (options.cores) {
+        // one job per slot, each core taking a ticket and waiting to be
+        // served as ACCEL_LOCK does, then SUBMIT_JOB.  When the slots feed
+        // go the job is timed to DONE.
+        int jobs_go = go && (0 == strcmp(options.job_channel, "go"));
+
+        fprintf(txt, " \n");
+        fprintf(txt, "    // job slots%s \n", (jobs_go) ? ", from the write of a SLOT to the read of DONE" : "");
+        fprintf(txt, " \n");
+        fprintf(txt, "    for (i=0; i<%d; i=i+1) begin \n", options.cores);
+        fprintf(txt, "       bfm.read1(%d << BW_BITS, rdata); \n", register_index(signals, "TICKET"));
+        fprintf(txt, "       if (rdata != i) begin \n");
+        fprintf(txt, "          $display(\"ERROR: ticket %%0d read %%h\", i, rdata); \n");
+        fprintf(txt, "          errors = errors + 1; \n");
+        fprintf(txt, "       end \n");
+        print_tb_poll(txt, signals, "       ", "SERVING", "rdata == i");
+        print_tb_poll(txt, signals, "       ", "SLOT_PENDING", "!rdata[i]");
+        if (jobs_go) fprintf(txt, "       first = cycle; \n");
+        fprintf(txt, "       bfm.write1((%d + i) << BW_BITS, i); \n", register_index(signals, "SLOT_0"));
+        fprintf(txt, "       bfm.write1(%d << BW_BITS, 1); \n", register_index(signals, "SERVING"));
+        if (jobs_go) {
+            print_tb_poll(txt, signals, "       ", "DONE_VALID", "rdata[0]");
+            fprintf(txt, "       bfm.read1(%d << BW_BITS, rdata); \n", register_index(signals, "DONE"));
+            fprintf(txt, "       latency = cycle - first; \n");
+            fprintf(txt, "       if (rdata != (i & {%d {1'b1}})) begin \n", find_signal(signals, "done")->width);
+            fprintf(txt, "          $display(\"ERROR: done %%0d read %%h\", i, rdata); \n");
+            fprintf(txt, "          errors = errors + 1; \n");
+            fprintf(txt, "       end \n");
+            fprintf(txt, "       if ((i == 0) || (latency < latency_min)) latency_min = latency; \n");
+            fprintf(txt, "       if ((i == 0) || (latency > latency_max)) latency_max = latency; \n");
+        }
+        fprintf(txt, "    end \n");
+        if (jobs_go) {
+            fprintf(txt, "    $display(\"job slot to done: %%0d to %%0d cycles over %d jobs\", latency_min, latency_max); \n", options.cores);
+        } else {
+            fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+            fprintf(txt, "    repeat (32) @(posedge clock); \n");
+            fprintf(txt, "    if (%s.%s_count != %d) begin \n", stub, options.job_channel, options.cores);
+            fprintf(txt, "       $display(\"ERROR: %s took %%0d jobs\", %s.%s_count); \n", options.job_channel, stub, options.job_channel);
+            fprintf(txt, "       errors = errors + 1; \n");
+            fprintf(txt, "    end \n");
+            fprintf(txt, "`endif \n");
+        }
+    }
+
+    if (go && !(options.cores && (0 == strcmp(options.job_channel, "go")))) {
+        fprintf(txt, " \n");
+        fprintf(txt, "    // GO to DONE, from the write of GO to the read of DONE \n");
+        fprintf(txt, " \n");
+        fprintf(txt, "    for (i=0; i<4; i=i+1) begin \n");
+        print_tb_poll(txt, signals, "       ", "GO_READY", "rdata[0]");
+        fprintf(txt, "       first = cycle; \n");
+        fprintf(txt, "       bfm.write1(%d << BW_BITS, i); \n", register_index(signals, "GO"));
+        print_tb_poll(txt, signals, "       ", "DONE_VALID", "rdata[0]");
+        fprintf(txt, "       bfm.read1(%d << BW_BITS, rdata); \n", register_index(signals, "DONE"));
+        fprintf(txt, "       latency = cycle - first; \n");
+        fprintf(txt, "       if (rdata != (i & {%d {1'b1}})) begin \n", find_signal(signals, "done")->width);
+        fprintf(txt, "          $display(\"ERROR: done %%0d read %%h\", i, rdata); \n");
+        fprintf(txt, "          errors = errors + 1; \n");
+        fprintf(txt, "       end \n");
+        fprintf(txt, "       if ((i == 0) || (latency < latency_min)) latency_min = latency; \n");
+        fprintf(txt, "       if ((i == 0) || (latency > latency_max)) latency_max = latency; \n");
+        fprintf(txt, "    end \n");
+        fprintf(txt, "    $display(\"go to done: %%0d to %%0d cycles over 4 runs\", latency_min, latency_max); \n");
+    }
+
+    // channels through their registers as the header macros do it, polling
+    // READY before each write and VALID before each read
+    for (sp=signals; sp; sp=sp->next) {
+        if (!sp->is_channel) continue;
+        if (go && ((sp == go) || (0 == strcmp(sp->signal_name, "done")))) continue;
+        if ((0 == strcmp(sp->signal_name, options.dma_in)) || (0 == strcmp(sp->signal_name, options.dma_out))) continue;
+        if (options.cores && (0 == strcmp(sp->signal_name, options.job_channel))) continue;   // fed from the job slots
+
+        n = uppercase(sp->signal_name, upper);
+        fprintf(txt, " \n");
+        fprintf(txt, "    // %s channel %s \n", (sp->is_input) ? "input" : "output", sp->signal_name);
+        fprintf(txt, " \n");
+        fprintf(txt, "    begin_phase; \n");
+        fprintf(txt, "    for (i=0; i<ELEMENTS; i=i+1) begin \n");
+        if (sp->is_input) {
+            snprintf(buf, sizeof(buf), "%s_READY", n);
+            print_tb_poll(txt, signals, "       ", buf, "rdata[0]");
+            fprintf(txt, "       bfm.write1(%d << BW_BITS, i); \n", register_index(signals, n));
+        } else {
+            snprintf(buf, sizeof(buf), "%s_VALID", n);
+            print_tb_poll(txt, signals, "       ", buf, "rdata[0]");
+            fprintf(txt, "       bfm.read1(%d << BW_BITS, rdata); \n", register_index(signals, n));
+            fprintf(txt, "       if (rdata != (i & {%d {1'b1}})) begin \n", sp->width);
+            fprintf(txt, "          $display(\"ERROR: %s %%0d read %%h\", i, rdata); \n", sp->signal_name);
+            fprintf(txt, "          errors = errors + 1; \n");
+            fprintf(txt, "       end \n");
+        }
+        fprintf(txt, "    end \n");
+        print_tb_report(txt, sp->signal_name, "ELEMENTS", "cycle", 1);
+        if (sp->is_input) {
+            fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+            fprintf(txt, "    repeat (32) @(posedge clock); \n");
+            fprintf(txt, "    if (%s.%s_count != ELEMENTS) begin \n", stub, sp->signal_name);
+            fprintf(txt, "       $display(\"ERROR: %s took %%0d elements\", %s.%s_count); \n", sp->signal_name, stub, sp->signal_name);
+            fprintf(txt, "       errors = errors + 1; \n");
+            fprintf(txt, "    end \n");
+            fprintf(txt, "`endif \n");
+        }
+    }
+
+    // memories in bursts over the slave, up to 4096 words each
+    region = 0;
+    for (sp=signals; sp; sp=sp->next) {
+        if (!sp->is_memory) continue;
+        region++;
+        depth = (sp->depth < 4096) ? sp->depth : 4096;
+
+        fprintf(txt, " \n");
+        fprintf(txt, "    // %s memory %s, %d words \n", (sp->is_input) ? "input" : "output", sp->signal_name, depth);
+        fprintf(txt, " \n");
+        if (sp->is_input) {
+            fprintf(txt, "    begin_phase; \n");
+            fprintf(txt, "    for (i=0; i<%d; i=i+%d) begin \n", depth, max_burst);
+            fprintf(txt, "       beats = (%d - i < %d) ? %d - i : %d; \n", depth, max_burst, depth, max_burst);
+            fprintf(txt, "       for (j=0; j<beats; j=j+1) bfm.wbuf[j] = pattern(i + j); \n");
+            fprintf(txt, "       bfm.write(%d + (i << BW_BITS), beats); \n", (region << window) << options.bw_bits);
+            fprintf(txt, "    end \n");
+            sprintf(buf, "%d", depth);
+            snprintf(name, sizeof(name), "%s written", sp->signal_name);
+            print_tb_report(txt, name, buf, "cycle", 1);
+        } else {
+            fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+            fprintf(txt, "    while (%s.%s_fill < %d) @(posedge clock); \n", stub, sp->signal_name, depth);
+            fprintf(txt, "`endif \n");
+        }
+        fprintf(txt, "    begin_phase; \n");
+        fprintf(txt, "    for (i=0; i<%d; i=i+%d) begin \n", depth, max_burst);
+        fprintf(txt, "       beats = (%d - i < %d) ? %d - i : %d; \n", depth, max_burst, depth, max_burst);
+        fprintf(txt, "       bfm.read(%d + (i << BW_BITS), beats); \n", (region << window) << options.bw_bits);
+        fprintf(txt, "       for (j=0; j<beats; j=j+1) begin \n");
+        if (sp->is_input) fprintf(txt, "          word = pattern(i + j) & {%d {1'b1}}; \n", sp->width);
+        else              fprintf(txt, "          word = (i + j) & {%d {1'b1}}; \n", sp->width);
+        fprintf(txt, "          if (bfm.rbuf[j] != word) begin \n");
+        fprintf(txt, "             $display(\"ERROR: %s word %%0d read %%h\", i + j, bfm.rbuf[j]); \n", sp->signal_name);
+        fprintf(txt, "             errors = errors + 1; \n");
+        fprintf(txt, "          end \n");
+        fprintf(txt, "       end \n");
+        fprintf(txt, "    end \n");
+        sprintf(buf, "%d", depth);
+        snprintf(name, sizeof(name), "%s read", sp->signal_name);
+        print_tb_report(txt, name, buf, "cycle", 1);
+    }
+
+    if (streams) {
+        fprintf(txt, " \n");
+        fprintf(txt, "    // streams, all at once \n");
+        fprintf(txt, " \n");
+        fprintf(txt, "    begin_phase; \n");
+        fprintf(txt, "    stream_run = 1'b1; \n");
+        fprintf(txt, "    while (!(1");
+        for (sp=signals; sp; sp=sp->next) {
+            if (sp->is_stream) fprintf(txt, " && (%s_done >= ELEMENTS)", sp->signal_name);
+        }
+        fprintf(txt, ")) @(posedge clock); \n");
+        fprintf(txt, "    stream_run = 1'b0; \n");
+        for (sp=signals; sp; sp=sp->next) {
+            if (!sp->is_stream) continue;
+            snprintf(buf, sizeof(buf), "%s_last", sp->signal_name);
+            print_tb_report(txt, sp->signal_name, "ELEMENTS", buf, 0);
+        }
+        fprintf(txt, "    repeat (32) @(posedge clock); \n");
+        for (sp=signals; sp; sp=sp->next) {
+            if (!sp->is_stream) continue;
+            if (sp->is_input) {
+                fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+                fprintf(txt, "    if (%s.%s_count != %s_done) begin \n", stub, sp->signal_name, sp->signal_name);
+                fprintf(txt, "       $display(\"ERROR: %s took %%0d of %%0d elements\", %s.%s_count, %s_done); \n",
+                             sp->signal_name, stub, sp->signal_name, sp->signal_name);
+                fprintf(txt, "       errors = errors + 1; \n");
+                fprintf(txt, "    end \n");
+                fprintf(txt, "`endif \n");
+            } else {
+                fprintf(txt, "    if (%s_bad != 0) begin \n", sp->signal_name);
+                fprintf(txt, "       $display(\"ERROR: %s received %%0d wrong elements\", %s_bad); \n", sp->signal_name, sp->signal_name);
+                fprintf(txt, "       errors = errors + %s_bad; \n", sp->signal_name);
+                fprintf(txt, "    end \n");
+            }
+        }
+    }
+
+    // DMA engines: dma_in reads elements packed from address 0 of the memory
+    // model, dma_out writes them from word 2048
+    for (i=0; i<2; i++) {
+        char *e = (i == 0) ? "RD" : "WR";
+        int elem;
+        int per_word;
+        int base = (i == 0) ? 0 : 2048;
+
+        sp = find_signal(signals, (i == 0) ? options.dma_in : options.dma_out);
+        if (!sp) continue;
+        elem = dma_elem_bits(sp);
+        per_word = (8 << options.bw_bits) / elem;
+
+        fprintf(txt, " \n");
+        fprintf(txt, "    // DMA %s %s \n", (i == 0) ? "into" : "out of", sp->signal_name);
+        fprintf(txt, " \n");
+        if (i == 0) {
+            fprintf(txt, "    for (i=0; i<ELEMENTS; i=i+1) begin \n");
+            fprintf(txt, "       word = dmem.mem[i / %d]; \n", per_word);
+            fprintf(txt, "       word[(i %% %d) * %d +: %d] = i; \n", per_word, elem, elem);
+            fprintf(txt, "       dmem.mem[i / %d] = word; \n", per_word);
+            fprintf(txt, "    end \n");
+        }
+        fprintf(txt, "    begin_phase; \n");
+        sprintf(buf, "DMA_%s_ADDR_LOW", e);
+        fprintf(txt, "    bfm.write1(%d << BW_BITS, %d << BW_BITS); \n", register_index(signals, buf), base);
+        sprintf(buf, "DMA_%s_ADDR_HIGH", e);
+        fprintf(txt, "    bfm.write1(%d << BW_BITS, 0); \n", register_index(signals, buf));
+        sprintf(buf, "DMA_%s_COUNT", e);
+        fprintf(txt, "    bfm.write1(%d << BW_BITS, ELEMENTS); \n", register_index(signals, buf));
+        sprintf(buf, "DMA_%s_STATUS", e);
+        print_tb_poll(txt, signals, "    ", buf, "rdata[1:0] == 0");
+        snprintf(name, sizeof(name), "dma %s", sp->signal_name);
+        print_tb_report(txt, name, "ELEMENTS", "cycle", 1);
+        fprintf(txt, "    if (rdata[2]) begin \n");
+        fprintf(txt, "       $display(\"ERROR: DMA_%s_STATUS %%h\", rdata); \n", e);
+        fprintf(txt, "       errors = errors + 1; \n");
+        fprintf(txt, "    end \n");
+        if (i == 0) {
+            fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+            fprintf(txt, "    repeat (32) @(posedge clock); \n");
+            fprintf(txt, "    if (%s.%s_count != ELEMENTS) begin \n", stub, sp->signal_name);
+            fprintf(txt, "       $display(\"ERROR: %s took %%0d elements\", %s.%s_count); \n", sp->signal_name, stub, sp->signal_name);
+            fprintf(txt, "       errors = errors + 1; \n");
+            fprintf(txt, "    end \n");
+            fprintf(txt, "`endif \n");
+        } else {
+            fprintf(txt, "    for (i=0; i<ELEMENTS; i=i+1) begin \n");
+            fprintf(txt, "       word = dmem.mem[%d + i / %d]; \n", base, per_word);
+            fprintf(txt, "       value = i; \n");
+            fprintf(txt, "       if (word[(i %% %d) * %d +: %d] != value%s) begin \n", per_word, elem, sp->width, tb_slice(sp->width, buf));
+            fprintf(txt, "          $display(\"ERROR: %s element %%0d wrote %%h\", i, word); \n", sp->signal_name);
+            fprintf(txt, "          errors = errors + 1; \n");
+            fprintf(txt, "       end \n");
+            fprintf(txt, "    end \n");
+        }
+    }
+
+    fprintf(txt, " \n");
+    fprintf(txt, "`ifndef TB_CATAPULT_RTL \n");
+    for (sp=signals; sp; sp=sp->next) {
+        if ((sp->is_channel || sp->is_stream) && sp->is_input) {
+            fprintf(txt, "    if (%s.%s_errors != 0) begin \n", stub, sp->signal_name);
+            fprintf(txt, "       $display(\"ERROR: %s took %%0d wrong elements\", %s.%s_errors); \n", sp->signal_name, stub, sp->signal_name);
+            fprintf(txt, "       errors = errors + %s.%s_errors; \n", stub, sp->signal_name);
+            fprintf(txt, "    end \n");
+        }
+    }
+    fprintf(txt, "`endif \n");
+    fprintf(txt, "    errors = errors + bfm.errors; \n");
+    fprintf(txt, "    $display(\"total: %%0d cycles, %%0.3f transactions and %%0.3f beats per cycle\", \n");
+    fprintf(txt, "             bfm.cycles, 1.0 * bfm.transactions / bfm.cycles, 1.0 * bfm.beats / bfm.cycles); \n");
+    fprintf(txt, "    if (errors == 0) $display(\"PASS\"); \n");
+    fprintf(txt, "    else $display(\"FAIL: %%0d errors\", errors); \n");
+    fprintf(txt, "    $finish; \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "endmodule \n");
+
+    free(tested);
+}
+
+
+static void print_replay(FILE *txt, signal_struct *signals, char *instance_name, char *module_name)
+{
+    // replays an ACCEL_TRACE capture through the bench of the testbench.
+    // Each access is issued as long after the one before as it was in the
+    // trace, or as soon as the bus allows when the RTL is slower.  A run of
+    // reads of one register is a poll and is repeated until it reads the
+    // value the run ended on, whatever the number of reads it takes here.
+
+    signal_struct *sp;
+    char buf[STRLEN];
+    char name[NAMELEN];
+    int count = register_count(signals);
+    int i;
+
+    fprintf(txt, "`timescale 1ns/1ns \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "// replay of a register access trace against cat_accel_%s, written by \n", instance_name);
+    fprintf(txt, "// if_gen_axi.  The trace is what accel_trace_save() writes from a driver \n");
+    fprintf(txt, "// built with ACCEL_TRACE.  Accesses go out through the AXI master bus \n");
+    fprintf(txt, "// functional model with the gaps between them the trace shows, and the run \n");
+    fprintf(txt, "// reports the latency of each access, the reads and cycles spent polling \n");
+    fprintf(txt, "// and how busy the bus was, per register. \n");
+    fprintf(txt, "// \n");
+    fprintf(txt, "//   iverilog -g2012 -I ../verilog -o %s_replay %s_replay.v %s.v ../verilog/*.sv \n", module_name, module_name, module_name);
+    fprintf(txt, "//   vvp %s_replay +trace=<trace file> \n", module_name);
+    fprintf(txt, " \n");
+
+    print_tb_stub(txt, signals, instance_name);
+
+    sprintf(buf, "%s_replay", module_name);
+    print_tb_bench(txt, signals, instance_name, buf, 100000000);
+
+    fprintf(txt, " parameter TRACE_FILE      = \"accel.trace\";   // unless given by +trace= \n");
+    fprintf(txt, " parameter MAX_RECORDS     = 65536; \n");
+    fprintf(txt, " parameter TICKS_PER_CYCLE = 10;          // trace time per bus clock, ACCEL_TRACE_TIME() in ns at 100MHz \n");
+    fprintf(txt, " parameter MAX_GAP         = 100000;      // longest gap between accesses replayed, in cycles \n");
+    fprintf(txt, " parameter MAX_POLLS       = 100000;      // reads before a poll is given up \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " localparam REGISTERS = %d; \n", count);
+    fprintf(txt, " \n");
+    fprintf(txt, " reg    [7:0]           trace_bytes[0:16+12*MAX_RECORDS-1]; \n");
+    fprintf(txt, " reg    [8*256-1:0]     trace_name; \n");
+    fprintf(txt, " reg    [ 31:0]         t; \n");
+    fprintf(txt, " reg    [ 31:0]         prev_time; \n");
+    fprintf(txt, " reg    [ 31:0]         access_reg; \n");
+    fprintf(txt, " reg    [ 31:0]         mask; \n");
+    fprintf(txt, " reg                    replaying = 1'b0; \n");
+    fprintf(txt, " integer                fd; \n");
+    fprintf(txt, " integer                size; \n");
+    fprintf(txt, " integer                records; \n");
+    fprintf(txt, " integer                k; \n");
+    fprintf(txt, " integer                last; \n");
+    fprintf(txt, " integer                slot; \n");
+    fprintf(txt, " integer                gap; \n");
+    fprintf(txt, " integer                polls; \n");
+    fprintf(txt, " integer                poll_start; \n");
+    fprintf(txt, " integer                prev_cycle; \n");
+    fprintf(txt, " integer                idle = 0;         // cycles waited to keep the traced gaps \n");
+    fprintf(txt, " integer                behind = 0;       // cycles accesses went out later than the trace had them \n");
+    fprintf(txt, " integer                differ = 0;       // single reads that did not return the traced value \n");
+    fprintf(txt, " integer                given_up = 0; \n");
+    fprintf(txt, " integer                replay_cycles = 0; \n");
+    fprintf(txt, " integer                busy = 0;         // cycles with a valid on any channel of the slave port \n");
+    fprintf(txt, " integer                reads[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                writes[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                latency_total[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                latency_max[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                poll_runs[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                trace_polls[0:REGISTERS-1]; \n");
+    fprintf(txt, " integer                stall[0:REGISTERS-1]; \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " function [31:0] le32; \n");
+    fprintf(txt, "    input integer a; \n");
+    fprintf(txt, "    le32 = {trace_bytes[a+3], trace_bytes[a+2], trace_bytes[a+1], trace_bytes[a]}; \n");
+    fprintf(txt, " endfunction \n");
+    fprintf(txt, " \n");
+
+    // flags polled for one bit, DMA status for its active and queued bits
+    fprintf(txt, " function [31:0] poll_mask; \n");
+    fprintf(txt, "    input integer r; \n");
+    fprintf(txt, "    case (r) \n");
+    for (sp=signals; sp; sp=sp->next) {
+        if (!sp->is_channel) continue;
+        snprintf(name, sizeof(name), "%s_%s", uppercase(sp->signal_name, buf), (sp->is_input) ? "READY" : "VALID");
+        fprintf(txt, "       %d: poll_mask = 32'h00000001; \n", register_index(signals, name));
     }
-    fprintf(txt, "\n\n\n");
-    fprintf(txt, "// convenience macros \n\n");
+    if (options.dma_in[0])  fprintf(txt, "       %d: poll_mask = 32'h00000003; \n", register_index(signals, "DMA_RD_STATUS"));
+    if (options.dma_out[0]) fprintf(txt, "       %d: poll_mask = 32'h00000003; \n", register_index(signals, "DMA_WR_STATUS"));
+    fprintf(txt, "       default: poll_mask = 32'hffffffff; \n");
+    fprintf(txt, "    endcase \n");
+    fprintf(txt, " endfunction \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " task access; \n");
+    fprintf(txt, "    input integer    r; \n");
+    fprintf(txt, "    input            is_write; \n");
+    fprintf(txt, "    input [31:0]     v; \n");
+    fprintf(txt, "    integer          start; \n");
+    fprintf(txt, "    begin \n");
+    fprintf(txt, "       start = cycle; \n");
+    fprintf(txt, "       if (is_write) bfm.write1(r << BW_BITS, v); \n");
+    fprintf(txt, "       else bfm.read1(r << BW_BITS, rdata); \n");
+    fprintf(txt, "       if (r < REGISTERS) begin \n");
+    fprintf(txt, "          if (is_write) writes[r] = writes[r] + 1; \n");
+    fprintf(txt, "          else reads[r] = reads[r] + 1; \n");
+    fprintf(txt, "          latency_total[r] = latency_total[r] + cycle - start; \n");
+    fprintf(txt, "          if (cycle - start > latency_max[r]) latency_max[r] = cycle - start; \n");
+    fprintf(txt, "       end \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " endtask \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " always @(posedge clock) begin \n");
+    fprintf(txt, "    if (replaying) begin \n");
+    fprintf(txt, "       replay_cycles <= replay_cycles + 1; \n");
+    fprintf(txt, "       if (s_AWVALID || s_WVALID || s_BVALID || s_ARVALID || s_RVALID) busy <= busy + 1; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " initial begin \n");
+    fprintf(txt, "    for (i=0; i<REGISTERS; i=i+1) begin \n");
+    fprintf(txt, "       reads[i] = 0; \n");
+    fprintf(txt, "       writes[i] = 0; \n");
+    fprintf(txt, "       latency_total[i] = 0; \n");
+    fprintf(txt, "       latency_max[i] = 0; \n");
+    fprintf(txt, "       poll_runs[i] = 0; \n");
+    fprintf(txt, "       trace_polls[i] = 0; \n");
+    fprintf(txt, "       stall[i] = 0; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, "    trace_name = TRACE_FILE; \n");
+    fprintf(txt, "    if ($value$plusargs(\"trace=%%s\", trace_name)) ; \n");
+    fprintf(txt, "    fd = $fopen(trace_name, \"rb\"); \n");
+    fprintf(txt, "    if (fd == 0) begin \n");
+    fprintf(txt, "       $display(\"FAIL: cannot open %%0s\", trace_name); \n");
+    fprintf(txt, "       $finish; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, "    size = $fread(trace_bytes, fd); \n");
+    fprintf(txt, "    $fclose(fd); \n");
+    fprintf(txt, "    if ((size < 16) || (le32(0) != 32'h52544341)) begin \n");
+    fprintf(txt, "       $display(\"FAIL: %%0s is not an ACCEL_TRACE capture\", trace_name); \n");
+    fprintf(txt, "       $finish; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, "    records = le32(4); \n");
+    fprintf(txt, "    if (records > (size - 16) / 12) records = (size - 16) / 12; \n");
+    fprintf(txt, "    $display(\"replaying %%0d accesses from %%0s, %%0d before them lost off the ring\", records, trace_name, le32(8)); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "    repeat (8) @(posedge clock); \n");
+    fprintf(txt, "    resetn <= 1'b1; \n");
+    fprintf(txt, "    repeat (8) @(posedge clock); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "    replaying = 1'b1; \n");
+    fprintf(txt, "    prev_cycle = cycle; \n");
+    fprintf(txt, "    prev_time = le32(16); \n");
+    fprintf(txt, "    k = 0; \n");
+    fprintf(txt, "    while (k < records) begin \n");
+    fprintf(txt, "       t = le32(16 + 12*k); \n");
+    fprintf(txt, "       access_reg = le32(20 + 12*k); \n");
+    fprintf(txt, "       value = le32(24 + 12*k); \n");
+    fprintf(txt, "       slot = access_reg[30:0]; \n");
+    fprintf(txt, "       gap = (t - prev_time) / TICKS_PER_CYCLE; \n");
+    fprintf(txt, "       if ((gap < 0) || (gap > MAX_GAP)) gap = MAX_GAP; \n");
+    fprintf(txt, "       if (cycle < prev_cycle + gap) begin \n");
+    fprintf(txt, "          idle = idle + prev_cycle + gap - cycle; \n");
+    fprintf(txt, "          while (cycle < prev_cycle + gap) @(posedge clock); \n");
+    fprintf(txt, "       end else begin \n");
+    fprintf(txt, "          behind = behind + cycle - prev_cycle - gap; \n");
+    fprintf(txt, "       end \n");
+    fprintf(txt, "       prev_cycle = cycle; \n");
+    fprintf(txt, "       last = k; \n");
+    fprintf(txt, "       if (access_reg[31]) begin \n");
+    fprintf(txt, "          access(slot, 1'b1, value); \n");
+    fprintf(txt, "       end else begin \n");
+    fprintf(txt, "          while ((last + 1 < records) && (le32(20 + 12*(last+1)) == access_reg)) last = last + 1; \n");
+    fprintf(txt, "          poll_start = cycle; \n");
+    fprintf(txt, "          access(slot, 1'b0, 0); \n");
+    fprintf(txt, "          if (last == k) begin \n");
+    fprintf(txt, "             if (rdata[31:0] != value) differ = differ + 1; \n");
+    fprintf(txt, "          end else begin \n");
+    fprintf(txt, "             value = le32(24 + 12*last); \n");
+    fprintf(txt, "             mask = poll_mask(slot); \n");
+    fprintf(txt, "             polls = 1; \n");
+    fprintf(txt, "             while (((rdata[31:0] & mask) != (value & mask)) && (polls < MAX_POLLS)) begin \n");
+    fprintf(txt, "                prev_cycle = cycle; \n");
+    fprintf(txt, "                access(slot, 1'b0, 0); \n");
+    fprintf(txt, "                polls = polls + 1; \n");
+    fprintf(txt, "             end \n");
+    fprintf(txt, "             if (polls == MAX_POLLS) given_up = given_up + 1; \n");
+    fprintf(txt, "             if (slot < REGISTERS) begin \n");
+    fprintf(txt, "                poll_runs[slot] = poll_runs[slot] + 1; \n");
+    fprintf(txt, "                trace_polls[slot] = trace_polls[slot] + last - k + 1; \n");
+    fprintf(txt, "                stall[slot] = stall[slot] + cycle - poll_start; \n");
+    fprintf(txt, "             end \n");
+    fprintf(txt, "             t = le32(16 + 12*last); \n");
+    fprintf(txt, "          end \n");
+    fprintf(txt, "       end \n");
+    fprintf(txt, "       prev_time = t; \n");
+    fprintf(txt, "       k = last + 1; \n");
+    fprintf(txt, "    end \n");
+    fprintf(txt, "    replaying = 1'b0; \n");
+    fprintf(txt, "    @(posedge clock); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "    $display(\"%%0d cycles, bus busy in %%0d (%%0.1f%%%%), %%0d waited to keep the traced gaps, %%0d behind the trace\", \n");
+    fprintf(txt, "             replay_cycles, busy, 100.0 * busy / replay_cycles, idle, behind); \n");
+    fprintf(txt, "    $display(\"%%0d single reads differed from the trace, %%0d polls given up\", differ, given_up); \n");
+    fprintf(txt, "    $display(\"register                          reads   writes  latency      max    polls    reads  (traced)    stall\"); \n");
+    for (i=0; register_name(signals, i, name); i++) {
+        fprintf(txt, "    if (reads[%d] + writes[%d] != 0) \n", i, i);
+        fprintf(txt, "       $display(\"%-30s %%8d %%8d %%8.1f %%8d %%8d %%8d %%8d %%8d\", reads[%d], writes[%d], \n", name, i, i);
+        fprintf(txt, "                1.0 * latency_total[%d] / (reads[%d] + writes[%d]), latency_max[%d], \n", i, i, i, i);
+        fprintf(txt, "                poll_runs[%d], (poll_runs[%d] != 0) ? reads[%d] : 0, trace_polls[%d], stall[%d]); \n", i, i, i, i, i);
+    }
+    fprintf(txt, "    $finish; \n");
+    fprintf(txt, " end \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "endmodule \n");
+}
+
+
+static int check_options(signal_struct *signals)
+{
+    // options that depend on the signals, after the spec and the command
+    // line have both set them
+
+    signal_struct *sp;
+    int ok = 1;
+    int i;
+
+    if (options.dma_in[0]) {
+       sp = find_signal(signals, options.dma_in);
+       if (!sp || !sp->is_channel || !sp->is_input ||
+           (options.cores && (0 == strcmp(options.dma_in, options.job_channel)))) {
+          fprintf(stderr, "dma_in %s is not an input channel other than job_channel \n", options.dma_in);
+          ok = 0;
+       }
+    }
+
+    if (options.dma_out[0]) {
+       sp = find_signal(signals, options.dma_out);
+       if (!sp || !sp->is_channel || sp->is_input) {
+          fprintf(stderr, "dma_out %s is not an output channel \n", options.dma_out);
+          ok = 0;
+       }
+    }
+
+    for (sp=signals; sp; sp=sp->next) {
+       if (((0 == strcmp(sp->signal_name, options.dma_in)) || (0 == strcmp(sp->signal_name, options.dma_out))) &&
+           (dma_elem_bits(sp) > (8 << options.bw_bits))) {
+          fprintf(stderr, "DMA channel %s is wider than data_bits \n", sp->signal_name);
+          ok = 0;
+       }
+    }
+
+    if (options.cores) {
+       sp = find_signal(signals, options.job_channel);
+       if (!sp || !sp->is_channel || !sp->is_input) {
+          fprintf(stderr, "job_channel %s is not an input channel \n", options.job_channel);
+          ok = 0;
+       }
+    }
+
+    for (sp=signals; sp; sp=sp->next) {
+       if (sp->is_memory && (sp->width > (8 << options.bw_bits))) {
+          fprintf(stderr, "memory %s is wider than data_bits \n", sp->signal_name);
+          ok = 0;
+       }
+    }
+
+    if (options.perf_job[0]) {
+       for (i=0; i<options.job.items; i++) {
+          sp = find_signal(signals, options.job.name[i]);
+          if (!sp || !(in_register_bank(sp) || sp->is_memory)) {
+             fprintf(stderr, "%s in %s is not a register, channel or memory \n", options.job.name[i], options.perf_job);
+             ok = 0;
+          }
+       }
+       if (options.job.master_bytes && !has_master(signals)) {
+          fprintf(stderr, "master_bytes in %s without a master port \n", options.perf_job);
+          ok = 0;
+       }
+    }
+
+    if (options.scatter_gather && !has_master(signals)) {
+       fprintf(stderr, "scatter_gather without a master port \n");
+       ok = 0;
+    }
+
+    return ok;
+}
+
+
+static void print_slave_port(FILE *txt, const char *port[][2], char *prefix, char *masters, char *addr_bits, int last)
+{
+   // declarations of an AXI slave port from a table like tb_slave_port,
+   // MASTER signals masters wide when it is set and addresses addr_bits
+
+   char width[STRLEN];
+   const char *name;
+   int output;
+   int i;
+
+   for (i=0; port[i][0]; i++) {
+      name = port[i][0];
+      output = (!strcmp(name, "AWREADY") || !strcmp(name, "WREADY") || !strcmp(name, "ARREADY") ||
+                (((name[0] == 'B') || (name[0] == 'R')) && strcmp(name, "BREADY") && strcmp(name, "RREADY")));
+      if (strstr(name, "MASTER") && masters)  sprintf(width, "[%s-1:0]", masters);
+      else if (!strcmp(port[i][1], "SLAVE_BITS")) sprintf(width, "[%s-1:0]", addr_bits);
+      else if (!strcmp(port[i][1], "1"))      strcpy(width, "");
+      else if (isdigit(port[i][1][0]))       sprintf(width, "[%d:0]", atoi(port[i][1]) - 1);
+      else                                    sprintf(width, "[%s-1:0]", port[i][1]);
+      fprintf(txt, "  %s %-24s %s%s%s \n", output ? "output" : "input ", width, prefix, name,
+              (last && !port[i+1][0]) ? "" : ",");
+   }
+}
+
+
+static void print_top(FILE *txt, signal_struct *signals, char *instance_name, char *module_name)
+{
+    // cat_accel_<instance> behind axi_lite_slave or axi_slave_interface on
+    // an S_* slave port, with every other port of the register bank passed
+    // through under its own name
+
+    signal_struct *sp;
+    int latency = read_latency(signals);
+    int lite = (options.top == 1);
+    int c, f;
+
+    fprintf(txt, "`timescale 1ns/1ns \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "// %s top level of cat_accel_%s, written by if_gen_axi.  The register \n", lite ? "AXI4-Lite" : "AXI4", instance_name);
+    fprintf(txt, "// bank is at offset 0 of the S_* port, behind %s. \n", lite ? "axi_lite_slave" : "axi_slave_interface");
+    fprintf(txt, "// \n");
+    fprintf(txt, "// access latency in clock cycles, the register bank reads in %d: \n", latency);
+    if (lite) {
+        fprintf(txt, "//   read   %d   ARVALID to RVALID, a read taken every cycle \n", latency);
+        fprintf(txt, "//   write  1   AWVALID and WVALID to BVALID, a write taken every cycle \n");
+        fprintf(txt, "// no wait states are added, single beat accesses only. \n");
+    } else {
+        fprintf(txt, "//   bursts of up to 256 beats at a beat per cycle, rd_prefetch %d \n", latency + 2);
+        for (c=0; c<5; c++) {
+            if (options.slice[c] == 1 || options.slice[c] == 3)
+            fprintf(txt, "//   %s %s adds a cycle \n", slice_options[c], slice_modes[options.slice[c]]);
+        }
+        fprintf(txt, "// single beat latency is measured by the testbench (testbench = 1), \n");
+        fprintf(txt, "// the register access line of %s_tb.v. \n", module_name);
+    }
+    fprintf(txt, "// \n");
+    fprintf(txt, "// compile with %s.v and verilog/*.sv \n", module_name);
+    fprintf(txt, " \n");
+    fprintf(txt, "module %s_top \n", module_name);
+    print_defines(txt, signals);
+    fprintf(txt, " ( \n");
+    fprintf(txt, "  input                           clock, \n");
+    fprintf(txt, "  input                           resetn, \n");
+    if (options.core_clock)
+    fprintf(txt, "  input                           core_clock, \n");
+    fprintf(txt, " \n");
+    print_slave_port(txt, lite ? lite_slave_port : tb_slave_port, "S_", NULL, "SLAVE_BITS", 1);
+    print_module_ports(txt, signals);
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " wire [SLAVE_BITS-1:0] sram_raddr; \n");
+    fprintf(txt, " wire [DATA_BITS-1:0]  sram_rdata; \n");
+    fprintf(txt, " wire                  sram_oe; \n");
+    fprintf(txt, " wire [SLAVE_BITS-1:0] sram_waddr; \n");
+    fprintf(txt, " wire [DATA_BITS-1:0]  sram_wdata; \n");
+    fprintf(txt, " wire [STRB_BITS-1:0]  sram_be; \n");
+    fprintf(txt, " wire                  sram_we; \n");
+    fprintf(txt, " \n");
+    if (lite) {
+        fprintf(txt, " axi_lite_slave #(.width(SLAVE_BITS), .b_size(BW_BITS), .rd_latency(%d)) slave ( \n", latency);
+    } else {
+        fprintf(txt, " axi_slave_interface #(.masters(1), .width(SLAVE_BITS), .id_bits(ID_BITS), .p_size(BW_BITS), .b_size(BW_BITS), \n");
+        fprintf(txt, "                       .rd_prefetch(%d), .rd_latency(%d)", latency + 2, latency);
+        print_slice_params(txt, options.slice);
+        fprintf(txt, ") slave ( \n");
+    }
+    fprintf(txt, "    .ACLK        (clock), \n");
+    fprintf(txt, "    .ARESETn     (resetn)");
+    print_tb_port(txt, lite ? lite_slave_port : tb_slave_port, "", "S_");
+    fprintf(txt, ", \n");
+    fprintf(txt, "    .SRAM_READ_ADDRESS      (sram_raddr), \n");
+    fprintf(txt, "    .SRAM_READ_DATA         (sram_rdata), \n");
+    fprintf(txt, "    .SRAM_OUTPUT_ENABLE     (sram_oe), \n");
+    fprintf(txt, "    .SRAM_WRITE_ADDRESS     (sram_waddr), \n");
+    fprintf(txt, "    .SRAM_WRITE_DATA        (sram_wdata), \n");
+    fprintf(txt, "    .SRAM_WRITE_BYTE_ENABLE (sram_be), \n");
+    fprintf(txt, "    .SRAM_WRITE_STROBE      (sram_we) \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, " cat_accel_%s #(.BW_BITS(BW_BITS), .ID_BITS(ID_BITS), .ADDR_BITS(ADDR_BITS), .SLAVE_BITS(SLAVE_BITS)", instance_name);
+    if (options.awuser_bits) fprintf(txt, ", .AWUSER_BITS(AWUSER_BITS)");
+    if (options.wuser_bits)  fprintf(txt, ", .WUSER_BITS(WUSER_BITS)");
+    if (options.buser_bits)  fprintf(txt, ", .BUSER_BITS(BUSER_BITS)");
+    if (options.aruser_bits) fprintf(txt, ", .ARUSER_BITS(ARUSER_BITS)");
+    if (options.ruser_bits)  fprintf(txt, ", .RUSER_BITS(RUSER_BITS)");
+    fprintf(txt, ") accel ( \n");
+    fprintf(txt, "    .clock       (clock), \n");
+    fprintf(txt, "    .resetn      (resetn), \n");
+    if (options.core_clock)
+    fprintf(txt, "    .core_clock  (core_clock), \n");
+    fprintf(txt, "    .read_addr   (sram_raddr[SLAVE_BITS-1:BW_BITS]), \n");
+    fprintf(txt, "    .read_data   (sram_rdata), \n");
+    fprintf(txt, "    .oe          (sram_oe), \n");
+    fprintf(txt, "    .write_addr  (sram_waddr[SLAVE_BITS-1:BW_BITS]), \n");
+    fprintf(txt, "    .write_data  (sram_wdata), \n");
+    fprintf(txt, "    .be          (sram_be), \n");
+    fprintf(txt, "    .we          (sram_we)");
+    for (sp=signals; sp; sp=sp->next) {
+        if (sp->is_stream) {
+            fprintf(txt, ", \n");
+            fprintf(txt, "    .%s_TDATA (%s_TDATA), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TKEEP (%s_TKEEP), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TLAST (%s_TLAST), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TVALID (%s_TVALID), \n", sp->signal_name, sp->signal_name);
+            fprintf(txt, "    .%s_TREADY (%s_TREADY)", sp->signal_name, sp->signal_name);
+        }
+    }
+    if (has_master(signals)) {
+        for (c=0; c<5; c++) {
+            char buf[STRLEN];
+
+            for (f=0; axi_fields[c][f].name; f++) {
+                if (!strcmp(axi_field_width(c, &axi_fields[c][f], buf), "1") && !axi_fields[c][f].width) continue;
+                sprintf(buf, "%s%s", axi_channels[c], axi_fields[c][f].name);
+                fprintf(txt, ", \n    .%-10s (%s)", buf, buf);
+            }
+            sprintf(buf, "%sVALID", axi_channels[c]);
+            fprintf(txt, ", \n    .%-10s (%s)", buf, buf);
+            sprintf(buf, "%sREADY", axi_channels[c]);
+            fprintf(txt, ", \n    .%-10s (%s)", buf, buf);
+        }
+    }
+    if (has_dma()) print_tb_port(txt, tb_dma_port, "DMA_", "DMA_");
+    fprintf(txt, " \n");
+    fprintf(txt, " ); \n");
+    fprintf(txt, " \n");
+    fprintf(txt, "endmodule \n");
+}
+
+
+// analytic model of a generated interface: the cycles the host sees on the
+// slave port, counted from the handshakes of axi_slave_interface with one
+// cycle for each address, data and response transfer, and the flops, RAM
+// bits and read mux inputs the generated module is built from
+
+#define CDC_ROUND_TRIP 6       // cycles for a FIFO entry to cross and its space to come back
+
+enum { PART_BANK, PART_READ, PART_MEMORIES, PART_STREAMS, PART_CROSSING, PART_DMA, PART_SG, PART_SLICES, PARTS };
+
+static const char *part_names[PARTS] = {
+   "register bank", "read path", "memories", "streams", "clock crossing", "DMA engines", "scatter-gather", "slave slices"
+};
+
+typedef struct {
+   int    read_cycles;         // single beat register read, AR to the R beat
+   int    write_cycles;        // single beat register write, AW and W to B
+   double burst_rate;          // bytes per cycle over the register bank in bursts
+   double channel_rate;        // elements per cycle through a register channel, polled
+   double dma_rate;            // elements per cycle through a DMA fed channel
+   int    flops;
+   int    ram_bits;
+   int    mux_inputs;          // bus word inputs of the read mux, every stage
+   int    levels;              // logic levels of the widest read mux stage
+   int    part_flops[PARTS];
+   int    part_ram[PARTS];
+} estimate_struct;
+
+
+static int axi_payload_bits(int channel)
+{
+   // bits of one master channel through axi_cdc_bridge, as axi_fields packs it
+
+   axi_field *f;
+   char buf[STRLEN];
+   int bits = 0;
+
+   for (f=axi_fields[channel]; f->name; f++) {
+      axi_field_width(channel, f, buf);
+      if (!strcmp(buf, "ID_BITS"))        bits += options.id_bits;
+      else if (!strcmp(buf, "ADDR_BITS")) bits += options.addr_bits;
+      else if (!strcmp(buf, "DATA_BITS")) bits += 8 << options.bw_bits;
+      else if (!strcmp(buf, "STRB_BITS")) bits += 1 << options.bw_bits;
+      else if (isdigit(buf[0]))           bits += atoi(buf);
+      else                                bits += (channel == 0) ? options.awuser_bits : (channel == 1) ? options.wuser_bits :
+                                                  (channel == 2) ? options.buser_bits  : (channel == 3) ? options.aruser_bits :
+                                                  options.ruser_bits;
+   }
+   return bits;
+}
+
+
+static void estimate(signal_struct *signals, int burst, estimate_struct *e)
+{
+   // burst is the beats per host burst over the register bank
+
+   signal_struct *sp;
+   int data_bits = 8 << options.bw_bits;
+   int count = register_count(signals);
+   int latency = read_latency(signals);
+   int stages = read_stages(signals);
+   int slice_bits[5];
+   int extra_read, extra_write;
+   int bits, k, groups;
+   int c, i;
+
+   // each forward or full slice on the way adds a cycle
+   extra_read  = ((options.slice[3] & 1) ? 1 : 0) + ((options.slice[4] & 1) ? 1 : 0);
+   extra_write = (((options.slice[0] | options.slice[1]) & 1) ? 1 : 0) + ((options.slice[2] & 1) ? 1 : 0);
+
+   e->read_cycles  = 2 + latency + extra_read;
+   e->write_cycles = 2 + extra_write;
+   e->burst_rate   = 2.0 * burst * (data_bits / 8) / ((1 + latency + burst + extra_read) + (burst + 1 + extra_write));
+   e->channel_rate = 1.0 / (e->read_cycles + e->write_cycles);
+   e->dma_rate     = 0;
+   if (has_dma()) {
+      e->dma_rate = 1.0;
+      if (options.core_clock && (options.cdc_depth < CDC_ROUND_TRIP)) e->dma_rate = (double) options.cdc_depth / CDC_ROUND_TRIP;
+   }
+
+   memset(e->part_flops, 0, sizeof(e->part_flops));
+   memset(e->part_ram, 0, sizeof(e->part_ram));
+
+   // the register bank and valid and ready of each channel, the read data register
+   e->part_flops[PART_BANK] = count * data_bits + 2 * channel_count(signals);
+   e->part_flops[PART_READ] = data_bits;
+
+   if (options.read_ram) {
+      e->part_flops[PART_READ] += count + data_bits + 2;
+      e->part_ram[PART_READ] = count * data_bits;
+      e->mux_inputs = 2;
+      for (i=0; i<count; i++) if (!host_written(signals, i)) e->mux_inputs++;
+      e->levels = 1 + (log2_ceil(e->mux_inputs) + options.cal.mux_bits - 1) / options.cal.mux_bits;
+   } else {
+      bits = 1;
+      while ((1 << bits) < count) bits++;
+      k = (bits + stages - 1) / stages;
+      e->mux_inputs = count;
+      groups = count;
+      for (i=1; i<stages; i++) {
+         groups = (groups + (1 << k) - 1) >> k;
+         e->part_flops[PART_READ] += groups * data_bits + slave_bits(signals) - options.bw_bits + 1;
+         e->mux_inputs += groups;
+      }
+      // the widest stage, k select bits
+      e->levels = (k + options.cal.mux_bits - 1) / options.cal.mux_bits;
+   }
+
+   for (sp=signals; sp; sp=sp->next) {
+      if (sp->is_memory) e->part_ram[PART_MEMORIES] += sp->depth * sp->width;
+      if (sp->is_stream) {
+         e->part_flops[PART_STREAMS] += sp->stream_bits + 8;
+         if (options.stream_slice) e->part_flops[PART_STREAMS] += 2 * (sp->stream_bits + sp->stream_bits/8 + 1) + 4;
+      }
+      if (options.core_clock && sp->is_channel) {
+         e->part_flops[PART_CROSSING] += options.cdc_depth * sp->width + 4 * log2_ceil(options.cdc_depth) + 4;
+      }
+      if (options.core_clock && sp->is_wire) e->part_flops[PART_CROSSING] += 2 * sp->width;
+   }
+   if (options.core_clock && has_master(signals)) {
+      for (c=0; c<5; c++) {
+         e->part_flops[PART_CROSSING] += options.cdc_depth * axi_payload_bits(c) + 4 * log2_ceil(options.cdc_depth) + 4;
+      }
+   }
+
+   // DMA engines, addresses, counts and a held beat each
+   if (options.dma_in[0])  e->part_flops[PART_DMA] += 2 * options.addr_bits + data_bits + 120;
+   if (options.dma_out[0]) e->part_flops[PART_DMA] += 2 * options.addr_bits + data_bits + 120;
+
+   // scatter-gather, a segment per channel, the walk and its descriptor
+   if (options.scatter_gather) e->part_flops[PART_SG] = 8 * options.addr_bits + 2 * options.id_bits + 260;
+
+   // slices on the slave port, payload and VALID per register stage
+   slice_bits[0] = slice_bits[3] = 1 + options.id_bits + slave_bits(signals) + 8 + 3 + 2 + 1 + 4 + 3;
+   slice_bits[1] = 1 + options.id_bits + data_bits + data_bits/8 + 1;
+   slice_bits[2] = 1 + options.id_bits + 2;
+   slice_bits[4] = 1 + options.id_bits + data_bits + 2 + 1;
+   for (c=0; c<5; c++) {
+      if (options.slice[c]) e->part_flops[PART_SLICES] += ((options.slice[c] == 3) ? 2 : 1) * (slice_bits[c] + 1);
+   }
+
+   e->flops = 0;
+   e->ram_bits = 0;
+   for (c=0; c<PARTS; c++) {
+      e->flops += e->part_flops[c];
+      e->ram_bits += e->part_ram[c];
+   }
+}
+
+
+static void print_perf(FILE *txt, signal_struct *signals, char *file_name)
+{
+    // bus transactions, bytes and cycles of the job in perf_job, host
+    // accesses as the header makes them: a poll then the access for each
+    // channel element, one access per register or memory word, START and
+    // WAIT for a DMA engine.  Host accesses are 32 bit and one at a time on
+    // the slave port, DMA engines and the master run on their own ports
+    // alongside the catapult instance.
+
+    job_struct *job = &options.job;
+    estimate_struct e;
+    signal_struct *sp;
+    signal_struct *go = tb_go(signals);
+    int bus_bytes = 1 << options.bw_bits;
+    long reads, writes, polls;
+    long total_reads = 0, total_writes = 0, total_polls = 0;
+    long beats, bursts, max_beats;
+    double mmio_cycles, dma_cycles = 0, master_cycles = 0, cycles;
+    int listed_go = 0, listed_done = 0;
+    int i, n;
+
+    estimate(signals, 16, &e);
+
+    fprintf(txt, "# performance of a job of %s on %s, written by if_gen_axi \n", options.perf_job, file_name);
+    fprintf(txt, "# slave port %s, %d bit, register read %d cycles and write %d cycles \n",
+            (options.top == 1) ? "AXI4-Lite" : (options.top == 2) ? "AXI4" : "axi_slave_interface",
+            8 << options.bw_bits, e.read_cycles, e.write_cycles);
+    fprintf(txt, "# %d read%s per poll, %d per wait for done or a DMA engine \n", job->polls, (job->polls == 1) ? "" : "s",
+            job->done_polls);
+    fprintf(txt, "# \n");
+    fprintf(txt, "# %-24s %-16s %10s %10s %10s %10s %12s \n", "name", "access", "elements", "reads", "polls", "writes", "cycles");
+
+    for (i=0; i<=job->items; i++) {
+       // the listed names, then config, GO and WAIT_FOR_DONE
+       reads = writes = polls = 0;
+       if (i < job->items) {
+          sp = find_signal(signals, job->name[i]);
+          if (go && (sp == go)) listed_go = 1;
+          if (go && (0 == strcmp(sp->signal_name, "done"))) listed_done = 1;
+          if ((0 == strcmp(sp->signal_name, options.dma_in)) || (0 == strcmp(sp->signal_name, options.dma_out))) {
+             // the engine moves the elements, the host starts it and waits
+             n = (0 == strcmp(sp->signal_name, options.dma_in));
+             polls = (job->count[i]) ? job->polls + job->done_polls : 0;
+             writes = (job->count[i]) ? 3 : 0;
+             beats = (job->count[i] * (dma_elem_bits(sp) / 8) + bus_bytes - 1) / bus_bytes;
+             bursts = (beats + 15) / 16;
+             cycles = beats + 2 * bursts;
+             if (e.dma_rate > 0 && (job->count[i] / e.dma_rate > cycles)) cycles = job->count[i] / e.dma_rate;
+             dma_cycles += cycles;
+             fprintf(txt, "  %-24s %-16s %10ld %10ld %10ld %10ld %12.0f \n", sp->signal_name, n ? "DMA read" : "DMA write",
+                     job->count[i], polls, polls, writes, (double) polls * e.read_cycles + writes * e.write_cycles);
+             fprintf(txt, "  %-24s %-16s %ld beats in %ld burst%s, %.0f cycles on the DMA port \n", "", "",
+                     beats, bursts, (bursts == 1) ? "" : "s", cycles);
+             total_polls += polls;
+             total_reads += polls;
+             total_writes += writes;
+             continue;
+          }
+          if (sp->is_channel && sp->is_input) {
+             polls = job->count[i] * job->polls;
+             writes = job->count[i];
+          } else if (sp->is_channel) {
+             polls = job->count[i] * ((0 == strcmp(sp->signal_name, "done")) ? job->done_polls : job->polls);
+             reads = job->count[i];
+          } else if (sp->is_input) {
+             writes = job->count[i];
+          } else {
+             reads = job->count[i];
+          }
+          fprintf(txt, "  %-24s %-16s ", sp->signal_name, sp->is_memory ? (sp->is_input ? "memory write" : "memory read") :
+                  sp->is_channel ? (sp->is_input ? "channel SET" : "channel GET") : (sp->is_input ? "register write" : "register read"));
+          fprintf(txt, "%10ld ", job->count[i]);
+       } else {
+          writes = job->config;
+          if (options.job.master_bytes) writes += 3;   // ADDR_OFFSET_LOW, ADDR_OFFSET_HIGH and BURST_SIZE
+          if (options.job.master_bytes && options.scatter_gather) writes += 3;   // SG_LIST_LOW, SG_LIST_HIGH and SG_COUNT
+          if (writes) {
+             fprintf(txt, "  %-24s %-16s %10s ", "config", "register write", "");
+             fprintf(txt, "%10ld %10ld %10ld %12.0f \n", 0L, 0L, writes, (double) writes * e.write_cycles);
+             total_writes += writes;
+          }
+          if (!go || (listed_go && listed_done)) break;
+          reads = writes = polls = 0;
+          if (!listed_go) {
+             polls += job->polls;
+             writes++;
+          }
+          if (!listed_done) {
+             polls += job->done_polls;
+             reads++;
+          }
+          fprintf(txt, "  %-24s %-16s %10s ", "go, done", "GO, WAIT", "");
+       }
+       fprintf(txt, "%10ld %10ld %10ld %12.0f \n", reads + polls, polls, writes,
+               (double) (reads + polls) * e.read_cycles + writes * e.write_cycles);
+       total_reads += reads + polls;
+       total_polls += polls;
+       total_writes += writes;
+    }
+
+    mmio_cycles = (double) total_reads * e.read_cycles + (double) total_writes * e.write_cycles;
+
+    fprintf(txt, "# \n");
+    fprintf(txt, "# slave port: %ld transactions, %ld reads (%ld of them polls) and %ld writes, %ld bytes, %.0f cycles \n",
+            total_reads + total_writes, total_reads, total_polls, total_writes, 4 * (total_reads + total_writes), mmio_cycles);
+    if (mmio_cycles > 0) {
+       fprintf(txt, "#   polling %.0f cycles, %.0f%% of them \n", (double) total_polls * e.read_cycles,
+               100.0 * total_polls * e.read_cycles / mmio_cycles);
+    }
+
+    if (job->master_bytes) {
+       // bursts of burst_size beats, split at 4KB, each with an address and
+       // a response cycle and the crossing with a core clock
+       max_beats = (job->burst_size < (4096 / bus_bytes)) ? job->burst_size : (4096 / bus_bytes);
+       beats = (job->master_bytes + bus_bytes - 1) / bus_bytes;
+       bursts = (beats + max_beats - 1) / max_beats;
+       master_cycles = beats + bursts * (2 + ((options.core_clock) ? CDC_ROUND_TRIP : 0));
+       fprintf(txt, "# master port: %ld bytes in %ld beats, %ld bursts of up to %ld, %.0f cycles, %.0f%% efficient \n",
+               job->master_bytes, beats, bursts, max_beats, master_cycles, 100.0 * beats / master_cycles);
+       if (options.scatter_gather) {
+          // a descriptor read for each segment the buffer touches, both
+          // channels in the worst case, with the reads before it drained
+          n = (int) ((job->master_bytes + 4095) / 4096) + 1;
+          cycles = 2.0 * n * (((options.bw_bits < 4) ? (16 >> options.bw_bits) : 1) + 2 + 2);
+          fprintf(txt, "#   scatter-gather: up to %d segments, %.0f cycles of list walks \n", n, cycles);
+          master_cycles += cycles;
+       }
+    }
+    if (dma_cycles > 0) fprintf(txt, "# DMA port: %.0f cycles \n", dma_cycles);
+    if (job->compute) fprintf(txt, "# compute: %ld cycles \n", job->compute);
+
+    cycles = mmio_cycles;
+    if (master_cycles > cycles) cycles = master_cycles;
+    if (dma_cycles > cycles) cycles = dma_cycles;
+    if (job->compute > cycles) cycles = job->compute;
+    if (cycles > 0) {
+       fprintf(txt, "# bound by the %s, at least %.0f cycles per job \n",
+               (cycles == mmio_cycles) ? "slave port (MMIO)" : (cycles == master_cycles) ? "master port" :
+               (cycles == dma_cycles) ? "DMA port" : "computation", cycles);
+    }
+}
+
+
+static int slave_flops(int lite, int addr_bits, int data_bits, int id_bits, int latency)
+{
+   // the slave port in front of the register bank, without its slices.
+   // axi_lite_slave holds latency+1 read beats, axi_slave_interface an
+   // address latch per direction, latency+2 prefetched beats, the read
+   // context pipe, the write response and the exclusive monitor
+
+   if (lite) return 1 + latency + (latency + 1) * data_bits + 32;
+   return 2 * (addr_bits + id_bits + 25) + (latency + 2) * (data_bits + id_bits + 5) + latency * (id_bits + 3) +
+          (id_bits + 8) + (addr_bits + id_bits + 2) + 32;
+}
+
+
+static void print_resource_totals(FILE *txt, calibration_struct *cal, char *module, long flops, long mux_inputs,
+                                  long ram_bits, long levels)
+{
+   // a module's totals scaled by the calibration, with a warning for
+   // each that is over its limit
+
+   long value[RESOURCES];
+   long raw[RESOURCES];
+   int i;
+
+   raw[0] = flops;
+   raw[1] = mux_inputs;
+   raw[2] = ram_bits;
+   raw[3] = levels;
+
+   fprintf(txt, "  %-24s %10s %10s %10s %10s \n", "total", "flops", "mux_inputs", "ram_bits", "levels");
+   fprintf(txt, "  %-24s %10ld %10ld %10ld %10ld \n", "estimated", raw[0], raw[1], raw[2], raw[3]);
+   for (i=0; i<RESOURCES; i++) value[i] = (long) (raw[i] * cal->scale[i] + 0.5);
+   fprintf(txt, "  %-24s %10ld %10ld %10ld %10ld \n", "calibrated", value[0], value[1], value[2], value[3]);
+
+   for (i=0; i<RESOURCES; i++) {
+      if (cal->max[i] && (value[i] > cal->max[i])) {
+         fprintf(txt, "# warning: %s %ld %s over max_%s %ld \n", module, value[i], resource_names[i], resource_names[i], cal->max[i]);
+         fprintf(stderr, "warning: %s estimates %ld %s, over max_%s %ld \n", module, value[i], resource_names[i],
+                 resource_names[i], cal->max[i]);
+      }
+   }
+}
+
+
+static void print_resources(FILE *txt, signal_struct *signals, char *file_name)
+{
+    // every synthesised module written for the spec: the register bank in
+    // <file_name>.v and, with top set, <file_name>_top.v around it.  The
+    // benches are left out.
+
+    estimate_struct e;
+    int data_bits = 8 << options.bw_bits;
+    int latency = read_latency(signals);
+    int lite = (options.top == 1);
+    char module[STRLEN];
+    long flops, mux_inputs, levels;
+    int slave;
+    int i;
+
+    estimate(signals, 16, &e);
+
+    fprintf(txt, "# resource estimate of %s, written by if_gen_axi, %s%s \n", file_name,
+            (options.calibration[0]) ? "calibrated by " : "uncalibrated", options.calibration);
+    fprintf(txt, "# flops and RAM bits counted from the generated registers and memories, mux \n");
+    fprintf(txt, "# inputs in bus words over every read mux stage, levels of logic in the \n");
+    fprintf(txt, "# widest stage at %d select bit%s a level \n", options.cal.mux_bits, (options.cal.mux_bits == 1) ? "" : "s");
+    fprintf(txt, "# \n");
+
+    fprintf(txt, "# module %s \n", file_name);
+    fprintf(txt, "  %-24s %10s %10s \n", "part", "flops", "ram_bits");
+    flops = 0;
+    for (i=0; i<PARTS; i++) {
+       if ((i == PART_SLICES) || !(e.part_flops[i] || e.part_ram[i])) continue;
+       fprintf(txt, "  %-24s %10d %10d \n", part_names[i], e.part_flops[i], e.part_ram[i]);
+       flops += e.part_flops[i];
+    }
+    print_resource_totals(txt, &options.cal, file_name, flops, e.mux_inputs, e.ram_bits, e.levels);
+
+    if (options.top) {
+       // the slave's read data select, the held beats of lite or the prefetched ones
+       slave = slave_flops(lite, slave_bits(signals), data_bits, options.id_bits, latency);
+       mux_inputs = e.mux_inputs + latency + 2;
+       levels = (log2_ceil(latency + 2) + options.cal.mux_bits - 1) / options.cal.mux_bits;
+       if (levels < e.levels) levels = e.levels;
+       sprintf(module, "%s_top", file_name);
+       fprintf(txt, "# \n");
+       fprintf(txt, "# module %s \n", module);
+       fprintf(txt, "  %-24s %10s %10s \n", "part", "flops", "ram_bits");
+       fprintf(txt, "  %-24s %10ld %10d \n", file_name, flops, e.ram_bits);
+       fprintf(txt, "  %-24s %10d %10d \n", lite ? "axi_lite_slave" : "axi_slave_interface", slave, 0);
+       if (!lite && e.part_flops[PART_SLICES]) fprintf(txt, "  %-24s %10d %10d \n", part_names[PART_SLICES], e.part_flops[PART_SLICES], 0);
+       flops += slave + ((lite) ? 0 : e.part_flops[PART_SLICES]);
+       print_resource_totals(txt, &options.cal, module, flops, mux_inputs, e.ram_bits, levels);
+    }
+}
+
+
+static signal_struct *load_interface(char *filename, char **defaults, int default_count, char **cli_options, int cli_option_count)
+{
+    // options start from their defaults, then the "<name> = <value>" pairs
+    // in defaults (the system spec), the spec file and the command line
+
+    signal_struct *signals;
+    signal_struct *next_signal;
+    int ok = 1;
+    int i;
+
+    default_options(&options);
+    for (i=0; i<default_count; i++) {
+       if (!set_option(defaults[2*i], defaults[2*i+1])) return NULL;
+    }
+
+    signals = parse_interface(filename);
+
+    for (i=0; signals && (i<cli_option_count); i++) {
+       if (!strcmp(cli_options[2*i] + 1, "system") || !strcmp(cli_options[2*i] + 1, "paths") ||
+           !strcmp(cli_options[2*i] + 1, "sweep")) continue;
+       if (!set_option(cli_options[2*i] + 1, cli_options[2*i+1])) ok = 0;
+    }
+
+    if (signals && ok) ok = check_options(signals);
+
+    if (!ok) {
+       while (signals) {
+          next_signal = signals->next;
+          free(signals);
+          signals = next_signal;
+       }
+    }
+    return signals;
+}
+
+
+static void print_accelerator(signal_struct *signals, char *instance_name, char *module_name, char *file_name)
+{
+    // the register bank and, with their options set, the testbench, the
+    // replay bench, the top level, the performance report and the resource
+    // estimate, in <file_name>.v, <file_name>_tb.v, <file_name>_replay.v,
+    // <file_name>_top.v, <file_name>.perf and <file_name>.res
+
+    FILE *verilog_file;
+    FILE *testbench_file;
+    FILE *top_file;
+    char filename[STRLEN];
+
+    // modulename and filename must match for VCS
+
+    strcpy(filename, file_name);
+    strcat(filename, ".v");
+    verilog_file = fopen(filename, "w");
+    if (!verilog_file) {
+       fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+       perror("if_gen");
+       return;
+    }
+
+    print_intro(verilog_file, signals, instance_name);
+    print_signals(verilog_file, signals);
+    print_register_map(verilog_file, signals);
+    print_assignments(verilog_file, signals);
+    print_register_accesses(verilog_file, signals);
+    print_memories(verilog_file, signals);
+    print_streams(verilog_file, signals);
+    print_ready_valids(verilog_file, signals);
+    print_dma(verilog_file, signals);
+    print_job_slots(verilog_file, signals);
+    print_clock_crossing(verilog_file, signals);
+    print_scatter_gather(verilog_file, signals);
+    print_catapult_instantiation(verilog_file, signals, instance_name, module_name);
+    print_epilog(verilog_file);
+    fclose(verilog_file);
+
+    if (options.testbench) {
+       strcpy(filename, file_name);
+       strcat(filename, "_tb.v");
+       testbench_file = fopen(filename, "w");
+       if (!testbench_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+          perror("if_gen");
+       } else {
+          print_testbench(testbench_file, signals, instance_name, file_name);
+          fclose(testbench_file);
+       }
+    }
+
+    if (options.replay) {
+       strcpy(filename, file_name);
+       strcat(filename, "_replay.v");
+       testbench_file = fopen(filename, "w");
+       if (!testbench_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+          perror("if_gen");
+       } else {
+          print_replay(testbench_file, signals, instance_name, file_name);
+          fclose(testbench_file);
+       }
+    }
+
+    if (options.top) {
+       strcpy(filename, file_name);
+       strcat(filename, "_top.v");
+       top_file = fopen(filename, "w");
+       if (!top_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+          perror("if_gen");
+       } else {
+          print_top(top_file, signals, instance_name, file_name);
+          fclose(top_file);
+       }
+    }
+    if (options.perf_job[0]) {
+       strcpy(filename, file_name);
+       strcat(filename, ".perf");
+       top_file = fopen(filename, "w");
+       if (!top_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+          perror("if_gen");
+       } else {
+          print_perf(top_file, signals, file_name);
+          fclose(top_file);
+       }
+    }
+    if (options.resources || options.calibration[0]) {
+       strcpy(filename, file_name);
+       strcat(filename, ".res");
+       top_file = fopen(filename, "w");
+       if (!top_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", filename);
+          perror("if_gen");
+       } else {
+          print_resources(top_file, signals, file_name);
+          fclose(top_file);
+       }
+    }
+}
+
+
+// system mode: many accelerators from one system spec, each in its own
+// window of the host address space, on one or more AXI slave paths
+
+#define MAX_ACCELERATORS 64
+#define MAX_PATHS        16
+
+typedef struct {
+   char instance_name[STRLEN];
+   char spec_filename[STRLEN];
+   char module_name[STRLEN];
+   unsigned int base;
+   int  path;
+   int  window_bits;      // byte address bits of the window, slave_bits()
+   int  bw_bits;
+   int  latency;          // read_latency()
+   int  registers;
+} accel_entry;
+
+typedef struct {
+   int  paths;
+   int  count;
+   int  slice[5];         // register slices of every path, options.slice
+   int  id_bits;
+   int  resources;        // the resource estimate of the interconnect, options.resources
+   calibration_struct cal;
+   accel_entry accel[MAX_ACCELERATORS];
+   int  default_count;    // "<option> = <value>" lines for every accelerator
+   char defaults[2*MAX_ACCELERATORS][STRLEN];
+   char *default_ptrs[2*MAX_ACCELERATORS];
+} system_struct;
+
+
+static int parse_system(char *filename, system_struct *sys)
+{
+   /*
+    * file should have the following format:
+    *
+    * <instance_name>, <signal specification file>, <base_address> [, <module_name> [, <path>]]
+    *
+    * or an option setting, "paths" for the system and any other as the
+    * default for every accelerator:
+    *
+    * <option_name> = <value>
+    */
+
+   FILE *sys_spec;
+   char line[STRLEN];
+   char field[5][STRLEN];
+   char *r;
+   char *value;
+   int line_no = 0;
+   int i;
+   accel_entry *ap;
+
+   sys->paths = 1;
+   sys->count = 0;
+   sys->default_count = 0;
+
+   sys_spec = fopen(filename, "r");
+   if (!sys_spec) {
+      fprintf(stderr, "Unable to open file %s for reading \n", filename);
+      perror("if_gen");
+      return 0;
+   }
+
+   while (fgets(line, sizeof(line), sys_spec)) {
+      line_no++;
+
+      clean_whitespace(line);
+      if (strlen(line) == 0) continue;
+      if (comment(line)) continue;
+
+      if ((value = strchr(line, '='))) {
+         *value++ = 0;
+         clean_whitespace(line);
+         clean_whitespace(value);
+         lowercase(line);
+         if (!valid_signal_name(line)) {
+            fprintf(stderr, "Invalid option name at line %d: %s \n", line_no, line);
+            return 0;
+         }
+         if (0 == strcmp(line, "paths")) {
+            sys->paths = atoi(value);
+            if (!valid_number_str(value) || (sys->paths < 1) || (sys->paths > MAX_PATHS)) {
+               fprintf(stderr, "paths must be from 1 to %d: %s \n", MAX_PATHS, value);
+               return 0;
+            }
+         } else {
+            if (sys->default_count == MAX_ACCELERATORS) {
+               fprintf(stderr, "Too many options at line %d \n", line_no);
+               return 0;
+            }
+            strcpy(sys->defaults[2*sys->default_count], line);
+            strcpy(sys->defaults[2*sys->default_count+1], value);
+            sys->default_ptrs[2*sys->default_count] = sys->defaults[2*sys->default_count];
+            sys->default_ptrs[2*sys->default_count+1] = sys->defaults[2*sys->default_count+1];
+            sys->default_count++;
+         }
+         continue;
+      }
+
+      for (i=0; i<5; i++) {
+         field[i][0] = 0;
+         r = strtok((i == 0) ? line : NULL, ",");
+         if (r) strcpy(field[i], r);
+         clean_whitespace(field[i]);
+      }
+
+      if (sys->count == MAX_ACCELERATORS) {
+         fprintf(stderr, "More than %d accelerators at line %d \n", MAX_ACCELERATORS, line_no);
+         return 0;
+      }
+      ap = &sys->accel[sys->count];
+
+      if (!valid_signal_name(field[0])) {
+         fprintf(stderr, "Invalid instance name at line %d: %s \n", line_no, field[0]);
+         return 0;
+      }
+      if (strlen(field[0]) > STRLEN - 32) {
+         fprintf(stderr, "Instance name at line %d is too long: %s \n", line_no, field[0]);
+         return 0;
+      }
+      for (i=0; i<sys->count; i++) {
+         if (0 == strcmp(field[0], sys->accel[i].instance_name)) {
+            fprintf(stderr, "Instance %s at line %d is already in the system \n", field[0], line_no);
+            return 0;
+         }
+      }
+      if (!strlen(field[1]) || !strlen(field[2])) {
+         fprintf(stderr, "Missing specification file or base address at line %d \n", line_no);
+         return 0;
+      }
+      if (strlen(field[3]) && !valid_signal_name(field[3])) {
+         fprintf(stderr, "Invalid module name at line %d: %s \n", line_no, field[3]);
+         return 0;
+      }
+
+      strcpy(ap->instance_name, field[0]);
+      strcpy(ap->spec_filename, field[1]);
+      ap->base = strtoul(field[2], &r, 0);
+      if (*r) {
+         fprintf(stderr, "Invalid base address at line %d: %s \n", line_no, field[2]);
+         return 0;
+      }
+      strcpy(ap->module_name, strlen(field[3]) ? field[3] : DEFAULT_MODULE_NAME);
+      ap->path = -1;
+      if (strlen(field[4])) {
+         if (!valid_number_str(field[4])) {
+            fprintf(stderr, "Invalid path at line %d: %s \n", line_no, field[4]);
+            return 0;
+         }
+         ap->path = atoi(field[4]);
+      }
+      sys->count++;
+   }
+
+   fclose(sys_spec);
 
-    sp = signals;
-    while (sp) {
-        if (!sp->is_master) {
-           if (sp->is_channel && (0 == strcmp(sp->signal_name, "go"))) {
-               fprintf(txt, "#define GO                               { while (!GO_READY_REG); GO_REG = 1; } \n");
-           }
-           else if (sp->is_channel && (0 == strcmp(sp->signal_name, "done"))) {
-               fprintf(txt, "#define WAIT_FOR_DONE                    { while (!DONE_VALID_REG); volatile unsigned int x = DONE_REG; } \n");
-           }
-           else {
-                if (sp->is_input) {
-                    if (sp->is_channel) {
-                        fprintf(txt, "#define SET_%s(X) ", uppercase(sp->signal_name, buf));
-                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                        fprintf(txt, " { while (!%s_READY_REG); %s_REG = X; } \n", uppercase(sp->signal_name, buf), uppercase(sp->signal_name, buf));
-                    } else {
-                        fprintf(txt, "#define SET_%s(X) ", uppercase(sp->signal_name, buf));
-                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                        fprintf(txt, " { %s_REG = X; } \n", uppercase(sp->signal_name, buf));
-                    }
-                } else {
-                    if (sp->is_channel) {
-                        fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
-                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                        fprintf(txt, " { while (!%s_READY_REG); X = %s_REG; } \n", uppercase(sp->signal_name, buf), uppercase(sp->signal_name, buf));
-                    } else {
-                        fprintf(txt, "#define GET_%s(X) ", uppercase(sp->signal_name, buf));
-                        for (i=strlen(sp->signal_name); i<offset-6; i++) fprintf(txt, " ");
-                        fprintf(txt, " { X = %s_REG; } \n", uppercase(sp->signal_name, buf));
-                    }
-                }
-           }
-       }
-       sp = sp->next;
-    }
+   if (!sys->count) {
+      fprintf(stderr, "No accelerators in %s \n", filename);
+      return 0;
+   }
+   return 1;
 }
- 
-               
+
+
+static int check_system(system_struct *sys)
+{
+   // every window aligned to its size, inside 32 bits, on a path that
+   // exists and clear of every other window, with one bus width
+
+   accel_entry *ap, *bp;
+   unsigned long long end_a, end_b;
+   int ok = 1;
+   int i, j;
+
+   for (i=0; i<sys->count; i++) {
+      ap = &sys->accel[i];
+      end_a = (unsigned long long) ap->base + (1ull << ap->window_bits);
+      if (ap->path < 0) ap->path = i % sys->paths;
+      if (ap->path >= sys->paths) {
+         fprintf(stderr, "%s is on path %d of %d \n", ap->instance_name, ap->path, sys->paths);
+         ok = 0;
+      }
+      if (ap->base & ((1u << ap->window_bits) - 1)) {
+         fprintf(stderr, "%s at 0x%08x is not aligned to its window of 0x%llx bytes \n",
+                 ap->instance_name, ap->base, 1ull << ap->window_bits);
+         ok = 0;
+      }
+      if (end_a > (1ull << 32)) {
+         fprintf(stderr, "%s at 0x%08x runs past the 32 bit address space \n", ap->instance_name, ap->base);
+         ok = 0;
+      }
+      if (ap->bw_bits != sys->accel[0].bw_bits) {
+         fprintf(stderr, "%s has data_bits %d, %s has %d, the system needs one bus width \n",
+                 ap->instance_name, 8 << ap->bw_bits, sys->accel[0].instance_name, 8 << sys->accel[0].bw_bits);
+         ok = 0;
+      }
+      for (j=0; j<i; j++) {
+         bp = &sys->accel[j];
+         end_b = (unsigned long long) bp->base + (1ull << bp->window_bits);
+         if ((ap->base < end_b) && (bp->base < end_a)) {
+            fprintf(stderr, "%s at 0x%08x-0x%08llx overlaps %s at 0x%08x-0x%08llx \n",
+                    ap->instance_name, ap->base, end_a - 1, bp->instance_name, bp->base, end_b - 1);
+            ok = 0;
+         }
+      }
+   }
+   return ok;
+}
+
+
+static int path_latency(system_struct *sys, int path)
+{
+   int latency = 1;
+   int i;
+
+   for (i=0; i<sys->count; i++) {
+      if ((sys->accel[i].path == path) && (sys->accel[i].latency > latency)) latency = sys->accel[i].latency;
+   }
+   return latency;
+}
+
+
+static void print_system_map(FILE *txt, system_struct *sys, char *system_name)
+{
+   accel_entry *order[MAX_ACCELERATORS];
+   accel_entry *ap;
+   int i, j;
+
+   // by address
+   for (i=0; i<sys->count; i++) {
+      ap = &sys->accel[i];
+      for (j=i; (j > 0) && (order[j-1]->base > ap->base); j--) order[j] = order[j-1];
+      order[j] = ap;
+   }
+
+   fprintf(txt, "# address map of %s, written by if_gen_axi \n", system_name);
+   fprintf(txt, "# \n");
+   fprintf(txt, "# %-20s %-20s %-10s %-10s %10s %4s %9s %7s \n", "instance", "module", "base", "end", "bytes", "path", "registers", "latency");
+   for (i=0; i<sys->count; i++) {
+      ap = order[i];
+      fprintf(txt, "  %-20s %-20s 0x%08x 0x%08x %10llu %4d %9d %7d \n", ap->instance_name, ap->module_name, ap->base,
+              (unsigned int) (ap->base + ((1ull << ap->window_bits) - 1)), 1ull << ap->window_bits, ap->path,
+              ap->registers, ap->latency);
+   }
+   fprintf(txt, "# \n");
+   for (i=0; i<sys->paths; i++) {
+      fprintf(txt, "# path %d read latency %d \n", i, path_latency(sys, i));
+   }
+   for (i=0; i<5; i++) {
+      if (sys->slice[i]) fprintf(txt, "# %s %s on every path \n", slice_options[i], slice_modes[sys->slice[i]]);
+   }
+}
+
+
+static void print_system_verilog(FILE *txt, system_struct *sys, char *system_name)
+{
+   // each path is an axi_slave_interface whose SRAM side is decoded to the
+   // register ports of its accelerators.  Read data from faster
+   // accelerators is delayed to the slowest one on the path so the
+   // interface sees one read latency, and a read or write outside every
+   // window reads 0 and is dropped.
+
+   accel_entry *ap;
+   char name[STRLEN];
+   char addr_range[32];
+   char data_range[32];
+   char strb_range[32];
+   int latency;
+   int first;
+   int n;
+   int p, i, k;
+
+   fprintf(txt, "// interconnect of %s, written by if_gen_axi, one AXI slave port per path \n", system_name);
+   fprintf(txt, "// decoded to the register ports of the accelerators on it, see %s.map \n", system_name);
+   fprintf(txt, " \n");
+   fprintf(txt, "`timescale 1ns/1ns \n");
+   fprintf(txt, " \n");
+   fprintf(txt, "module %s \n", system_name);
+   fprintf(txt, " #( \n");
+   fprintf(txt, "  parameter MASTERS   = 1, \n");
+   fprintf(txt, "  parameter BW_BITS   = %d, \n", sys->accel[0].bw_bits);
+   fprintf(txt, "  parameter DATA_BITS = (8 * (1 << BW_BITS)), \n");
+   fprintf(txt, "  parameter STRB_BITS = (DATA_BITS/8), \n");
+   fprintf(txt, "  parameter ID_BITS   = 4, \n");
+   fprintf(txt, "  parameter ADDR_BITS = 32 \n");
+   fprintf(txt, " ) \n");
+   fprintf(txt, " ( \n");
+   fprintf(txt, "  input                           clock, \n");
+   fprintf(txt, "  input                           resetn, \n");
+   for (p=0; p<sys->paths; p++) {
+      fprintf(txt, " \n");
+      sprintf(name, "p%d_", p);
+      print_slave_port(txt, tb_slave_port, name, "MASTERS", "ADDR_BITS", 0);
+   }
+   for (i=0; i<sys->count; i++) {
+      ap = &sys->accel[i];
+      fprintf(txt, " \n");
+      sprintf(addr_range, "[%d:0]", ap->window_bits - ap->bw_bits - 1);
+      sprintf(data_range, "[%d:0]", (8 << ap->bw_bits) - 1);
+      sprintf(strb_range, "[%d:0]", (1 << ap->bw_bits) - 1);
+      fprintf(txt, "  output %-25s%s_read_addr, \n", addr_range, ap->instance_name);
+      fprintf(txt, "  input  %-25s%s_read_data, \n", data_range, ap->instance_name);
+      fprintf(txt, "  output %-25s%s_oe, \n", "", ap->instance_name);
+      fprintf(txt, "  output %-25s%s_write_addr, \n", addr_range, ap->instance_name);
+      fprintf(txt, "  output %-25s%s_write_data, \n", data_range, ap->instance_name);
+      fprintf(txt, "  output %-25s%s_be, \n", strb_range, ap->instance_name);
+      fprintf(txt, "  output %-25s%s_we%s \n", "", ap->instance_name, (i == sys->count - 1) ? "" : ",");
+   }
+   fprintf(txt, " ); \n");
+   fprintf(txt, " \n");
+   for (i=0; i<sys->count; i++) {
+      ap = &sys->accel[i];
+      fprintf(txt, " localparam [ADDR_BITS-1:0] %s_BASE = 32'h%08x; \n", uppercase(ap->instance_name, name), ap->base);
+   }
+
+   for (p=0; p<sys->paths; p++) {
+      latency = path_latency(sys, p);
+      n = 0;
+      for (i=0; i<sys->count; i++) if (sys->accel[i].path == p) n++;
+
+      fprintf(txt, " \n");
+      fprintf(txt, " // path %d, read latency %d \n", p, latency);
+      fprintf(txt, " \n");
+      fprintf(txt, " wire [ADDR_BITS-1:0]  p%d_sram_raddr; \n", p);
+      fprintf(txt, " wire [DATA_BITS-1:0]  p%d_sram_rdata; \n", p);
+      fprintf(txt, " wire                  p%d_sram_oe; \n", p);
+      fprintf(txt, " wire [ADDR_BITS-1:0]  p%d_sram_waddr; \n", p);
+      fprintf(txt, " wire [DATA_BITS-1:0]  p%d_sram_wdata; \n", p);
+      fprintf(txt, " wire [STRB_BITS-1:0]  p%d_sram_be; \n", p);
+      fprintf(txt, " wire                  p%d_sram_we; \n", p);
+      fprintf(txt, " \n");
+      fprintf(txt, " axi_slave_interface #(.masters(MASTERS), .width(ADDR_BITS), .id_bits(ID_BITS), .p_size(BW_BITS), .b_size(BW_BITS), \n");
+      fprintf(txt, "                       .rd_prefetch(%d), .rd_latency(%d)", latency + 2, latency);
+      print_slice_params(txt, sys->slice);
+      fprintf(txt, ") p%d_slave ( \n", p);
+      fprintf(txt, "    .ACLK        (clock), \n");
+      fprintf(txt, "    .ARESETn     (resetn)");
+      sprintf(name, "p%d_", p);
+      print_tb_port(txt, tb_slave_port, "", name);
+      fprintf(txt, ", \n");
+      fprintf(txt, "    .SRAM_READ_ADDRESS      (p%d_sram_raddr), \n", p);
+      fprintf(txt, "    .SRAM_READ_DATA         (p%d_sram_rdata), \n", p);
+      fprintf(txt, "    .SRAM_OUTPUT_ENABLE     (p%d_sram_oe), \n", p);
+      fprintf(txt, "    .SRAM_WRITE_ADDRESS     (p%d_sram_waddr), \n", p);
+      fprintf(txt, "    .SRAM_WRITE_DATA        (p%d_sram_wdata), \n", p);
+      fprintf(txt, "    .SRAM_WRITE_BYTE_ENABLE (p%d_sram_be), \n", p);
+      fprintf(txt, "    .SRAM_WRITE_STROBE      (p%d_sram_we) \n", p);
+      fprintf(txt, " ); \n");
+
+      if (!n) {
+         fprintf(txt, " \n");
+         fprintf(txt, " assign p%d_sram_rdata = {DATA_BITS {1'b0}}; \n", p);
+         continue;
+      }
+
+      fprintf(txt, " \n");
+      fprintf(txt, " reg  [%d:0]  p%d_rsel[1:%d];   // accelerator read 1, 2 .. cycles ago \n", n - 1, p, latency);
+      k = 0;
+      for (i=0; i<sys->count; i++) {
+         ap = &sys->accel[i];
+         if (ap->path != p) continue;
+         uppercase(ap->instance_name, name);
+         fprintf(txt, " \n");
+         fprintf(txt, " wire        %s_rsel = (p%d_sram_raddr[ADDR_BITS-1:%d] == %s_BASE[ADDR_BITS-1:%d]); \n",
+                 ap->instance_name, p, ap->window_bits, name, ap->window_bits);
+         fprintf(txt, " wire        %s_wsel = (p%d_sram_waddr[ADDR_BITS-1:%d] == %s_BASE[ADDR_BITS-1:%d]); \n",
+                 ap->instance_name, p, ap->window_bits, name, ap->window_bits);
+         fprintf(txt, " \n");
+         fprintf(txt, " assign %s_read_addr  = p%d_sram_raddr[%d:BW_BITS]; \n", ap->instance_name, p, ap->window_bits - 1);
+         fprintf(txt, " assign %s_oe         = p%d_sram_oe && %s_rsel; \n", ap->instance_name, p, ap->instance_name);
+         fprintf(txt, " assign %s_write_addr = p%d_sram_waddr[%d:BW_BITS]; \n", ap->instance_name, p, ap->window_bits - 1);
+         fprintf(txt, " assign %s_write_data = p%d_sram_wdata; \n", ap->instance_name, p);
+         fprintf(txt, " assign %s_be         = p%d_sram_be; \n", ap->instance_name, p);
+         fprintf(txt, " assign %s_we         = p%d_sram_we && %s_wsel; \n", ap->instance_name, p, ap->instance_name);
+         fprintf(txt, " \n");
+         if (ap->latency == latency) {
+            fprintf(txt, " wire [DATA_BITS-1:0] %s_rdata = %s_read_data; \n", ap->instance_name, ap->instance_name);
+         } else {
+            fprintf(txt, " reg  [DATA_BITS-1:0] %s_rdata_d[1:%d];   // read data, delayed to the path latency \n",
+                    ap->instance_name, latency - ap->latency);
+            fprintf(txt, " wire [DATA_BITS-1:0] %s_rdata = %s_rdata_d[%d]; \n", ap->instance_name, ap->instance_name, latency - ap->latency);
+            fprintf(txt, " \n");
+            fprintf(txt, " always @(posedge clock) begin \n");
+            fprintf(txt, "    %s_rdata_d[1] <= %s_read_data; \n", ap->instance_name, ap->instance_name);
+            for (k=2; k<=latency-ap->latency; k++) {
+               fprintf(txt, "    %s_rdata_d[%d] <= %s_rdata_d[%d]; \n", ap->instance_name, k, ap->instance_name, k - 1);
+            }
+            fprintf(txt, " end \n");
+         }
+      }
+
+      fprintf(txt, " \n");
+      fprintf(txt, " always @(posedge clock) begin \n");
+      fprintf(txt, "    p%d_rsel[1] <= (p%d_sram_oe) ? {", p, p);
+      first = 1;
+      for (i=sys->count-1; i>=0; i--) {
+         if (sys->accel[i].path != p) continue;
+         fprintf(txt, "%s%s_rsel", first ? "" : ", ", sys->accel[i].instance_name);
+         first = 0;
+      }
+      fprintf(txt, "} : %d'd0; \n", n);
+      for (k=2; k<=latency; k++) fprintf(txt, "    p%d_rsel[%d] <= p%d_rsel[%d]; \n", p, k, p, k - 1);
+      fprintf(txt, " end \n");
+      fprintf(txt, " \n");
+      fprintf(txt, " assign p%d_sram_rdata = ", p);
+      k = 0;
+      for (i=0; i<sys->count; i++) {
+         if (sys->accel[i].path != p) continue;
+         fprintf(txt, "%s({DATA_BITS {p%d_rsel[%d][%d]}} & %s_rdata)", k ? " |\n                        " : "", p, latency, k, sys->accel[i].instance_name);
+         k++;
+      }
+      fprintf(txt, "; \n");
+   }
+
+   fprintf(txt, " \n");
+   fprintf(txt, "endmodule \n");
+}
+
+
+static int is_ident(int c)
+{
+   return isalnum(c) || (c == '_');
+}
+
+
+static void print_namespaced(FILE *txt, FILE *in, char *instance_name)
+{
+   // copies a header written by print_header_file with every macro it
+   // defines and every accel_ identifier prefixed by the instance name, so
+   // the headers of many accelerators can share one file.  Comments and
+   // string literals are copied as they are.
+
+   char *text;
+   char **defined;
+   char prefix[STRLEN];
+   char upper[STRLEN];
+   long size;
+   int count = 0;
+   int i, k;
+   char *p, *q;
+
+   fseek(in, 0, SEEK_END);
+   size = ftell(in);
+   rewind(in);
+   text = (char *) malloc(size + 1);
+   defined = (char **) malloc(sizeof(char *) * (size / 8 + 1));
+   if (!text || !defined) {
+      fprintf(stderr, "Unable to allocate memory for the header of %s \n", instance_name);
+      return;
+   }
+   size = fread(text, 1, size, in);
+   text[size] = 0;
+
+   for (p=text; p && *p; p=strchr(p, '\n'), p=p ? p+1 : p) {
+      if (strncmp(p, "#define ", 8)) continue;
+      defined[count++] = p + 8;
+   }
+
+   sprintf(prefix, "%s_", instance_name);
+   uppercase(prefix, upper);
+
+   p = text;
+   while (*p) {
+      if ((p[0] == '/') && (p[1] == '/')) {
+         q = strchr(p, '\n');
+         if (!q) q = p + strlen(p);
+         fwrite(p, 1, q - p, txt);
+         p = q;
+      } else if ((p[0] == '/') && (p[1] == '*')) {
+         q = strstr(p + 2, "*/");
+         q = q ? q + 2 : p + strlen(p);
+         fwrite(p, 1, q - p, txt);
+         p = q;
+      } else if ((*p == '"') || (*p == '\'')) {
+         for (q=p+1; *q && (*q != *p); q++) if ((*q == '\\') && q[1]) q++;
+         if (*q) q++;
+         fwrite(p, 1, q - p, txt);
+         p = q;
+      } else if (isdigit(*p)) {
+         for (q=p; is_ident(*q) || (*q == '.'); q++);
+         fwrite(p, 1, q - p, txt);
+         p = q;
+      } else if (is_ident(*p)) {
+         for (q=p; is_ident(*q); q++);
+         if ((q - p > 6) && !strncmp(p, "accel_", 6)) {
+            fprintf(txt, "%s", prefix);
+         } else {
+            for (i=0; i<count; i++) {
+               for (k=0; (p + k < q) && (defined[i][k] == p[k]); k++);
+               if ((p + k == q) && !is_ident(defined[i][k])) break;
+            }
+            if (i < count) fprintf(txt, "%s", upper);
+         }
+         fwrite(p, 1, q - p, txt);
+         p = q;
+      } else {
+         fputc(*p++, txt);
+      }
+   }
+
+   free(defined);
+   free(text);
+}
+
+
+static void print_system_resources(FILE *txt, system_struct *sys, char *system_name)
+{
+   // the interconnect in <system_name>.v, each path an axi_slave_interface
+   // on the full address with its slices, the accelerator select delayed
+   // to the path latency and the read data of faster accelerators delayed
+   // to it.  The accelerators are estimated in their own .res files.
+
+   accel_entry *ap;
+   int data_bits = 8 << sys->accel[0].bw_bits;
+   int slice_bits[5];
+   long flops, total = 0, mux_inputs = 0, levels = 0, l;
+   int latency;
+   int n;
+   int p, i, c;
+
+   slice_bits[0] = slice_bits[3] = 1 + sys->id_bits + 32 + 8 + 3 + 2 + 1 + 4 + 3;
+   slice_bits[1] = 1 + sys->id_bits + data_bits + data_bits/8 + 1;
+   slice_bits[2] = 1 + sys->id_bits + 2;
+   slice_bits[4] = 1 + sys->id_bits + data_bits + 2 + 1;
+
+   fprintf(txt, "# resource estimate of the interconnect %s, written by if_gen_axi \n", system_name);
+   fprintf(txt, "# the accelerators are in cat_accel_<instance>.res with resources set \n");
+   fprintf(txt, "# \n");
+   fprintf(txt, "# module %s \n", system_name);
+   fprintf(txt, "  %-24s %10s %10s %10s \n", "path", "flops", "mux_inputs", "levels");
+
+   for (p=0; p<sys->paths; p++) {
+      latency = path_latency(sys, p);
+      n = 0;
+      flops = slave_flops(0, 32, data_bits, sys->id_bits, latency);
+      for (c=0; c<5; c++) {
+         if (sys->slice[c]) flops += ((sys->slice[c] == 3) ? 2 : 1) * (slice_bits[c] + 1);
+      }
+      for (i=0; i<sys->count; i++) {
+         ap = &sys->accel[i];
+         if (ap->path != p) continue;
+         n++;
+         flops += (latency - ap->latency) * data_bits;
+      }
+      flops += n * latency;
+      l = (log2_ceil(n + 1) + sys->cal.mux_bits - 1) / sys->cal.mux_bits;
+      fprintf(txt, "  p%-23d %10ld %10d %10ld \n", p, flops, n, l);
+      total += flops;
+      mux_inputs += n;
+      if (l > levels) levels = l;
+   }
+   print_resource_totals(txt, &sys->cal, system_name, total, mux_inputs, 0, levels);
+}
+
+
+static void generate_system(char *filename, char *system_name, char **cli_options, int cli_option_count)
+{
+   static system_struct sys;
+   signal_struct *signals;
+   signal_struct *next_signal;
+   accel_entry *ap;
+   FILE *txt;
+   FILE *header;
+   char buf[STRLEN];
+   char guard[STRLEN];
+   char accel_name[NAMELEN];
+   int i, j;
+
+   if (!parse_system(filename, &sys)) return;
+
+   for (i=0; i<cli_option_count; i++) {
+      if (0 == strcmp(cli_options[2*i] + 1, "paths")) {
+         sys.paths = atoi(cli_options[2*i+1]);
+         if (!valid_number_str(cli_options[2*i+1]) || (sys.paths < 1) || (sys.paths > MAX_PATHS)) {
+            fprintf(stderr, "paths must be from 1 to %d: %s \n", MAX_PATHS, cli_options[2*i+1]);
+            return;
+         }
+      }
+   }
+
+   // the paths take their register slices, and the interconnect its
+   // resource options, from the system defaults and the command line, not
+   // from the spec of any one accelerator
+
+   default_options(&options);
+   for (i=0; i<sys.default_count; i++) {
+      if (!set_option(sys.default_ptrs[2*i], sys.default_ptrs[2*i+1])) return;
+   }
+   for (i=0; i<cli_option_count; i++) {
+      for (j=0; j<5; j++) {
+         if (0 == strcmp(cli_options[2*i] + 1, slice_options[j])) {
+            if (!set_option(cli_options[2*i] + 1, cli_options[2*i+1])) return;
+         }
+      }
+      if (!strcmp(cli_options[2*i] + 1, "id_bits") || !strcmp(cli_options[2*i] + 1, "resources") ||
+          !strcmp(cli_options[2*i] + 1, "calibration")) {
+         if (!set_option(cli_options[2*i] + 1, cli_options[2*i+1])) return;
+      }
+   }
+   memcpy(sys.slice, options.slice, sizeof(sys.slice));
+   sys.id_bits   = options.id_bits;
+   sys.resources = options.resources || options.calibration[0];
+   memcpy(&sys.cal, &options.cal, sizeof(sys.cal));
+
+   // size every window first, nothing is written unless the map is clean
+
+   for (i=0; i<sys.count; i++) {
+      ap = &sys.accel[i];
+      signals = load_interface(ap->spec_filename, sys.default_ptrs, sys.default_count, cli_options, cli_option_count);
+      if (!signals) {
+         fprintf(stderr, "in %s for %s \n", ap->spec_filename, ap->instance_name);
+         return;
+      }
+      ap->window_bits = slave_bits(signals);
+      ap->bw_bits     = options.bw_bits;
+      ap->latency     = read_latency(signals);
+      ap->registers   = register_count(signals);
+      while (signals) {
+         next_signal = signals->next;
+         free(signals);
+         signals = next_signal;
+      }
+   }
+   if (!check_system(&sys)) return;
+
+   sprintf(buf, "%s.map", system_name);
+   txt = fopen(buf, "w");
+   if (!txt) {
+      fprintf(stderr, "Unable to open file %s for writing. \n", buf);
+      perror("if_gen");
+      return;
+   }
+   print_system_map(txt, &sys, system_name);
+   fclose(txt);
+
+   if (sys.resources) {
+      sprintf(buf, "%s.res", system_name);
+      txt = fopen(buf, "w");
+      if (!txt) {
+         fprintf(stderr, "Unable to open file %s for writing. \n", buf);
+         perror("if_gen");
+         return;
+      }
+      print_system_resources(txt, &sys, system_name);
+      fclose(txt);
+   }
+
+   sprintf(buf, "%s.v", system_name);
+   txt = fopen(buf, "w");
+   if (!txt) {
+      fprintf(stderr, "Unable to open file %s for writing. \n", buf);
+      perror("if_gen");
+      return;
+   }
+   print_system_verilog(txt, &sys, system_name);
+   fclose(txt);
+
+   sprintf(buf, "%s.sw.h", system_name);
+   txt = fopen(buf, "w");
+   if (!txt) {
+      fprintf(stderr, "Unable to open file %s for writing. \n", buf);
+      perror("if_gen");
+      return;
+   }
+   uppercase(system_name, guard);
+   fprintf(txt, "/*************************************************************************** \n");
+   fprintf(txt, " *  %s accelerators header                                              \n", system_name);
+   fprintf(txt, " ***************************************************************************/\n");
+   fprintf(txt, "   \n");
+   fprintf(txt, "#ifndef %s_SW_H \n", guard);
+   fprintf(txt, "#define %s_SW_H \n", guard);
+   fprintf(txt, "   \n");
+   fprintf(txt, "// each accelerator below is its own header with every name prefixed by the \n");
+   fprintf(txt, "// instance, <INSTANCE>_GO, <INSTANCE>_<NAME>_REG, <instance>_accel_service() \n");
+   fprintf(txt, "// and so on.  ACCEL_SHADOW, ACCEL_TRACE and ACCEL_STATS switch them all. \n");
+   fprintf(txt, "   \n");
+   fprintf(txt, "#define %s_ACCELERATORS", guard);
+   for (i=strlen(guard); i<26; i++) fprintf(txt, " ");
+   fprintf(txt, " %d \n", sys.count);
+   fprintf(txt, "#define %s_PATHS", guard);
+   for (i=strlen(guard); i<33; i++) fprintf(txt, " ");
+   fprintf(txt, " %d \n", sys.paths);
+
+   // the accelerators, each header through a temporary file
+
+   for (i=0; i<sys.count; i++) {
+      ap = &sys.accel[i];
+      signals = load_interface(ap->spec_filename, sys.default_ptrs, sys.default_count, cli_options, cli_option_count);
+      if (!signals) break;
+
+      snprintf(accel_name, sizeof(accel_name), "cat_accel_%s", ap->instance_name);
+      print_accelerator(signals, ap->instance_name, ap->module_name, accel_name);
+
+      header = tmpfile();
+      if (!header) {
+         fprintf(stderr, "Unable to open a temporary file for the header of %s \n", ap->instance_name);
+         perror("if_gen");
+      } else {
+         print_header_file(header, signals, ap->base);
+         fprintf(txt, "   \n");
+         fprintf(txt, "   \n");
+         fprintf(txt, "/*************************************************************************** \n");
+         fprintf(txt, " *  %s, cat_accel_%s at 0x%08x on path %d \n", ap->instance_name, ap->instance_name, ap->base, ap->path);
+         fprintf(txt, " ***************************************************************************/\n");
+         fprintf(txt, "   \n");
+         uppercase(ap->instance_name, buf);
+         fprintf(txt, "#define %s_WINDOW_BYTES", buf);
+         for (j=strlen(buf); j<24; j++) fprintf(txt, " ");
+         fprintf(txt, " 0x%08llx \n", 1ull << ap->window_bits);
+         fprintf(txt, "#define %s_PATH", buf);
+         for (j=strlen(buf); j<32; j++) fprintf(txt, " ");
+         fprintf(txt, " %d \n", ap->path);
+         fprintf(txt, "   \n");
+         print_namespaced(txt, header, ap->instance_name);
+         fclose(header);
+      }
+
+      while (signals) {
+         next_signal = signals->next;
+         free(signals);
+         signals = next_signal;
+      }
+   }
+
+   fprintf(txt, "   \n");
+   fprintf(txt, "#endif \n");
+   fclose(txt);
+}
+
+
 void make_filenames(char *spec_filename, char *header_filename)
 {
     char *p;
@@ -895,21 +5991,297 @@ void make_filenames(char *spec_filename, char *header_filename)
 }
 
 
+// sweep mode: every combination of a set of option values, each generated
+// into its own directory and ranked by the analytic model
+
+#define MAX_AXES     16
+#define MAX_VALUES   16
+#define MAX_VARIANTS 4096
+
+typedef struct {
+   int  axes;
+   char name[MAX_AXES][STRLEN];
+   int  count[MAX_AXES];
+   char value[MAX_AXES][MAX_VALUES][64];
+} sweep_struct;
+
+typedef struct {
+   int  variant;
+   int  index[MAX_AXES];
+   int  burst;
+   estimate_struct e;
+} sweep_result;
+
+
+static int parse_sweep(char *filename, sweep_struct *sw)
+{
+   /*
+    * file should have the following format:
+    *
+    * <option_name> = <value> [, <value> ...]
+    *
+    * for any option of the specification file, plus "burst", the beats
+    * per host burst the model assumes (default 16)
+    */
+
+   FILE *sweep_spec;
+   char line[STRLEN];
+   char *value;
+   char *r;
+   int line_no = 0;
+   int n;
+
+   sw->axes = 0;
+
+   sweep_spec = fopen(filename, "r");
+   if (!sweep_spec) {
+      fprintf(stderr, "Unable to open file %s for reading \n", filename);
+      perror("if_gen");
+      return 0;
+   }
+
+   while (fgets(line, sizeof(line), sweep_spec)) {
+      line_no++;
+
+      clean_whitespace(line);
+      if (strlen(line) == 0) continue;
+      if (comment(line)) continue;
+
+      if (!(value = strchr(line, '='))) {
+         fprintf(stderr, "Expected <option> = <value>, ... at line %d \n", line_no);
+         return 0;
+      }
+      *value++ = 0;
+      clean_whitespace(line);
+      lowercase(line);
+      if (!valid_signal_name(line)) {
+         fprintf(stderr, "Invalid option name at line %d: %s \n", line_no, line);
+         return 0;
+      }
+      if (sw->axes == MAX_AXES) {
+         fprintf(stderr, "More than %d options at line %d \n", MAX_AXES, line_no);
+         return 0;
+      }
+      strcpy(sw->name[sw->axes], line);
+      n = 0;
+      for (r=strtok(value, ","); r; r=strtok(NULL, ",")) {
+         clean_whitespace(r);
+         if ((n == MAX_VALUES) || (strlen(r) == 0) || (strlen(r) >= 64)) {
+            fprintf(stderr, "Invalid or more than %d values at line %d \n", MAX_VALUES, line_no);
+            return 0;
+         }
+         strcpy(sw->value[sw->axes][n++], r);
+      }
+      if (!n) {
+         fprintf(stderr, "No values at line %d \n", line_no);
+         return 0;
+      }
+      sw->count[sw->axes++] = n;
+   }
+
+   fclose(sweep_spec);
+   return 1;
+}
+
+
+static int compare_results(const void *a, const void *b)
+{
+   // fastest bursts first, then the shortest register read, then the fewest flops
+
+   const sweep_result *x = (const sweep_result *) a;
+   const sweep_result *y = (const sweep_result *) b;
+
+   if (x->e.burst_rate != y->e.burst_rate) return (x->e.burst_rate < y->e.burst_rate) ? 1 : -1;
+   if (x->e.read_cycles != y->e.read_cycles) return x->e.read_cycles - y->e.read_cycles;
+   if (x->e.flops != y->e.flops) return x->e.flops - y->e.flops;
+   return x->variant - y->variant;
+}
+
+
+static void generate_sweep(char *filename, char *instance_name, char *spec_filename, int base_address, char *module_name,
+                           char **cli_options, int cli_option_count)
+{
+   static sweep_struct sw;
+   static sweep_result results[MAX_VARIANTS];
+   static char names[MAX_AXES][STRLEN];
+   char *args[2 * (64 + MAX_AXES)];
+   char dir[STRLEN];
+   char cwd[STRLEN];
+   char buf[STRLEN];
+   char header_filename[STRLEN];
+   signal_struct *signals;
+   signal_struct *next_signal;
+   sweep_result *rp;
+   FILE *txt;
+   int variants = 1;
+   int done = 0;
+   int n, v, a, i;
+
+   if (!parse_sweep(filename, &sw)) return;
+
+   for (a=0; a<sw.axes; a++) {
+      variants *= sw.count[a];
+      if (variants > MAX_VARIANTS) {
+         fprintf(stderr, "More than %d variants in %s \n", MAX_VARIANTS, filename);
+         return;
+      }
+      sprintf(names[a], "-%s", sw.name[a]);
+   }
+   if (cli_option_count > 64) {
+      fprintf(stderr, "Too many options \n");
+      return;
+   }
+   if (!getcwd(cwd, sizeof(cwd))) {
+      perror("if_gen");
+      return;
+   }
+
+   // the header is named after the spec file, written in each directory
+   strcpy(buf, (strrchr(spec_filename, '/')) ? strrchr(spec_filename, '/') + 1 : spec_filename);
+   make_filenames(buf, header_filename);
+
+   if (snprintf(dir, sizeof(dir), "%s_sweep", module_name) >= (int) sizeof(dir)) {
+      fprintf(stderr, "Module name %s is too long for the sweep directory \n", module_name);
+      return;
+   }
+   mkdir(dir, 0777);
+
+   for (v=0; v<variants; v++) {
+      rp = &results[done];
+      rp->variant = v;
+      rp->burst = 16;
+
+      // the swept values win over the spec file and the command line
+      for (n=0; n<cli_option_count; n++) {
+         args[2*n] = cli_options[2*n];
+         args[2*n+1] = cli_options[2*n+1];
+      }
+      i = v;
+      for (a=0; a<sw.axes; a++) {
+         rp->index[a] = i % sw.count[a];
+         i /= sw.count[a];
+         if (0 == strcmp(sw.name[a], "burst")) {
+            rp->burst = atoi(sw.value[a][rp->index[a]]);
+            if (!valid_number_str(sw.value[a][rp->index[a]]) || (rp->burst < 1) || (rp->burst > 256)) {
+               fprintf(stderr, "burst must be from 1 to 256: %s \n", sw.value[a][rp->index[a]]);
+               return;
+            }
+            continue;
+         }
+         args[2*n] = names[a];
+         args[2*n+1] = sw.value[a][rp->index[a]];
+         n++;
+      }
+
+      signals = load_interface(spec_filename, NULL, 0, args, n);
+      if (!signals) {
+         fprintf(stderr, "variant v%d left out \n", v);
+         continue;
+      }
+      estimate(signals, rp->burst, &rp->e);
+
+      if (snprintf(buf, sizeof(buf), "%s/v%d", dir, v) >= (int) sizeof(buf)) {
+         fprintf(stderr, "Sweep directory %s is too long \n", dir);
+         return;
+      }
+      mkdir(buf, 0777);
+      if (chdir(buf)) {
+         fprintf(stderr, "Unable to enter %s \n", buf);
+         perror("if_gen");
+      } else {
+         print_accelerator(signals, instance_name, module_name, module_name);
+         txt = fopen(header_filename, "w");
+         if (!txt) {
+            fprintf(stderr, "Unable to open file %s/%s for writing. \n", buf, header_filename);
+            perror("if_gen");
+         } else {
+            print_header_file(txt, signals, base_address);
+            fclose(txt);
+         }
+         if (chdir(cwd)) perror("if_gen");
+         done++;
+      }
+
+      while (signals) {
+         next_signal = signals->next;
+         free(signals);
+         signals = next_signal;
+      }
+   }
+
+   qsort(results, done, sizeof(sweep_result), compare_results);
+
+   if (snprintf(buf, sizeof(buf), "%s/ranking.txt", dir) >= (int) sizeof(buf)) {
+      fprintf(stderr, "Sweep directory %s is too long \n", dir);
+      return;
+   }
+   txt = fopen(buf, "w");
+   if (!txt) {
+      fprintf(stderr, "Unable to open file %s for writing. \n", buf);
+      perror("if_gen");
+      return;
+   }
+   fprintf(txt, "# %d variants of %s from %s, written by if_gen_axi \n", done, spec_filename, filename);
+   fprintf(txt, "# read and write in cycles for a single beat register access, B/cyc in bytes \n");
+   fprintf(txt, "# per cycle over the register bank, chan and dma in elements per cycle through \n");
+   fprintf(txt, "# a polled register channel and a DMA fed channel.  Fastest bursts first, then \n");
+   fprintf(txt, "# the shortest read, then the fewest flops. \n");
+   fprintf(txt, "# \n");
+   fprintf(txt, "# %4s %-6s", "rank", "dir");
+   for (a=0; a<sw.axes; a++) fprintf(txt, " %*s", (int) ((strlen(sw.name[a]) > 8) ? strlen(sw.name[a]) : 8), sw.name[a]);
+   fprintf(txt, " %5s %5s %7s %6s %6s %8s %9s %5s \n", "read", "write", "B/cyc", "chan", "dma", "flops", "ram_bits", "mux");
+   for (i=0; i<done; i++) {
+      rp = &results[i];
+      sprintf(buf, "v%d", rp->variant);
+      fprintf(txt, "  %4d %-6s", i + 1, buf);
+      for (a=0; a<sw.axes; a++) {
+         fprintf(txt, " %*s", (int) ((strlen(sw.name[a]) > 8) ? strlen(sw.name[a]) : 8), sw.value[a][rp->index[a]]);
+      }
+      fprintf(txt, " %5d %5d %7.2f %6.3f", rp->e.read_cycles, rp->e.write_cycles, rp->e.burst_rate, rp->e.channel_rate);
+      if (rp->e.dma_rate > 0) fprintf(txt, " %6.3f", rp->e.dma_rate);
+      else                    fprintf(txt, " %6s", "-");
+      fprintf(txt, " %8d %9d %5d \n", rp->e.flops, rp->e.ram_bits, rp->e.mux_inputs);
+   }
+   fclose(txt);
+}
+
+
 main(int argc, char **argv)
 {
-    int i;
     signal_struct *signals;
     signal_struct *next_signal;
-    FILE *verilog_file;
     FILE *header_file;
-    char filename[STRLEN];
-    char verilog_filename[STRLEN];
     char header_filename[STRLEN];
     char module_name[STRLEN] = DEFAULT_MODULE_NAME;
+    char *system_filename = NULL;
+    char *sweep_filename = NULL;
     int accelerator_base_address;
+    char **cli_options;
+    int cli_option_count = 0;
+
+    // "-name value" pairs ahead of the positional arguments override the
+    // options given in the specification file
+
+    cli_options = argv + 1;
+    while ((argc >= 3) && (argv[1][0] == '-')) {
+       if (0 == strcmp(argv[1], "-system")) system_filename = argv[2];
+       if (0 == strcmp(argv[1], "-sweep"))  sweep_filename = argv[2];
+       cli_option_count++;
+       argv += 2;
+       argc -= 2;
+    }
+
+    // a system takes only its name, any other count falls to the usage below
+
+    if (system_filename && (argc == 2)) {
+       generate_system(system_filename, argv[1], cli_options, cli_option_count);
+       return 0;
+    }
   
     if ((argc != 4) && (argc != 5)) {
-       fprintf(stderr, "Usage: %s: <instance_name> <signal specification file> <base_address> [<module_name>] \n", argv[0]);
+       fprintf(stderr, "Usage: %s: [-<option> <value> ...] <instance_name> <signal specification file> <base_address> [<module_name>] \n", cli_options[-1]);
+       fprintf(stderr, "       %s: [-<option> <value> ...] -system <system specification file> <system_name> \n", cli_options[-1]);
+       fprintf(stderr, "       %s: [-<option> <value> ...] -sweep <sweep file> <instance_name> <signal specification file> <base_address> [<module_name>] \n", cli_options[-1]);
        return;
     }
 
@@ -924,41 +6296,26 @@ main(int argc, char **argv)
        strcpy(module_name, argv[4]);
     }
 
-    // modulename and filename must match for VCS
-
-    strcpy(verilog_filename, module_name);
-    strcat(verilog_filename, ".v");
+    if (sweep_filename) {
+       generate_sweep(sweep_filename, argv[1], argv[2], accelerator_base_address, module_name, cli_options, cli_option_count);
+       return 0;
+    }
 
     make_filenames(argv[2], header_filename);
 
-    verilog_file = fopen(verilog_filename, "w");
-    if (!verilog_filename) {
-        fprintf(stderr, "Unable to open file %d for writing. \n", verilog_filename);
-        perror("if_gen");
-        return;
-    }
-       
-    header_file = fopen(header_filename, "w");
-    if (!header_file) {
-        fprintf(stderr, "Unable to open file %d for writing. \n", header_filename);
-        perror("if_gen");
-        return;
-    }
-       
-
-    signals = parse_interface(argv[2]);
+    signals = load_interface(argv[2], NULL, 0, cli_options, cli_option_count);
 
     if (signals) {
-       if (has_master(signals)) print_defines(verilog_file, signals);
-       print_intro(verilog_file, signals, argv[1]);
-       print_signals(verilog_file, signals);
-       print_register_map(verilog_file, signals);
-       print_assignments(verilog_file, signals);
-       print_register_accesses(verilog_file, signals);
-       print_ready_valids(verilog_file, signals);
-       print_catapult_instantiation(verilog_file, signals, argv[1], module_name);
-       print_epilog(verilog_file);
-       print_header_file(header_file, signals, accelerator_base_address);
+       print_accelerator(signals, argv[1], module_name, module_name);
+
+       header_file = fopen(header_filename, "w");
+       if (!header_file) {
+          fprintf(stderr, "Unable to open file %s for writing. \n", header_filename);
+          perror("if_gen");
+       } else {
+          print_header_file(header_file, signals, accelerator_base_address);
+          fclose(header_file);
+       }
     }
 
     while (signals) {
@@ -2,7 +2,7 @@
 `timescale 1ns/1ns
 
 module addr_gen
-    ( 
+    (
         CLK,
         RESETn,
 
@@ -14,92 +14,155 @@ module addr_gen
         START,
         NEXT,
 
-        ADDR_OUT
+        ADDR_OUT,
+        ADDR_LIST,
+        ADDR_VALID,
+
+        BANK_ADDR,
+        BANK_VALID,
+        COUNT
     );
 
     parameter p_size = 4;   // width of peripheral in 2^p_size bytes
-
-    input           CLK;
-    input           RESETn;
-
-    input  [11:0]   ADDR;
-    input  [7:0]    LEN;
-    input  [2:0]    SIZE;
-    input  [1:0]    BURST;
-
-    input           START;
-    input           NEXT;
-
-    output [11:0]   ADDR_OUT;
-
-    reg    [11:0]   start_address;
-    reg    [11:0]   current_address;
-    reg    [11:0]   bytes_per_beat;
-    reg    [11:0]   number_of_beats;
-    reg    [11:0]   orig_bytes_per_beat;
-    reg    [11:0]   orig_number_of_beats;
-    reg             fixed;
-    reg             incr;
-    reg             wrap;
-    reg    [11:0]   total_bytes;
-    reg    [11:0]   fixed_mask;
-    reg    [11:0]   var_mask;
-    reg    [11:0]   count;
-
-    reg    [31:0]   one = 32'h00000001;
-
-    assign ADDR_OUT = ((start_address & fixed_mask) | (current_address & var_mask)); 
+    parameter a_bits = 12;  // width of the byte address
+    parameter ports  = 1;   // beat addresses produced per cycle
+    parameter banked = 0;   // 0: port n gets beat n (dual port SRAM), 1: port n is the bank holding words with address n modulo ports
+
+`define ag_count_bits (ports > 1 ? $clog2(ports+1) : 1)
+`define ag_bank_bits  (ports > 1 ? $clog2(ports) : 1)
+
+    input                        CLK;
+    input                        RESETn;
+
+    input  [a_bits-1:0]          ADDR;
+    input  [7:0]                 LEN;
+    input  [2:0]                 SIZE;
+    input  [1:0]                 BURST;
+
+    input                        START;
+    input  [`ag_count_bits-1:0]         NEXT;         // beats taken this cycle, at most COUNT
+
+    output [a_bits-1:0]          ADDR_OUT;     // address of the current beat
+    output [ports*a_bits-1:0]    ADDR_LIST;    // addresses of the current beat and the ports-1 beats after it
+    output [ports-1:0]           ADDR_VALID;   // beats of ADDR_LIST still in the burst
+
+    output [ports*a_bits-1:0]    BANK_ADDR;    // ADDR_LIST routed onto the SRAM ports
+    output [ports-1:0]           BANK_VALID;
+    output [`ag_count_bits-1:0]         COUNT;        // leading beats of ADDR_LIST that can be issued together
+
+    reg    [a_bits-1:0]          start_address;
+    reg    [a_bits-1:0]          current_address;
+    reg    [2:0]                 beat_shift;   // log2 of the bytes moved per peripheral beat
+    reg    [15:0]                number_of_beats;
+    reg    [15:0]                count;
+    reg                          fixed;
+    reg    [a_bits-1:0]          fixed_mask;
+    reg    [a_bits-1:0]          var_mask;
+
+    wire   [15:0]                remaining = number_of_beats - count;
+    wire   [2:0]                 eff_size  = (SIZE > p_size) ? p_size : SIZE;
+    wire   [a_bits-1:0]          aligned   = (SIZE > p_size) ? ADDR & ({a_bits {1'b1}} << SIZE) : ADDR;
+
+    reg    [ports*a_bits-1:0]    bank_addr;
+    reg    [ports-1:0]           bank_valid;
+    reg    [`ag_count_bits-1:0]         issue_count;
+
+    genvar n;
+    integer i, j;
+
+    // the N lookahead addresses are offsets of n beats from the current one,
+    // the bits above the wrap boundary (WRAP) or the bus beat (FIXED) are kept
+    // from the start address
+
+    generate
+        for (n=0; n<ports; n=n+1) begin : lookahead
+            assign ADDR_LIST[a_bits*(n+1)-1:a_bits*n] = 
+                (start_address & fixed_mask) | ((current_address + (n << beat_shift)) & var_mask);
+            assign ADDR_VALID[n] = (remaining > n) ? 1'b1 : 1'b0;
+        end
+    endgenerate
+
+    assign ADDR_OUT   = ADDR_LIST[a_bits-1:0];
+    assign BANK_ADDR  = bank_addr;
+    assign BANK_VALID = bank_valid;
+    assign COUNT      = issue_count;
+
+    // a dual port SRAM takes any run of beats, only a fixed burst is held to
+    // one beat a cycle.  Banks are interleaved on the word address, so beats
+    // are issued in order up to the first one whose bank is already taken.
+
+    always @(*) begin
+        bank_addr   = {ports*a_bits {1'b0}};
+        bank_valid  = {ports {1'b0}};
+        issue_count = 0;
+        if (!banked) begin
+            for (i=0; i<ports; i=i+1) begin
+                if (ADDR_VALID[i] && (issue_count == i) && (!fixed || (i == 0))) begin
+                    bank_addr[a_bits*i +: a_bits] = ADDR_LIST[a_bits*i +: a_bits];
+                    bank_valid[i] = 1'b1;
+                    issue_count   = i + 1;
+                end
+            end
+        end else begin
+            for (i=0; i<ports; i=i+1) begin
+                j = (ports > 1) ? ADDR_LIST[a_bits*i+p_size +: `ag_bank_bits] : 0;
+                if (ADDR_VALID[i] && (issue_count == i) && !bank_valid[j]) begin
+                    bank_addr[a_bits*j +: a_bits] = ADDR_LIST[a_bits*i +: a_bits];
+                    bank_valid[j] = 1'b1;
+                    issue_count   = i + 1;
+                end
+            end
+        end
+    end
 
     always @(posedge CLK) begin
 
         if (RESETn == 0) begin
 
-            start_address      <= 12'h000;
-            current_address    <= 12'h000;
-            bytes_per_beat     <= 12'h000;
-            number_of_beats    <= 12'h000;
+            start_address      <= {a_bits {1'b0}};
+            current_address    <= {a_bits {1'b0}};
+            beat_shift         <= 3'b000;
+            number_of_beats    <= 16'h0000;
+            count              <= 16'h0000;
             fixed              <= 0;
-            incr               <= 0;
-            wrap               <= 0;
-            total_bytes        <= 12'h000;
-            fixed_mask         <= 12'h000;
-            var_mask           <= 12'hFFF;
-            count              <= 12'h000;
+            fixed_mask         <= {a_bits {1'b0}};
+            var_mask           <= {a_bits {1'b1}};
 
         end else begin
 
             if (START) begin
 
-                start_address     <= ADDR;
-                current_address   <= ADDR;
-                orig_bytes_per_beat    <= (1 << SIZE);
-                orig_number_of_beats   <= LEN + 1;
-                bytes_per_beat    <= (1 << ((SIZE > p_size) ? p_size : SIZE));
-                number_of_beats   <= (LEN + one) << ((SIZE > p_size) ? SIZE - p_size : 0);
-                count             <= 0;
+                // bus beats wider than the peripheral are stepped in peripheral sized
+                // pieces, so start on the bus beat boundary and let the strobes mask
+                // any leading bytes of an unaligned first beat
+                start_address     <= aligned;
+                current_address   <= aligned;
+                beat_shift        <= eff_size;
+                number_of_beats   <= ({8'h00, LEN} + 16'h0001) << ((SIZE > p_size) ? SIZE - p_size : 0);
+                count             <= 16'h0000;
 
                 fixed <= (BURST == 2'b00) ? 1 : 0;
-                incr  <= (BURST == 2'b01) ? 1 : 0;
-                wrap  <= (BURST == 2'b10) ? 1 : 0;
 
-                if (BURST == 2'b10) begin 
-                    total_bytes <=   (LEN + 1) << SIZE;
-                    var_mask   <=   ((LEN + 1) << SIZE) - 1;
-                    fixed_mask <= ~(((LEN + 1) << SIZE) - 1);
+                // wrap lengths are 2, 4, 8 or 16 beats so LEN is all ones below its
+                // top bit and the wrap boundary mask needs no adder
+                if (BURST == 2'b10) begin
+                    var_mask   <=   (LEN << SIZE) | ~({a_bits {1'b1}} << SIZE);
+                    fixed_mask <= ~((LEN << SIZE) | ~({a_bits {1'b1}} << SIZE));
+                end else if (BURST == 2'b00) begin
+                    var_mask   <=   ~({a_bits {1'b1}} << SIZE);
+                    fixed_mask <=    {a_bits {1'b1}} << SIZE;
                 end else begin
-                    total_bytes <=   (LEN + 1) << SIZE;
-                    var_mask   <=    12'hFFF;
-                    fixed_mask <=    12'h000;
+                    var_mask   <=    {a_bits {1'b1}};
+                    fixed_mask <=    {a_bits {1'b0}};
                 end
 
             end else begin
-                if (NEXT) begin
-                    count <= count + 1;
-                    if ((count + 1) < number_of_beats) begin
-                        if (incr || wrap) current_address <= current_address + bytes_per_beat;
-                    end 
+                if (NEXT != 0) begin
+                    count <= count + NEXT;
+                    current_address <= current_address + (NEXT << beat_shift);
                 end
             end
         end
-    end   
+    end
 endmodule
+
@@ -0,0 +1,132 @@
+
+`timescale 1ns/1ns
+
+module ahb_lite_slave
+    (
+        HCLK,
+        HRESETn,
+
+        HSEL,
+        HADDR,
+        HTRANS,
+        HWRITE,
+        HSIZE,
+        HBURST,
+        HPROT,
+        HMASTLOCK,
+        HREADY,
+        HWDATA,
+
+        HREADYOUT,
+        HRESP,
+        HRDATA,
+
+        SRAM_READ_ADDRESS,
+        SRAM_READ_DATA,
+        SRAM_OUTPUT_ENABLE,
+
+        SRAM_WRITE_ADDRESS,
+        SRAM_WRITE_DATA,
+        SRAM_WRITE_BYTE_ENABLE,
+        SRAM_WRITE_STROBE
+    );
+
+    parameter width     = 18;     // byte address bits decoded, HSEL selects the window
+    parameter registers = 1;      // words implemented, an access above them is answered ERROR
+
+    // pipelined AHB-Lite slave on a register bank with a one cycle read, the
+    // SRAM side of the AHB generators.  A read goes to the bank in its
+    // address phase and its data is on HRDATA in its data phase, a write goes
+    // to the bank in its data phase, so transfers and bursts run back to back
+    // at one per HCLK with HREADYOUT high.  A read of the word written in the
+    // data phase beside it waits one cycle to see the write.  An access above
+    // the registers or wider than 32 bits is not made and is answered with
+    // the two cycle ERROR response.  HBURST, HPROT and HMASTLOCK are ignored,
+    // the master gives the address of every beat.
+
+    input                   HCLK;
+    input                   HRESETn;
+
+    input                   HSEL;
+    input  [31:0]           HADDR;
+    input  [1:0]            HTRANS;
+    input                   HWRITE;
+    input  [2:0]            HSIZE;
+    input  [2:0]            HBURST;
+    input  [3:0]            HPROT;
+    input                   HMASTLOCK;
+    input                   HREADY;
+    input  [31:0]           HWDATA;
+
+    output                  HREADYOUT;
+    output                  HRESP;
+    output [31:0]           HRDATA;
+
+    output [width-3:0]      SRAM_READ_ADDRESS;
+    input  [31:0]           SRAM_READ_DATA;
+    output                  SRAM_OUTPUT_ENABLE;
+
+    output [width-3:0]      SRAM_WRITE_ADDRESS;
+    output [31:0]           SRAM_WRITE_DATA;
+    output [3:0]            SRAM_WRITE_BYTE_ENABLE;
+    output                  SRAM_WRITE_STROBE;
+
+    reg                     d_write;          // data phase of a write
+    reg                     d_late;           // read held back a cycle behind a write
+    reg                     d_error;          // first and second cycle of ERROR
+    reg                     d_error2;
+    reg    [width-3:0]      d_addr;
+    reg    [3:0]            d_be;
+
+    wire                    transfer = HSEL && HTRANS[1] && HREADY;   // NONSEQ or SEQ
+    wire   [width-3:0]      word     = HADDR[width-1:2];
+    wire                    bad      = (word >= registers) || (HSIZE > 3'b010);
+    wire                    read     = transfer && !HWRITE && !bad;
+    wire                    write    = transfer && HWRITE && !bad;
+    wire                    late     = read && d_write && (word == d_addr);
+    reg    [3:0]            be;
+
+    always @(*) begin
+        case (HSIZE)
+            3'b000:  be = 4'b0001 << HADDR[1:0];
+            3'b001:  be = (HADDR[1]) ? 4'b1100 : 4'b0011;
+            default: be = 4'b1111;
+        endcase
+    end
+
+    assign HREADYOUT = !(d_late || d_error);
+    assign HRESP     = d_error || d_error2;
+    assign HRDATA    = SRAM_READ_DATA;
+
+    assign SRAM_READ_ADDRESS      = (d_late) ? d_addr : word;
+    assign SRAM_OUTPUT_ENABLE     = (read && !late) || d_late;
+    assign SRAM_WRITE_ADDRESS     = d_addr;
+    assign SRAM_WRITE_DATA        = HWDATA;
+    assign SRAM_WRITE_BYTE_ENABLE = d_be;
+    assign SRAM_WRITE_STROBE      = d_write;
+
+    always @(posedge HCLK) begin
+        if (HRESETn == 0) begin
+            d_write  <= 1'b0;
+            d_late   <= 1'b0;
+            d_error  <= 1'b0;
+            d_error2 <= 1'b0;
+        end else if (HREADY) begin
+            // the data phase ends, the address phase beside it moves up
+            d_write  <= write;
+            d_late   <= late;
+            d_error  <= transfer && bad;
+            d_error2 <= 1'b0;
+            if (transfer) begin
+                d_addr <= word;
+                d_be   <= be;
+            end
+        end else begin
+            // a wait state of this slave, the late read is made now
+            d_late   <= 1'b0;
+            d_error  <= 1'b0;
+            d_error2 <= d_error;
+        end
+    end
+
+endmodule
@@ -0,0 +1,104 @@
+
+`timescale 1ns/1ns
+
+module async_fifo
+    (
+        WCLK,
+        WRESETn,
+        WVALID,
+        WDATA,
+        WREADY,
+
+        RCLK,
+        RRESETn,
+        RVALID,
+        RDATA,
+        RREADY
+    );
+
+    parameter width = 8;
+    parameter depth = 4;            // number of entries, a power of 2 from 4 up
+    `define af_abits $clog2(depth)
+
+    // dual clock first word fall through FIFO.  The pointers cross between the
+    // clocks in gray code through two flops, so FULL and empty are pessimistic
+    // for two cycles of the other clock.  An entry is only read once the write
+    // pointer past it has crossed, so the memory read needs no synchroniser.
+
+    input                   WCLK;
+    input                   WRESETn;
+    input                   WVALID;
+    input  [width-1:0]      WDATA;
+    output                  WREADY;
+
+    input                   RCLK;
+    input                   RRESETn;
+    output                  RVALID;
+    output [width-1:0]      RDATA;
+    input                   RREADY;
+
+    reg    [width-1:0]      fifo_mem[depth-1:0];
+
+    reg    [`af_abits:0]    wbin;
+    reg    [`af_abits:0]    wgray;
+    reg    [`af_abits:0]    rgray_w1;
+    reg    [`af_abits:0]    rgray_w2;
+    reg                     full;
+
+    reg    [`af_abits:0]    rbin;
+    reg    [`af_abits:0]    rgray;
+    reg    [`af_abits:0]    wgray_r1;
+    reg    [`af_abits:0]    wgray_r2;
+    reg                     empty;
+
+    wire                    push = WVALID && !full;
+    wire                    pop  = RREADY && !empty;
+    wire   [`af_abits:0]    wbin_next  = wbin + ((push) ? 1 : 0);
+    wire   [`af_abits:0]    wgray_next = (wbin_next >> 1) ^ wbin_next;
+    wire   [`af_abits:0]    rbin_next  = rbin + ((pop) ? 1 : 0);
+    wire   [`af_abits:0]    rgray_next = (rbin_next >> 1) ^ rbin_next;
+
+    assign WREADY = !full;
+    assign RVALID = !empty;
+    assign RDATA  = fifo_mem[rbin[`af_abits-1:0]];
+
+    always @(posedge WCLK) begin
+        if (push) fifo_mem[wbin[`af_abits-1:0]] <= WDATA;
+    end
+
+    // full when the write pointer is a lap ahead, in gray code the top two
+    // bits differ from the read pointer and the rest match
+
+    always @(posedge WCLK) begin
+        if (WRESETn == 0) begin
+            wbin     <= 0;
+            wgray    <= 0;
+            rgray_w1 <= 0;
+            rgray_w2 <= 0;
+            full     <= 1'b0;
+        end else begin
+            wbin     <= wbin_next;
+            wgray    <= wgray_next;
+            rgray_w1 <= rgray;
+            rgray_w2 <= rgray_w1;
+            full     <= (wgray_next == (rgray_w2 ^ (2'b11 << (`af_abits-1)))) ? 1'b1 : 1'b0;
+        end
+    end
+
+    always @(posedge RCLK) begin
+        if (RRESETn == 0) begin
+            rbin     <= 0;
+            rgray    <= 0;
+            wgray_r1 <= 0;
+            wgray_r2 <= 0;
+            empty    <= 1'b1;
+        end else begin
+            rbin     <= rbin_next;
+            rgray    <= rgray_next;
+            wgray_r1 <= wgray;
+            wgray_r2 <= wgray_r1;
+            empty    <= (rgray_next == wgray_r2) ? 1'b1 : 1'b0;
+        end
+    end
+
+endmodule
@@ -24,6 +24,9 @@ module axi_addr_latch
             O_ID,
             O_ADDR,
             O_LAST,
+            O_FIRST,
+            O_BEAT_LAST,
+            O_LOCK,
 
             O_VALID,
             O_READY
@@ -32,14 +35,16 @@ module axi_addr_latch
     parameter masters = 4;   // number of masters on the AXI fabric, needed to determine width of "return address"
     parameter width = 22;    // number of address bits in peripheral
     parameter p_size = 4;    // width of peripheral interface in 2^p_size bytes (defaults to 16)
+    parameter id_bits = `slave_id_bits;
+    parameter b_size = $clog2(`strb_bits);   // width of the bus in 2^b_size bytes
 
-`define FIFO_WIDTH (masters + `slave_id_bits + width + `len_bits + `size_bits + `burst_bits + `lock_bits + `cache_bits + `prot_bits)
+`define FIFO_WIDTH (masters + id_bits + width + `len_bits + `size_bits + `burst_bits + `lock_bits + `cache_bits + `prot_bits)
 
     input                           CLK;
     input                           RESETN;
 
     input  [masters-1:0]            MASTER;
-    input  [`slave_id_bits-1:0]     ID;
+    input  [id_bits-1:0]            ID;
     input  [width-1:0]              ADDR;
     input  [`len_bits-1:0]          LEN;
     input  [`size_bits-1:0]         SIZE;
@@ -52,9 +57,12 @@ module axi_addr_latch
     output                          READY;
 
     output [masters-1:0]            O_MASTER;
-    output [`slave_id_bits-1:0]     O_ID;
+    output [id_bits-1:0]            O_ID;
     output [width-1:0]              O_ADDR;
     output                          O_LAST;
+    output                          O_FIRST;        // first peripheral beat of the burst
+    output                          O_BEAT_LAST;    // last peripheral beat of the current bus beat
+    output [`lock_bits-1:0]         O_LOCK;         // LOCK of the burst being stepped
 
     output                          O_VALID;
     input                           O_READY;
@@ -66,7 +74,7 @@ module axi_addr_latch
     wire                            cycle_ready;
 
     reg    [masters-1:0]            L_MASTER;
-    reg    [`slave_id_bits-1:0]     L_ID;
+    reg    [id_bits-1:0]            L_ID;
     reg    [width-1:0]              L_ADDR;
     reg    [`len_bits-1:0]          L_LEN;
     reg    [`size_bits-1:0]         L_SIZE;
@@ -75,32 +83,35 @@ module axi_addr_latch
     reg    [`cache_bits-1:0]        L_CACHE;
     reg    [`prot_bits-1:0]         L_PROT;
 
-    reg                             send_req;
-    reg    [width-1:12]             addr_high_bits;
-    reg    [11:0]                   addr_low_bits;
-    reg    [`strb_bits-1:0]         byte_enables;
+    reg    [masters-1:0]            cur_master;     // burst being stepped, the FIFO head is the next one
+    reg    [id_bits-1:0]            cur_id;
+    reg    [`size_bits-1:0]         cur_size;
+    reg    [`lock_bits-1:0]         cur_lock;
+    wire   [width-1:0]              addr_out;
+    reg    [(1<<b_size)-1:0]        byte_enables;
     reg                             handling_cycle;
-    reg    [4:0]                    number_of_beats;
-    reg    [9:0]                    count;
-    reg    [9:0]                    bytes_per_beat;
-    reg                             start_of_cycle;
+    reg    [15:0]                   number_of_beats;
+    reg    [15:0]                   count;
+    reg    [7:0]                    sub_beats;      // peripheral beats per bus beat, minus one
+    reg    [7:0]                    sub_count;
+    wire                            start_of_cycle;
 
     reg    [31:0]                   one  = 32'h00000001;
     reg    [31:0]                   zero = 32'h00000000;
 
-    reg                             fifo_ack;
-    reg                             next;
-    reg                             last;
+    wire                            next;
+    wire                            last;
+    wire                            beat_last;
     reg                             o_valid;
 
     assign fifo_in = { MASTER, ID, ADDR, LEN, SIZE, BURST, LOCK, CACHE, PROT };
     assign READY = !full;
     assign { L_MASTER, L_ID, L_ADDR, L_LEN, L_SIZE, L_BURST, L_LOCK, L_CACHE, L_PROT } = fifo_out;
 
-    assign O_MASTER           = L_MASTER;
-    assign O_ID               = L_ID;
-    assign O_ADDR[width-1:12] = addr_high_bits;
-    assign O_ADDR[11:0]       = addr_low_bits;
+    assign O_MASTER           = cur_master;
+    assign O_ID               = cur_id;
+    assign O_ADDR             = addr_out;
+    assign O_LOCK             = cur_lock;
     assign O_VALID            = o_valid;
 
     bus_fifo #(`FIFO_WIDTH) fifo0 (
@@ -110,7 +121,7 @@ module axi_addr_latch
             .DATA_IN     (fifo_in), 
             .DATA_READY  (cycle_ready), 
             .DATA_OUT    (fifo_out), 
-            .DATA_ACK    (next & last), 
+            .DATA_ACK    (start_of_cycle), 
             .FULL        (full)
     );
 
@@ -122,77 +133,72 @@ module axi_addr_latch
             .READY       (next)
     );
 */
-    axi_byte_enables be0 (
-            .ADDR        (addr_low_bits),
-            .SIZE        (L_SIZE),
-            .BE          (byte_enables)
+    axi_byte_enables #(b_size) be0 (
+            .ADDR        (addr_out[11:0]),
+            .SIZE        (cur_size),
+            .BE          (byte_enables),
+            .LANE        ()
     );
 
-    addr_gen #(p_size) addr_gen_sram (
+    addr_gen #(p_size, width) addr_gen_sram (
             .CLK         (CLK),
             .RESETn      (RESETN),
-            .ADDR        (L_ADDR[11:0]), 
+            .ADDR        (L_ADDR), 
             .LEN         (L_LEN), 
             .SIZE        (L_SIZE), 
             .BURST       (L_BURST), 
             .START       (start_of_cycle), 
             .NEXT        (next), 
-            .ADDR_OUT    (addr_low_bits)
+            .ADDR_OUT    (addr_out),
+            .ADDR_LIST   (),
+            .ADDR_VALID  (),
+            .BANK_ADDR   (),
+            .BANK_VALID  (),
+            .COUNT       ()
     );
 
-    assign last = ((count + 1 == number_of_beats) && handling_cycle) ? 1 : 0;
-    assign O_LAST = last;
+    // one peripheral beat is handed out per cycle while O_READY is held high,
+    // bus beats wider than the peripheral are split into 2^(SIZE-p_size) beats.
+    // The request is popped when its burst starts, so the next burst is already
+    // at the FIFO head and starts on the cycle the last beat is taken.
 
-    always @(posedge CLK) begin
-        if (!RESETN) begin
-            o_valid <= 0;
-            next <= 0;
-        end else begin
-            if (send_req) o_valid <= 1;
-            if (o_valid && O_READY) begin
-                o_valid <= 0;
-                next <= 1;
-            end
-            if (next) next <= 0;
-        end
-    end
+    assign start_of_cycle = cycle_ready && (!handling_cycle || (next && last));
+    assign next           = o_valid && O_READY;
+    assign last           = ((count + 1 == number_of_beats) && handling_cycle) ? 1 : 0;
+    assign beat_last      = (sub_count == sub_beats) ? 1 : 0;
+
+    assign O_LAST         = last;
+    assign O_FIRST        = (count == 0) ? 1 : 0;
+    assign O_BEAT_LAST    = beat_last;
 
     always @(posedge CLK) begin
         if (!RESETN) begin
-            handling_cycle <= 1'b0;
-            fifo_ack <= 1'b0;
-            send_req <= 1'b0;
-            addr_high_bits <= {width-12 {1'b0}};
-            start_of_cycle <= 1'b0;
-            bytes_per_beat <= 10'b0000000000;
-            number_of_beats <= 5'b00000;
-            count <= zero;
-            fifo_ack <= 1'b0;
-            send_req <= 1'b0;
+            handling_cycle  <= 1'b0;
+            o_valid         <= 1'b0;
+            number_of_beats <= 16'h0000;
+            count           <= 16'h0000;
+            sub_beats       <= 8'h00;
+            sub_count       <= 8'h00;
         end else begin
-            if (!handling_cycle && cycle_ready) begin
-                handling_cycle <= 1;
-                start_of_cycle <= 1;
-                addr_high_bits <= L_ADDR[width-1:12];
-                // bytes_per_beat <= (1 << L_SIZE);
-                // number_of_beats <= (L_LEN + one);
-                bytes_per_beat <= (1 << ((L_SIZE > p_size) ? p_size : L_SIZE));
-                number_of_beats <= (L_LEN + one) << ((L_SIZE > p_size) ? L_SIZE - p_size : 0);
-                count <= zero;
-                fifo_ack <= 1;
-                send_req <= 1;
-            end else begin
-                start_of_cycle <= 0;
-                fifo_ack <= 0;
-                send_req <= 0;
+            if (next) begin
+                count     <= count + 1;
+                sub_count <= (beat_last) ? 8'h00 : sub_count + 1;
+                if (last) begin
+                    handling_cycle <= 0;
+                    o_valid        <= 0;
+                end
             end
-            if (next) begin  
-               if ((count + 1) < number_of_beats) begin
-                   count <= count + 1;
-                   send_req <= 1;
-               end else begin 
-                   handling_cycle <= 0;
-               end
+            if (start_of_cycle) begin
+                handling_cycle  <= 1;
+                o_valid         <= 1;
+                cur_master      <= L_MASTER;
+                cur_id          <= L_ID;
+                cur_size        <= L_SIZE;
+                cur_lock        <= L_LOCK;
+                number_of_beats <= (L_LEN + one) << ((L_SIZE > p_size) ? L_SIZE - p_size : 0);
+                sub_beats       <= (one << ((L_SIZE > p_size) ? L_SIZE - p_size : 0)) - one;
+                count           <= zero;
+                sub_count       <= zero;
             end
         end 
     end 
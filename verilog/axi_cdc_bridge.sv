@@ -0,0 +1,164 @@
+
+`timescale 1ns/1ns
+
+module axi_cdc_bridge
+    (
+        CORE_CLK,
+        CORE_RESETn,
+        BUS_CLK,
+        BUS_RESETn,
+
+        CORE_AW_DATA,
+        CORE_AW_VALID,
+        CORE_AW_READY,
+        BUS_AW_DATA,
+        BUS_AW_VALID,
+        BUS_AW_READY,
+
+        CORE_W_DATA,
+        CORE_W_VALID,
+        CORE_W_READY,
+        BUS_W_DATA,
+        BUS_W_VALID,
+        BUS_W_READY,
+
+        BUS_B_DATA,
+        BUS_B_VALID,
+        BUS_B_READY,
+        CORE_B_DATA,
+        CORE_B_VALID,
+        CORE_B_READY,
+
+        CORE_AR_DATA,
+        CORE_AR_VALID,
+        CORE_AR_READY,
+        BUS_AR_DATA,
+        BUS_AR_VALID,
+        BUS_AR_READY,
+
+        BUS_R_DATA,
+        BUS_R_VALID,
+        BUS_R_READY,
+        CORE_R_DATA,
+        CORE_R_VALID,
+        CORE_R_READY
+    );
+
+    // carries an AXI master port from the core clock to the bus clock, one
+    // async_fifo per channel.  Each channel payload is the concatenation of
+    // its signals other than VALID and READY, packed by the instantiating
+    // module.
+
+    parameter aw_bits = 64;
+    parameter w_bits  = 64;
+    parameter b_bits  = 8;
+    parameter ar_bits = 64;
+    parameter r_bits  = 64;
+    parameter depth   = 4;
+
+    input                   CORE_CLK;
+    input                   CORE_RESETn;
+    input                   BUS_CLK;
+    input                   BUS_RESETn;
+
+    input  [aw_bits-1:0]    CORE_AW_DATA;
+    input                   CORE_AW_VALID;
+    output                  CORE_AW_READY;
+    output [aw_bits-1:0]    BUS_AW_DATA;
+    output                  BUS_AW_VALID;
+    input                   BUS_AW_READY;
+
+    input  [w_bits-1:0]     CORE_W_DATA;
+    input                   CORE_W_VALID;
+    output                  CORE_W_READY;
+    output [w_bits-1:0]     BUS_W_DATA;
+    output                  BUS_W_VALID;
+    input                   BUS_W_READY;
+
+    input  [b_bits-1:0]     BUS_B_DATA;
+    input                   BUS_B_VALID;
+    output                  BUS_B_READY;
+    output [b_bits-1:0]     CORE_B_DATA;
+    output                  CORE_B_VALID;
+    input                   CORE_B_READY;
+
+    input  [ar_bits-1:0]    CORE_AR_DATA;
+    input                   CORE_AR_VALID;
+    output                  CORE_AR_READY;
+    output [ar_bits-1:0]    BUS_AR_DATA;
+    output                  BUS_AR_VALID;
+    input                   BUS_AR_READY;
+
+    input  [r_bits-1:0]     BUS_R_DATA;
+    input                   BUS_R_VALID;
+    output                  BUS_R_READY;
+    output [r_bits-1:0]     CORE_R_DATA;
+    output                  CORE_R_VALID;
+    input                   CORE_R_READY;
+
+    async_fifo #(aw_bits, depth) aw_fifo (
+        .WCLK     (CORE_CLK),
+        .WRESETn  (CORE_RESETn),
+        .WVALID   (CORE_AW_VALID),
+        .WDATA    (CORE_AW_DATA),
+        .WREADY   (CORE_AW_READY),
+        .RCLK     (BUS_CLK),
+        .RRESETn  (BUS_RESETn),
+        .RVALID   (BUS_AW_VALID),
+        .RDATA    (BUS_AW_DATA),
+        .RREADY   (BUS_AW_READY)
+    );
+
+    async_fifo #(w_bits, depth) w_fifo (
+        .WCLK     (CORE_CLK),
+        .WRESETn  (CORE_RESETn),
+        .WVALID   (CORE_W_VALID),
+        .WDATA    (CORE_W_DATA),
+        .WREADY   (CORE_W_READY),
+        .RCLK     (BUS_CLK),
+        .RRESETn  (BUS_RESETn),
+        .RVALID   (BUS_W_VALID),
+        .RDATA    (BUS_W_DATA),
+        .RREADY   (BUS_W_READY)
+    );
+
+    async_fifo #(b_bits, depth) b_fifo (
+        .WCLK     (BUS_CLK),
+        .WRESETn  (BUS_RESETn),
+        .WVALID   (BUS_B_VALID),
+        .WDATA    (BUS_B_DATA),
+        .WREADY   (BUS_B_READY),
+        .RCLK     (CORE_CLK),
+        .RRESETn  (CORE_RESETn),
+        .RVALID   (CORE_B_VALID),
+        .RDATA    (CORE_B_DATA),
+        .RREADY   (CORE_B_READY)
+    );
+
+    async_fifo #(ar_bits, depth) ar_fifo (
+        .WCLK     (CORE_CLK),
+        .WRESETn  (CORE_RESETn),
+        .WVALID   (CORE_AR_VALID),
+        .WDATA    (CORE_AR_DATA),
+        .WREADY   (CORE_AR_READY),
+        .RCLK     (BUS_CLK),
+        .RRESETn  (BUS_RESETn),
+        .RVALID   (BUS_AR_VALID),
+        .RDATA    (BUS_AR_DATA),
+        .RREADY   (BUS_AR_READY)
+    );
+
+    async_fifo #(r_bits, depth) r_fifo (
+        .WCLK     (BUS_CLK),
+        .WRESETn  (BUS_RESETn),
+        .WVALID   (BUS_R_VALID),
+        .WDATA    (BUS_R_DATA),
+        .WREADY   (BUS_R_READY),
+        .RCLK     (CORE_CLK),
+        .RRESETn  (CORE_RESETn),
+        .RVALID   (CORE_R_VALID),
+        .RDATA    (CORE_R_DATA),
+        .RREADY   (CORE_R_READY)
+    );
+
+endmodule
@@ -9,6 +9,7 @@ module axi_data_latch
             MASTER,
             ID,
             DATA,
+            RESP,
             LAST,
 
             VALID,
@@ -28,8 +29,9 @@ module axi_data_latch
     parameter masters = 4;
     parameter id_bits = 2;
     parameter data_width = 64;
+    parameter depth = 8;
 
-`define FIFO_WIDTH (masters + id_bits + data_width + 1)
+`define FIFO_WIDTH (masters + id_bits + data_width + 2 + 1)
 
     input                   CLK;
     input                   RESETN;
@@ -37,6 +39,7 @@ module axi_data_latch
     input  [masters-1:0]    MASTER;
     input  [id_bits-1:0]    ID;
     input  [data_width-1:0] DATA;
+    input  [1:0]            RESP;
     input                   LAST;
 
     input                   VALID;
@@ -64,11 +67,11 @@ module axi_data_latch
     reg                     fifo_ack;
     reg                     next;
 
-    assign fifo_in = { MASTER, ID, DATA, LAST};
+    assign fifo_in = { MASTER, ID, DATA, RESP, LAST};
     assign READY = !full;
-    assign { O_MASTER, O_ID, O_DATA, O_LAST } = fifo_out;
+    assign { O_MASTER, O_ID, O_DATA, O_RESP, O_LAST } = fifo_out;
 
-    bus_fifo #(`FIFO_WIDTH) fifo0 (
+    bus_fifo #(`FIFO_WIDTH, depth) fifo0 (
             .CLK            (CLK), 
             .RESET_N        (RESETN), 
             .DATA_STROBE    (VALID), 
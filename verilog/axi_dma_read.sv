@@ -0,0 +1,182 @@
+
+`timescale 1ns/1ns
+
+module axi_dma_read
+    (
+        CLK,
+        RESETn,
+
+        START,
+        ADDR,
+        COUNT,
+        CLEAR,
+        ACTIVE,
+        QUEUED,
+        ERROR,
+        DONE_COUNT,
+
+        ARID,
+        ARADDR,
+        ARLEN,
+        ARSIZE,
+        ARBURST,
+        ARVALID,
+        ARREADY,
+
+        RID,
+        RDATA,
+        RRESP,
+        RLAST,
+        RVALID,
+        RREADY,
+
+        ODATA,
+        OVALID,
+        OREADY
+    );
+
+    parameter bw_bits   = 3;    // bus width in 2^bw_bits bytes
+    parameter addr_bits = 32;
+    parameter id_bits   = 4;
+    parameter elem_bits = 32;   // element width in memory, a power of 2 from 8 up to the bus width
+    parameter max_burst = 16;   // beats per burst, up to 256
+    `define dr_data_bits  (8 << bw_bits)
+    `define dr_per_beat   ((8 << bw_bits) / elem_bits)
+    `define dr_idx_bits   ((`dr_per_beat > 1) ? $clog2(`dr_per_beat) : 1)
+
+    // reads COUNT elements packed from ADDR, which must be aligned to the
+    // bus width, and hands them out one per cycle on ODATA.  Bursts stop at
+    // 4KB boundaries.  A START while a transfer is running is queued and
+    // starts as soon as it finishes, so the host can chain buffers without a
+    // gap.  A START while QUEUED replaces the queued transfer, a COUNT of 0
+    // is ignored.  DONE_COUNT counts finished transfers, ERROR is set by an
+    // error response and held until CLEAR.
+
+    input                         CLK;
+    input                         RESETn;
+
+    input                         START;
+    input  [addr_bits-1:0]        ADDR;
+    input  [31:0]                 COUNT;
+    input                         CLEAR;
+    output                        ACTIVE;
+    output                        QUEUED;
+    output                        ERROR;
+    output [15:0]                 DONE_COUNT;
+
+    output [id_bits-1:0]          ARID;
+    output [addr_bits-1:0]        ARADDR;
+    output [7:0]                  ARLEN;
+    output [2:0]                  ARSIZE;
+    output [1:0]                  ARBURST;
+    output                        ARVALID;
+    input                         ARREADY;
+
+    input  [id_bits-1:0]          RID;
+    input  [`dr_data_bits-1:0]    RDATA;
+    input  [1:0]                  RRESP;
+    input                         RLAST;
+    input                         RVALID;
+    output                        RREADY;
+
+    output [elem_bits-1:0]        ODATA;
+    output                        OVALID;
+    input                         OREADY;
+
+    reg                           active;
+    reg                           queued;
+    reg                           error;
+    reg    [15:0]                 done_count;
+    reg    [addr_bits-1:0]        next_addr;
+    reg    [31:0]                 next_count;
+
+    reg    [addr_bits-1:0]        ar_addr;
+    reg    [31:0]                 ar_beats;       // beats still to request
+    reg    [31:0]                 elems;          // elements still to hand out
+
+    reg    [`dr_data_bits-1:0]    beat;
+    reg                           held;
+    reg    [`dr_idx_bits-1:0]     idx;
+
+    wire   [31:0]                 ar_room  = (13'd4096 - ar_addr[11:0]) >> bw_bits;
+    wire   [31:0]                 ar_limit = (ar_room < max_burst) ? ar_room : max_burst;
+    wire   [31:0]                 ar_burst = (ar_beats < ar_limit) ? ar_beats : ar_limit;
+
+    wire                          take      = held && OREADY;
+    wire                          beat_done = (idx == `dr_per_beat - 1) || (elems == 1);
+    wire                          finish    = take && (elems == 1);
+    wire                          idle      = !active || finish;
+    wire                          start     = START && (COUNT != 0);
+
+    assign ACTIVE     = active;
+    assign QUEUED     = queued;
+    assign ERROR      = error;
+    assign DONE_COUNT = done_count;
+
+    assign ARID    = {id_bits {1'b0}};
+    assign ARADDR  = ar_addr;
+    assign ARLEN   = ar_burst - 1;
+    assign ARSIZE  = bw_bits;
+    assign ARBURST = 2'b01;
+    assign ARVALID = active && (ar_beats != 0);
+
+    assign RREADY = !held || (take && beat_done);
+
+    assign ODATA  = beat[idx * elem_bits +: elem_bits];
+    assign OVALID = held;
+
+    always @(posedge CLK) begin
+        if (RESETn == 0) begin
+            active     <= 1'b0;
+            queued     <= 1'b0;
+            error      <= 1'b0;
+            done_count <= 16'd0;
+            ar_beats   <= 32'd0;
+            elems      <= 32'd0;
+            held       <= 1'b0;
+            idx        <= 0;
+        end else begin
+            if (ARVALID && ARREADY) begin
+                ar_addr  <= ar_addr + (ar_burst << bw_bits);
+                ar_beats <= ar_beats - ar_burst;
+            end
+
+            if (RVALID && RREADY) begin
+                beat <= RDATA;
+                held <= 1'b1;
+                idx  <= 0;
+                if (RRESP[1]) error <= 1'b1;
+            end else if (take) begin
+                if (beat_done) held <= 1'b0;
+                else idx <= idx + 1;
+            end
+            if (take) elems <= elems - 1;
+
+            if (finish) begin
+                active     <= 1'b0;
+                done_count <= done_count + 1;
+            end
+
+            if (idle && queued) begin
+                active   <= 1'b1;
+                queued   <= 1'b0;
+                ar_addr  <= next_addr;
+                ar_beats <= (next_count + `dr_per_beat - 1) / `dr_per_beat;
+                elems    <= next_count;
+            end else if (idle && start) begin
+                active   <= 1'b1;
+                ar_addr  <= ADDR;
+                ar_beats <= (COUNT + `dr_per_beat - 1) / `dr_per_beat;
+                elems    <= COUNT;
+            end
+            if (start && !(idle && !queued)) begin
+                queued     <= 1'b1;
+                next_addr  <= ADDR;
+                next_count <= COUNT;
+            end
+
+            if (CLEAR) error <= 1'b0;
+        end
+    end
+
+endmodule
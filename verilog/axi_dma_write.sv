@@ -0,0 +1,225 @@
+
+`timescale 1ns/1ns
+
+module axi_dma_write
+    (
+        CLK,
+        RESETn,
+
+        START,
+        ADDR,
+        COUNT,
+        CLEAR,
+        ACTIVE,
+        QUEUED,
+        ERROR,
+        DONE_COUNT,
+
+        AWID,
+        AWADDR,
+        AWLEN,
+        AWSIZE,
+        AWBURST,
+        AWVALID,
+        AWREADY,
+
+        WDATA,
+        WSTRB,
+        WLAST,
+        WVALID,
+        WREADY,
+
+        BID,
+        BRESP,
+        BVALID,
+        BREADY,
+
+        IDATA,
+        IVALID,
+        IREADY
+    );
+
+    parameter bw_bits   = 3;    // bus width in 2^bw_bits bytes
+    parameter addr_bits = 32;
+    parameter id_bits   = 4;
+    parameter elem_bits = 32;   // element width in memory, a power of 2 from 8 up to the bus width
+    parameter max_burst = 16;   // beats per burst, up to 256
+    `define dw_data_bits  (8 << bw_bits)
+    `define dw_per_beat   ((8 << bw_bits) / elem_bits)
+    `define dw_idx_bits   ((`dw_per_beat > 1) ? $clog2(`dw_per_beat) : 1)
+
+    // takes COUNT elements one per cycle on IDATA and writes them packed
+    // from ADDR, which must be aligned to the bus width.  The last beat is
+    // strobed for the elements it holds.  Bursts stop at 4KB boundaries and
+    // the address of each burst goes out as soon as it is known, the write
+    // side works out the same burst lengths for WLAST.  The transfer is done
+    // once every response is back.  START, QUEUED, DONE_COUNT and ERROR work
+    // as in axi_dma_read.
+
+    input                         CLK;
+    input                         RESETn;
+
+    input                         START;
+    input  [addr_bits-1:0]        ADDR;
+    input  [31:0]                 COUNT;
+    input                         CLEAR;
+    output                        ACTIVE;
+    output                        QUEUED;
+    output                        ERROR;
+    output [15:0]                 DONE_COUNT;
+
+    output [id_bits-1:0]          AWID;
+    output [addr_bits-1:0]        AWADDR;
+    output [7:0]                  AWLEN;
+    output [2:0]                  AWSIZE;
+    output [1:0]                  AWBURST;
+    output                        AWVALID;
+    input                         AWREADY;
+
+    output [`dw_data_bits-1:0]    WDATA;
+    output [`dw_data_bits/8-1:0]  WSTRB;
+    output                        WLAST;
+    output                        WVALID;
+    input                         WREADY;
+
+    input  [id_bits-1:0]          BID;
+    input  [1:0]                  BRESP;
+    input                         BVALID;
+    output                        BREADY;
+
+    input  [elem_bits-1:0]        IDATA;
+    input                         IVALID;
+    output                        IREADY;
+
+    reg                           active;
+    reg                           queued;
+    reg                           error;
+    reg    [15:0]                 done_count;
+    reg    [addr_bits-1:0]        next_addr;
+    reg    [31:0]                 next_count;
+
+    reg    [addr_bits-1:0]        aw_addr;
+    reg    [31:0]                 aw_beats;       // beats still to address
+    reg    [addr_bits-1:0]        w_addr;
+    reg    [31:0]                 w_beats;        // beats still to write
+    reg    [8:0]                  w_left;         // beats left in the current burst, 0 before its first
+    reg    [31:0]                 elems;          // elements still to take
+    reg    [31:0]                 b_pending;      // bursts addressed and not yet answered
+
+    reg    [`dw_data_bits-1:0]    wdata;
+    reg    [`dw_data_bits/8-1:0]  wstrb;
+    reg                           wvalid;
+    reg    [`dw_idx_bits-1:0]     idx;
+
+    wire   [31:0]                 aw_room  = (13'd4096 - aw_addr[11:0]) >> bw_bits;
+    wire   [31:0]                 aw_limit = (aw_room < max_burst) ? aw_room : max_burst;
+    wire   [31:0]                 aw_burst = (aw_beats < aw_limit) ? aw_beats : aw_limit;
+
+    wire   [31:0]                 w_room   = (13'd4096 - w_addr[11:0]) >> bw_bits;
+    wire   [31:0]                 w_limit  = (w_room < max_burst) ? w_room : max_burst;
+    wire   [31:0]                 w_burst  = (w_left != 0) ? w_left : (w_beats < w_limit) ? w_beats : w_limit;
+
+    wire                          take      = IVALID && IREADY;
+    wire                          beat_done = (idx == `dw_per_beat - 1) || (elems == 1);
+    wire                          finish    = active && (elems == 0) && !wvalid && (aw_beats == 0) && (b_pending == 0);
+    wire                          idle      = !active || finish;
+    wire                          start     = START && (COUNT != 0);
+
+    assign ACTIVE     = active;
+    assign QUEUED     = queued;
+    assign ERROR      = error;
+    assign DONE_COUNT = done_count;
+
+    assign AWID    = {id_bits {1'b0}};
+    assign AWADDR  = aw_addr;
+    assign AWLEN   = aw_burst - 1;
+    assign AWSIZE  = bw_bits;
+    assign AWBURST = 2'b01;
+    assign AWVALID = active && (aw_beats != 0);
+
+    assign WDATA  = wdata;
+    assign WSTRB  = wstrb;
+    assign WLAST  = (w_burst == 1) ? 1'b1 : 1'b0;
+    assign WVALID = wvalid;
+
+    assign BREADY = 1'b1;
+
+    assign IREADY = active && (elems != 0) && (!wvalid || WREADY);
+
+    always @(posedge CLK) begin
+        if (RESETn == 0) begin
+            active     <= 1'b0;
+            queued     <= 1'b0;
+            error      <= 1'b0;
+            done_count <= 16'd0;
+            aw_beats   <= 32'd0;
+            w_beats    <= 32'd0;
+            w_left     <= 9'd0;
+            elems      <= 32'd0;
+            b_pending  <= 32'd0;
+            wvalid     <= 1'b0;
+            idx        <= 0;
+        end else begin
+            if (AWVALID && AWREADY) begin
+                aw_addr  <= aw_addr + (aw_burst << bw_bits);
+                aw_beats <= aw_beats - aw_burst;
+            end
+            b_pending <= b_pending + ((AWVALID && AWREADY) ? 1 : 0) - ((BVALID) ? 1 : 0);
+            if (BVALID && BRESP[1]) error <= 1'b1;
+
+            if (wvalid && WREADY) begin
+                wvalid  <= 1'b0;
+                w_addr  <= w_addr + (1 << bw_bits);
+                w_beats <= w_beats - 1;
+                w_left  <= w_burst - 1;
+            end
+
+            if (take) begin
+                if (idx == 0) begin
+                    wdata <= IDATA;
+                    wstrb <= {(elem_bits/8) {1'b1}};
+                end else begin
+                    wdata[idx * elem_bits +: elem_bits]     <= IDATA;
+                    wstrb[idx * elem_bits/8 +: elem_bits/8] <= {(elem_bits/8) {1'b1}};
+                end
+                elems <= elems - 1;
+                if (beat_done) begin
+                    wvalid <= 1'b1;
+                    idx    <= 0;
+                end else begin
+                    idx    <= idx + 1;
+                end
+            end
+
+            if (finish) begin
+                active     <= 1'b0;
+                done_count <= done_count + 1;
+            end
+
+            if (idle && queued) begin
+                active   <= 1'b1;
+                queued   <= 1'b0;
+                aw_addr  <= next_addr;
+                aw_beats <= (next_count + `dw_per_beat - 1) / `dw_per_beat;
+                w_addr   <= next_addr;
+                w_beats  <= (next_count + `dw_per_beat - 1) / `dw_per_beat;
+                elems    <= next_count;
+            end else if (idle && start) begin
+                active   <= 1'b1;
+                aw_addr  <= ADDR;
+                aw_beats <= (COUNT + `dw_per_beat - 1) / `dw_per_beat;
+                w_addr   <= ADDR;
+                w_beats  <= (COUNT + `dw_per_beat - 1) / `dw_per_beat;
+                elems    <= COUNT;
+            end
+            if (start && !(idle && !queued)) begin
+                queued     <= 1'b1;
+                next_addr  <= ADDR;
+                next_count <= COUNT;
+            end
+
+            if (CLEAR) error <= 1'b0;
+        end
+    end
+
+endmodule
@@ -0,0 +1,84 @@
+
+`timescale 1ns/1ns
+
+module axi_excl_monitor
+    (
+        CLK,
+        RESETn,
+
+        SET,
+        SET_MASTER,
+        SET_ID,
+        SET_ADDR,
+
+        CHECK_MASTER,
+        CHECK_ID,
+        CHECK_ADDR,
+        HIT,
+
+        CLEAR,
+        CLEAR_ADDR
+    );
+
+    parameter masters = 4;
+    parameter id_bits = 2;
+    parameter width   = 22;  // number of address bits in peripheral
+    parameter granule = 7;   // reservation block in 2^granule bytes, 128 bytes covers any exclusive burst
+
+    // one reservation per master.  An exclusive read sets the reservation of
+    // its master, an exclusive write passes only while the reservation of its
+    // master and ID still covers the address, and any write into a reserved
+    // block drops every reservation on that block.  A clear and a set in the
+    // same cycle leave the block unreserved, which can fail an exclusive pair
+    // but never lets one through that should have failed.
+
+    input                         CLK;
+    input                         RESETn;
+
+    input                         SET;
+    input  [masters-1:0]          SET_MASTER;
+    input  [id_bits-1:0]          SET_ID;
+    input  [width-1:0]            SET_ADDR;
+
+    input  [masters-1:0]          CHECK_MASTER;
+    input  [id_bits-1:0]          CHECK_ID;
+    input  [width-1:0]            CHECK_ADDR;
+    output                        HIT;
+
+    input                         CLEAR;
+    input  [width-1:0]            CLEAR_ADDR;
+
+    reg    [masters-1:0]          ex_valid;
+    wire   [masters-1:0]          ex_hit;
+
+    genvar n;
+
+    assign HIT = |ex_hit;
+
+    generate
+        for (n=0; n<masters; n=n+1) begin : reservation
+
+            reg  [id_bits-1:0]          ex_id;
+            reg  [width-granule-1:0]    ex_block;
+
+            assign ex_hit[n] = CHECK_MASTER[n] && ex_valid[n] && (ex_id == CHECK_ID) &&
+                               (ex_block == CHECK_ADDR[width-1:granule]);
+
+            always @(posedge CLK) begin
+                if (RESETn == 0) begin
+                    ex_valid[n] <= 1'b0;
+                end else begin
+                    if (SET && SET_MASTER[n]) begin
+                        ex_valid[n] <= 1'b1;
+                        ex_id       <= SET_ID;
+                        ex_block    <= SET_ADDR[width-1:granule];
+                    end
+                    if (CLEAR && (CLEAR_ADDR[width-1:granule] == ((SET && SET_MASTER[n]) ? SET_ADDR[width-1:granule] : ex_block))) begin
+                        ex_valid[n] <= 1'b0;
+                    end
+                end
+            end
+        end
+    endgenerate
+
+endmodule
@@ -0,0 +1,155 @@
+
+`timescale 1ns/1ns
+
+module axi_lite_slave
+    (
+        ACLK,
+        ARESETn,
+
+        AWADDR,
+        AWPROT,
+        AWVALID,
+        AWREADY,
+
+        WDATA,
+        WSTRB,
+        WVALID,
+        WREADY,
+
+        BRESP,
+        BVALID,
+        BREADY,
+
+        ARADDR,
+        ARPROT,
+        ARVALID,
+        ARREADY,
+
+        RDATA,
+        RRESP,
+        RVALID,
+        RREADY,
+
+        SRAM_READ_ADDRESS,
+        SRAM_READ_DATA,
+        SRAM_OUTPUT_ENABLE,
+
+        SRAM_WRITE_ADDRESS,
+        SRAM_WRITE_DATA,
+        SRAM_WRITE_BYTE_ENABLE,
+        SRAM_WRITE_STROBE
+    );
+
+    parameter width      = 16;    // byte address bits
+    parameter b_size     = 3;     // bus width in 2^b_size bytes
+    parameter rd_latency = 1;     // SRAM_READ_DATA follows SRAM_OUTPUT_ENABLE by rd_latency cycles
+    `define lite_data_bits (8 << b_size)
+
+    // AXI4-Lite slave on the SRAM side of axi_slave_interface, for register
+    // banks driven by control code only.  There are no wait states: a write
+    // is taken in the cycle AWVALID and WVALID are both high, goes to the
+    // SRAM in that cycle and is answered on B in the next.  A read goes to
+    // the SRAM in the cycle ARVALID is high and RVALID rises rd_latency
+    // cycles later.  Reads issue every cycle, rd_latency+1 of them can be
+    // outstanding, so a stalled R channel fills a FIFO of that depth before
+    // ARREADY drops.  AWPROT and ARPROT are ignored, responses are OKAY.
+
+    input                           ACLK;
+    input                           ARESETn;
+
+    input  [width-1:0]              AWADDR;
+    input  [2:0]                    AWPROT;
+    input                           AWVALID;
+    output                          AWREADY;
+
+    input  [`lite_data_bits-1:0]    WDATA;
+    input  [`lite_data_bits/8-1:0]  WSTRB;
+    input                           WVALID;
+    output                          WREADY;
+
+    output [1:0]                    BRESP;
+    output                          BVALID;
+    input                           BREADY;
+
+    input  [width-1:0]              ARADDR;
+    input  [2:0]                    ARPROT;
+    input                           ARVALID;
+    output                          ARREADY;
+
+    output [`lite_data_bits-1:0]    RDATA;
+    output [1:0]                    RRESP;
+    output                          RVALID;
+    input                           RREADY;
+
+    output [width-1:0]              SRAM_READ_ADDRESS;
+    input  [`lite_data_bits-1:0]    SRAM_READ_DATA;
+    output                          SRAM_OUTPUT_ENABLE;
+
+    output [width-1:0]              SRAM_WRITE_ADDRESS;
+    output [`lite_data_bits-1:0]    SRAM_WRITE_DATA;
+    output [`lite_data_bits/8-1:0]  SRAM_WRITE_BYTE_ENABLE;
+    output                          SRAM_WRITE_STROBE;
+
+    reg                             b_valid;
+    wire                            b_free    = !b_valid || BREADY;
+    wire                            wr_issue  = AWVALID && WVALID && b_free;
+
+    reg    [rd_latency-1:0]         rd_pipe;          // bit n set for a read issued n+1 cycles ago
+    reg    [`lite_data_bits-1:0]    rd_fifo[0:rd_latency];
+    reg    [7:0]                    rd_head;
+    reg    [7:0]                    rd_tail;
+    reg    [7:0]                    rd_count;         // entries in rd_fifo
+    reg    [7:0]                    rd_outstanding;   // reads issued and not yet taken on R
+    wire                            rd_issue  = ARVALID && ARREADY;
+    wire                            rd_return = rd_pipe[rd_latency-1];
+    wire                            rd_take   = RVALID && RREADY;
+    wire                            rd_push   = rd_return && ((rd_count != 0) || !RREADY);
+    wire                            rd_pop    = rd_take && (rd_count != 0);
+
+    assign AWREADY = WVALID && b_free;
+    assign WREADY  = AWVALID && b_free;
+    assign BRESP   = 2'b00;
+    assign BVALID  = b_valid;
+
+    assign ARREADY = (rd_outstanding <= rd_latency) ? 1'b1 : 1'b0;
+    assign RDATA   = (rd_count != 0) ? rd_fifo[rd_head] : SRAM_READ_DATA;
+    assign RRESP   = 2'b00;
+    assign RVALID  = (rd_count != 0) || rd_return;
+
+    assign SRAM_READ_ADDRESS      = ARADDR;
+    assign SRAM_OUTPUT_ENABLE     = rd_issue;
+    assign SRAM_WRITE_ADDRESS     = AWADDR;
+    assign SRAM_WRITE_DATA        = WDATA;
+    assign SRAM_WRITE_BYTE_ENABLE = WSTRB;
+    assign SRAM_WRITE_STROBE      = wr_issue;
+
+    always @(posedge ACLK) begin
+        if (ARESETn == 0) begin
+            b_valid <= 1'b0;
+        end else if (wr_issue) begin
+            b_valid <= 1'b1;
+        end else if (BREADY) begin
+            b_valid <= 1'b0;
+        end
+    end
+
+    always @(posedge ACLK) begin
+        if (ARESETn == 0) begin
+            rd_pipe        <= {rd_latency {1'b0}};
+            rd_head        <= 0;
+            rd_tail        <= 0;
+            rd_count       <= 0;
+            rd_outstanding <= 0;
+        end else begin
+            rd_pipe <= (rd_pipe << 1) | rd_issue;
+            if (rd_push) begin
+                rd_fifo[rd_tail] <= SRAM_READ_DATA;
+                rd_tail <= (rd_tail == rd_latency) ? 0 : rd_tail + 1;
+            end
+            if (rd_pop) rd_head <= (rd_head == rd_latency) ? 0 : rd_head + 1;
+            rd_count       <= rd_count + rd_push - rd_pop;
+            rd_outstanding <= rd_outstanding + rd_issue - rd_take;
+        end
+    end
+
+endmodule
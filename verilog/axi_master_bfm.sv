@@ -0,0 +1,264 @@
+
+`timescale 1ns/1ns
+
+module axi_master_bfm
+    (
+        ACLK,
+        ARESETn,
+
+        AWMASTER,
+        AWID,
+        AWADDR,
+        AWLEN,
+        AWSIZE,
+        AWBURST,
+        AWLOCK,
+        AWCACHE,
+        AWPROT,
+        AWVALID,
+        AWREADY,
+
+        WMASTER,
+        WID,
+        WDATA,
+        WSTRB,
+        WLAST,
+        WVALID,
+        WREADY,
+
+        BMASTER,
+        BID,
+        BRESP,
+        BVALID,
+        BREADY,
+
+        ARMASTER,
+        ARID,
+        ARADDR,
+        ARLEN,
+        ARSIZE,
+        ARBURST,
+        ARLOCK,
+        ARCACHE,
+        ARPROT,
+        ARVALID,
+        ARREADY,
+
+        RMASTER,
+        RID,
+        RDATA,
+        RRESP,
+        RLAST,
+        RVALID,
+        RREADY
+    );
+
+    parameter masters = 1;
+    parameter width   = 16;   // byte address bits
+    parameter id_bits = 4;
+    parameter b_size  = 3;    // bus width in 2^b_size bytes
+    `define bfm_data_bits (8 << b_size)
+
+    // bus functional model of an AXI master for testbenches, driving the
+    // port of axi_slave_interface.  write and read move one INCR burst of up
+    // to 256 beats from wbuf or into rbuf, with the address and data of a
+    // write issued together and every beat offered in the cycle after the
+    // last one was taken.  write1 and read1 are single beat accesses.
+    // Transactions, data beats and cycles are counted for throughput
+    // reports, and any SLVERR or DECERR response counts as an error.
+
+    input                         ACLK;
+    input                         ARESETn;
+
+    output [masters-1:0]          AWMASTER;
+    output [id_bits-1:0]          AWID;
+    output [width-1:0]            AWADDR;
+    output [7:0]                  AWLEN;
+    output [2:0]                  AWSIZE;
+    output [1:0]                  AWBURST;
+    output [0:0]                  AWLOCK;
+    output [3:0]                  AWCACHE;
+    output [2:0]                  AWPROT;
+    output                        AWVALID;
+    input                         AWREADY;
+
+    output [masters-1:0]          WMASTER;
+    output [id_bits-1:0]          WID;
+    output [`bfm_data_bits-1:0]   WDATA;
+    output [`bfm_data_bits/8-1:0] WSTRB;
+    output                        WLAST;
+    output                        WVALID;
+    input                         WREADY;
+
+    input  [masters-1:0]          BMASTER;
+    input  [id_bits-1:0]          BID;
+    input  [1:0]                  BRESP;
+    input                         BVALID;
+    output                        BREADY;
+
+    output [masters-1:0]          ARMASTER;
+    output [id_bits-1:0]          ARID;
+    output [width-1:0]            ARADDR;
+    output [7:0]                  ARLEN;
+    output [2:0]                  ARSIZE;
+    output [1:0]                  ARBURST;
+    output [0:0]                  ARLOCK;
+    output [3:0]                  ARCACHE;
+    output [2:0]                  ARPROT;
+    output                        ARVALID;
+    input                         ARREADY;
+
+    input  [masters-1:0]          RMASTER;
+    input  [id_bits-1:0]          RID;
+    input  [`bfm_data_bits-1:0]   RDATA;
+    input  [1:0]                  RRESP;
+    input                         RLAST;
+    input                         RVALID;
+    output                        RREADY;
+
+    reg    [width-1:0]            awaddr;
+    reg    [7:0]                  awlen;
+    reg                           awvalid;
+    reg    [`bfm_data_bits-1:0]   wdata;
+    reg                           wlast;
+    reg                           wvalid;
+    reg    [width-1:0]            araddr;
+    reg    [7:0]                  arlen;
+    reg                           arvalid;
+
+    reg    [`bfm_data_bits-1:0]   wbuf[0:255];
+    reg    [`bfm_data_bits-1:0]   rbuf[0:255];
+
+    integer                       cycles;
+    integer                       transactions;   // AW and AR handshakes
+    integer                       beats;          // W and R handshakes
+    integer                       errors;
+
+    assign AWMASTER = 1;
+    assign AWID     = {id_bits {1'b0}};
+    assign AWADDR   = awaddr;
+    assign AWLEN    = awlen;
+    assign AWSIZE   = b_size;
+    assign AWBURST  = 2'b01;
+    assign AWLOCK   = 1'b0;
+    assign AWCACHE  = 4'b0000;
+    assign AWPROT   = 3'b000;
+    assign AWVALID  = awvalid;
+
+    assign WMASTER  = AWMASTER;
+    assign WID      = AWID;
+    assign WDATA    = wdata;
+    assign WSTRB    = {(`bfm_data_bits/8) {1'b1}};
+    assign WLAST    = wlast;
+    assign WVALID   = wvalid;
+
+    assign BREADY   = 1'b1;
+
+    assign ARMASTER = AWMASTER;
+    assign ARID     = {id_bits {1'b0}};
+    assign ARADDR   = araddr;
+    assign ARLEN    = arlen;
+    assign ARSIZE   = b_size;
+    assign ARBURST  = 2'b01;
+    assign ARLOCK   = 1'b0;
+    assign ARCACHE  = 4'b0000;
+    assign ARPROT   = 3'b000;
+    assign ARVALID  = arvalid;
+
+    assign RREADY   = 1'b1;
+
+    initial begin
+        awvalid      = 1'b0;
+        wvalid       = 1'b0;
+        wlast        = 1'b0;
+        arvalid      = 1'b0;
+        cycles       = 0;
+        transactions = 0;
+        beats        = 0;
+        errors       = 0;
+    end
+
+    always @(posedge ACLK) begin
+        if (ARESETn == 1) begin
+            cycles <= cycles + 1;
+            transactions <= transactions + ((AWVALID && AWREADY) ? 1 : 0) + ((ARVALID && ARREADY) ? 1 : 0);
+            beats <= beats + ((WVALID && WREADY) ? 1 : 0) + ((RVALID && RREADY) ? 1 : 0);
+            if ((BVALID && BREADY && BRESP[1]) || (RVALID && RREADY && RRESP[1])) errors <= errors + 1;
+        end
+    end
+
+    // tasks are called just after a rising edge of ACLK and return just
+    // after the edge that completes the transfer
+
+    task write;
+        input [width-1:0] addr;
+        input [8:0]       count;
+        integer           i;
+        begin
+            fork
+                begin
+                    awaddr  <= addr;
+                    awlen   <= count - 1;
+                    awvalid <= 1'b1;
+                    @(posedge ACLK);
+                    while (!AWREADY) @(posedge ACLK);
+                    awvalid <= 1'b0;
+                end
+                begin
+                    for (i=0; i<count; i=i+1) begin
+                        wdata  <= wbuf[i];
+                        wlast  <= (i == count - 1) ? 1'b1 : 1'b0;
+                        wvalid <= 1'b1;
+                        @(posedge ACLK);
+                        while (!WREADY) @(posedge ACLK);
+                    end
+                    wvalid <= 1'b0;
+                    wlast  <= 1'b0;
+                end
+            join
+            @(posedge ACLK);
+            while (!BVALID) @(posedge ACLK);
+        end
+    endtask
+
+    task read;
+        input [width-1:0] addr;
+        input [8:0]       count;
+        integer           i;
+        begin
+            araddr  <= addr;
+            arlen   <= count - 1;
+            arvalid <= 1'b1;
+            @(posedge ACLK);
+            while (!ARREADY) @(posedge ACLK);
+            arvalid <= 1'b0;
+            i = 0;
+            while (i < count) begin
+                @(posedge ACLK);
+                if (RVALID) begin
+                    rbuf[i] = RDATA;
+                    i = i + 1;
+                end
+            end
+        end
+    endtask
+
+    task write1;
+        input [width-1:0]          addr;
+        input [`bfm_data_bits-1:0] data;
+        begin
+            wbuf[0] = data;
+            write(addr, 1);
+        end
+    endtask
+
+    task read1;
+        input  [width-1:0]          addr;
+        output [`bfm_data_bits-1:0] data;
+        begin
+            read(addr, 1);
+            data = rbuf[0];
+        end
+    endtask
+
+endmodule
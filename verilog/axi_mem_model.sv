@@ -0,0 +1,157 @@
+
+`timescale 1ns/1ns
+
+module axi_mem_model
+    (
+        CLK,
+        RESETn,
+
+        AWID,
+        AWADDR,
+        AWLEN,
+        AWSIZE,
+        AWBURST,
+        AWVALID,
+        AWREADY,
+
+        WDATA,
+        WSTRB,
+        WLAST,
+        WVALID,
+        WREADY,
+
+        BID,
+        BRESP,
+        BVALID,
+        BREADY,
+
+        ARID,
+        ARADDR,
+        ARLEN,
+        ARSIZE,
+        ARBURST,
+        ARVALID,
+        ARREADY,
+
+        RID,
+        RDATA,
+        RRESP,
+        RLAST,
+        RVALID,
+        RREADY
+    );
+
+    parameter bw_bits   = 3;      // bus width in 2^bw_bits bytes
+    parameter addr_bits = 32;
+    parameter id_bits   = 4;
+    parameter words     = 4096;   // bus words held, a power of 2
+    `define mm_data_bits  (8 << bw_bits)
+    `define mm_index_bits $clog2(words)
+
+    // memory for testbenches to hang on an AXI master port.  One read and
+    // one write burst run at a time, each moving a beat per cycle, every
+    // burst is taken as INCR of full bus width beats and the address wraps
+    // at the size of mem.  Testbenches load and check mem directly.
+
+    input                         CLK;
+    input                         RESETn;
+
+    input  [id_bits-1:0]          AWID;
+    input  [addr_bits-1:0]        AWADDR;
+    input  [7:0]                  AWLEN;
+    input  [2:0]                  AWSIZE;
+    input  [1:0]                  AWBURST;
+    input                         AWVALID;
+    output                        AWREADY;
+
+    input  [`mm_data_bits-1:0]    WDATA;
+    input  [`mm_data_bits/8-1:0]  WSTRB;
+    input                         WLAST;
+    input                         WVALID;
+    output                        WREADY;
+
+    output [id_bits-1:0]          BID;
+    output [1:0]                  BRESP;
+    output                        BVALID;
+    input                         BREADY;
+
+    input  [id_bits-1:0]          ARID;
+    input  [addr_bits-1:0]        ARADDR;
+    input  [7:0]                  ARLEN;
+    input  [2:0]                  ARSIZE;
+    input  [1:0]                  ARBURST;
+    input                         ARVALID;
+    output                        ARREADY;
+
+    output [id_bits-1:0]          RID;
+    output [`mm_data_bits-1:0]    RDATA;
+    output [1:0]                  RRESP;
+    output                        RLAST;
+    output                        RVALID;
+    input                         RREADY;
+
+    reg    [`mm_data_bits-1:0]    mem[0:words-1];
+
+    reg                           w_active;
+    reg    [addr_bits-1:0]        w_addr;
+    reg    [id_bits-1:0]          w_id;
+    reg                           b_valid;
+
+    reg                           r_active;
+    reg    [addr_bits-1:0]        r_addr;
+    reg    [id_bits-1:0]          r_id;
+    reg    [7:0]                  r_left;         // beats after the current one
+
+    integer                       k;
+
+    assign AWREADY = !w_active && !b_valid;
+    assign WREADY  = w_active;
+    assign BID     = w_id;
+    assign BRESP   = 2'b00;
+    assign BVALID  = b_valid;
+
+    assign ARREADY = !r_active;
+    assign RID     = r_id;
+    assign RDATA   = mem[r_addr[bw_bits +: `mm_index_bits]];
+    assign RRESP   = 2'b00;
+    assign RLAST   = (r_left == 0) ? 1'b1 : 1'b0;
+    assign RVALID  = r_active;
+
+    always @(posedge CLK) begin
+        if (RESETn == 0) begin
+            w_active <= 1'b0;
+            b_valid  <= 1'b0;
+            r_active <= 1'b0;
+        end else begin
+            if (AWVALID && AWREADY) begin
+                w_active <= 1'b1;
+                w_addr   <= AWADDR;
+                w_id     <= AWID;
+            end
+            if (WVALID && WREADY) begin
+                for (k=0; k<`mm_data_bits/8; k=k+1) begin
+                    if (WSTRB[k]) mem[w_addr[bw_bits +: `mm_index_bits]][k*8 +: 8] <= WDATA[k*8 +: 8];
+                end
+                w_addr <= w_addr + (1 << bw_bits);
+                if (WLAST) begin
+                    w_active <= 1'b0;
+                    b_valid  <= 1'b1;
+                end
+            end
+            if (BVALID && BREADY) b_valid <= 1'b0;
+
+            if (ARVALID && ARREADY) begin
+                r_active <= 1'b1;
+                r_addr   <= ARADDR;
+                r_id     <= ARID;
+                r_left   <= ARLEN;
+            end
+            if (RVALID && RREADY) begin
+                r_addr <= r_addr + (1 << bw_bits);
+                r_left <= r_left - 1;
+                if (r_left == 0) r_active <= 1'b0;
+            end
+        end
+    end
+
+endmodule
@@ -0,0 +1,117 @@
+
+`timescale 1ns/1ns
+
+module axi_reg_slice
+    (
+        CLK,
+        RESETn,
+
+        S_DATA,
+        S_VALID,
+        S_READY,
+
+        M_DATA,
+        M_VALID,
+        M_READY
+    );
+
+    parameter width = 32;
+    parameter mode  = 0;    // 0 bypass, 1 forward, 2 backward, 3 full
+
+    // register slice for one AXI channel, the payload in width bits.
+    //   bypass    wires only
+    //   forward   M_VALID and M_DATA registered, one cycle of latency,
+    //             S_READY still follows M_READY through logic
+    //   backward  S_READY registered through a skid entry, no latency while
+    //             M_READY is high, a stall costs one cycle when it ends
+    //   full      both, with the skid entry behind the output register so
+    //             a beat moves every cycle through stalls, one cycle latency
+
+    input                   CLK;
+    input                   RESETn;
+
+    input  [width-1:0]      S_DATA;
+    input                   S_VALID;
+    output                  S_READY;
+
+    output [width-1:0]      M_DATA;
+    output                  M_VALID;
+    input                   M_READY;
+
+    reg    [width-1:0]      out_data;
+    reg                     out_valid;
+    reg    [width-1:0]      skid_data;
+    reg                     skid_valid;
+
+    generate
+
+        if (mode == 0) begin : bypass
+
+            assign M_DATA  = S_DATA;
+            assign M_VALID = S_VALID;
+            assign S_READY = M_READY;
+
+        end
+        if (mode == 1) begin : forward
+
+            assign M_DATA  = out_data;
+            assign M_VALID = out_valid;
+            assign S_READY = !out_valid || M_READY;
+
+            always @(posedge CLK) begin
+                if (RESETn == 0) begin
+                    out_valid <= 1'b0;
+                end else if (S_READY) begin
+                    out_valid <= S_VALID;
+                    if (S_VALID) out_data <= S_DATA;
+                end
+            end
+
+        end
+        if (mode == 2) begin : backward
+
+            assign M_DATA  = (skid_valid) ? skid_data : S_DATA;
+            assign M_VALID = skid_valid || S_VALID;
+            assign S_READY = !skid_valid;
+
+            always @(posedge CLK) begin
+                if (RESETn == 0) begin
+                    skid_valid <= 1'b0;
+                end else if (skid_valid) begin
+                    if (M_READY) skid_valid <= 1'b0;
+                end else if (S_VALID && !M_READY) begin
+                    skid_valid <= 1'b1;
+                    skid_data  <= S_DATA;
+                end
+            end
+
+        end
+        if (mode == 3) begin : full
+
+            assign M_DATA  = out_data;
+            assign M_VALID = out_valid;
+            assign S_READY = !skid_valid;
+
+            always @(posedge CLK) begin
+                if (RESETn == 0) begin
+                    out_valid  <= 1'b0;
+                    skid_valid <= 1'b0;
+                end else if (!out_valid || M_READY) begin
+                    if (skid_valid) begin
+                        out_data   <= skid_data;
+                        skid_valid <= 1'b0;
+                    end else begin
+                        out_valid  <= S_VALID;
+                        if (S_VALID) out_data <= S_DATA;
+                    end
+                end else if (S_VALID && !skid_valid) begin
+                    skid_valid <= 1'b1;
+                    skid_data  <= S_DATA;
+                end
+            end
+
+        end
+
+    endgenerate
+
+endmodule
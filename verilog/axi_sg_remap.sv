@@ -0,0 +1,410 @@
+
+`timescale 1ns/1ns
+
+module axi_sg_remap
+    (
+        CLK,
+        RESETn,
+
+        LIST,
+        COUNT,
+        FLUSH,
+        CLEAR,
+        ERROR,
+
+        S_AWID,
+        S_AWADDR,
+        S_AWVALID,
+        S_AWREADY,
+
+        M_AWADDR,
+        M_AWVALID,
+        M_AWREADY,
+
+        S_WLAST,
+        S_WVALID,
+        S_WREADY,
+
+        M_WVALID,
+        M_WREADY,
+
+        S_BID,
+        S_BRESP,
+        S_BVALID,
+        S_BREADY,
+
+        M_BID,
+        M_BRESP,
+        M_BVALID,
+        M_BREADY,
+
+        S_ARID,
+        S_ARADDR,
+        S_ARLEN,
+        S_ARSIZE,
+        S_ARBURST,
+        S_ARVALID,
+        S_ARREADY,
+
+        M_ARID,
+        M_ARADDR,
+        M_ARLEN,
+        M_ARSIZE,
+        M_ARBURST,
+        M_ARVALID,
+        M_ARREADY,
+
+        S_RID,
+        S_RDATA,
+        S_RRESP,
+        S_RLAST,
+        S_RVALID,
+        S_RREADY,
+
+        M_RID,
+        M_RDATA,
+        M_RRESP,
+        M_RLAST,
+        M_RVALID,
+        M_RREADY
+    );
+
+    parameter bw_bits   = 3;    // bus width in 2^bw_bits bytes
+    parameter addr_bits = 32;
+    parameter id_bits   = 4;
+    `define sg_data_bits  (8 << bw_bits)
+    `define sg_beats      ((bw_bits < 4) ? (16 >> bw_bits) : 1)
+
+    // scatter-gather translation between a master (S_*) that addresses one
+    // linear buffer from 0 and the bus (M_*).  The buffer is COUNT segments
+    // listed in memory at LIST, 16 bytes each, little endian:
+    //   bytes 0-7    physical address of the segment
+    //   bytes 8-11   length in bytes
+    //   bytes 12-15  reserved
+    // and segment n holds the linear bytes after those of segments 0 to n-1.
+    // Every segment but the last must start on a 4KB boundary and be a
+    // multiple of 4KB long, so no burst crosses a segment, and a burst is
+    // looked up by its first address.
+    //
+    // The read and the write channel each keep the segment they last used.
+    // An address outside it walks the list, on from that segment or from
+    // the start, reading one descriptor at a time on AR once the reads
+    // already passed on have finished; new reads wait for the walk, writes
+    // that hit keep going.  An address past the last segment is not passed on, the burst
+    // is answered with SLVERR (its write data taken) and ERROR is set until
+    // CLEAR.  A COUNT of 0 passes every address through unchanged.  FLUSH
+    // forgets both segments, for a new list.  The bus must return read
+    // bursts in the order they were issued.  Fields of the master other
+    // than these pass straight to the bus.
+
+    input                         CLK;
+    input                         RESETn;
+
+    input  [addr_bits-1:0]        LIST;
+    input  [31:0]                 COUNT;
+    input                         FLUSH;
+    input                         CLEAR;
+    output                        ERROR;
+
+    input  [id_bits-1:0]          S_AWID;
+    input  [addr_bits-1:0]        S_AWADDR;
+    input                         S_AWVALID;
+    output                        S_AWREADY;
+
+    output [addr_bits-1:0]        M_AWADDR;
+    output                        M_AWVALID;
+    input                         M_AWREADY;
+
+    input                         S_WLAST;
+    input                         S_WVALID;
+    output                        S_WREADY;
+
+    output                        M_WVALID;
+    input                         M_WREADY;
+
+    output [id_bits-1:0]          S_BID;
+    output [1:0]                  S_BRESP;
+    output                        S_BVALID;
+    input                         S_BREADY;
+
+    input  [id_bits-1:0]          M_BID;
+    input  [1:0]                  M_BRESP;
+    input                         M_BVALID;
+    output                        M_BREADY;
+
+    input  [id_bits-1:0]          S_ARID;
+    input  [addr_bits-1:0]        S_ARADDR;
+    input  [7:0]                  S_ARLEN;
+    input  [2:0]                  S_ARSIZE;
+    input  [1:0]                  S_ARBURST;
+    input                         S_ARVALID;
+    output                        S_ARREADY;
+
+    output [id_bits-1:0]          M_ARID;
+    output [addr_bits-1:0]        M_ARADDR;
+    output [7:0]                  M_ARLEN;
+    output [2:0]                  M_ARSIZE;
+    output [1:0]                  M_ARBURST;
+    output                        M_ARVALID;
+    input                         M_ARREADY;
+
+    output [id_bits-1:0]          S_RID;
+    output [`sg_data_bits-1:0]    S_RDATA;
+    output [1:0]                  S_RRESP;
+    output                        S_RLAST;
+    output                        S_RVALID;
+    input                         S_RREADY;
+
+    input  [id_bits-1:0]          M_RID;
+    input  [`sg_data_bits-1:0]    M_RDATA;
+    input  [1:0]                  M_RRESP;
+    input                         M_RLAST;
+    input                         M_RVALID;
+    output                        M_RREADY;
+
+    reg                           error;
+
+    // the segment each channel last used, r for reads and w for writes
+    reg                           r_valid,  w_valid;
+    reg    [31:0]                 r_index,  w_index;
+    reg    [addr_bits-1:0]        r_lin,    w_lin;      // linear start
+    reg    [addr_bits-1:0]        r_end,    w_end;      // linear end, exclusive
+    reg    [addr_bits-1:0]        r_phys,   w_phys;
+    reg                           r_miss,   w_miss;     // the waiting address is in no segment
+
+    // the walk of the list
+    reg                           walk;
+    reg                           walk_w;         // for the write channel
+    reg                           prefer_w;       // the channel served when both miss
+    reg                           fetch;          // descriptor address on AR
+    reg                           collect;        // descriptor beats on R
+    reg                           check;          // descriptor complete in desc
+    reg    [addr_bits-1:0]        walk_addr;      // linear address looked up
+    reg    [31:0]                 walk_index;
+    reg    [addr_bits-1:0]        walk_lin;       // linear start of segment walk_index
+    reg    [127:0]                desc;
+    reg                           desc_error;
+
+    // reads
+    reg    [7:0]                  rd_outstanding; // bursts passed on and not finished
+    reg                           ar_held;        // a passed address not yet taken
+    reg                           r_err;          // SLVERR burst owed for a refused read
+    reg    [id_bits-1:0]          r_err_id;
+    reg    [7:0]                  r_err_beats;    // beats left after the one on R
+
+    // writes
+    reg    [7:0]                  wr_outstanding; // bursts passed on and not answered
+    reg                           w_ahead;        // data of the waiting address already passed
+    reg                           wq[0:3];        // 1 for a refused burst, for each address taken ahead of its data
+    reg    [1:0]                  wq_head;
+    reg    [1:0]                  wq_tail;
+    reg    [2:0]                  wq_count;
+    reg                           b_err;          // SLVERR owed for a refused write
+    reg                           b_err_data;     // its data is all taken
+    reg    [id_bits-1:0]          b_err_id;
+
+    wire                          off      = (COUNT == 0);
+    wire                          ar_hit   = off || (r_valid && (S_ARADDR >= r_lin) && (S_ARADDR < r_end));
+    wire                          aw_hit   = off || (w_valid && (S_AWADDR >= w_lin) && (S_AWADDR < w_end));
+    wire   [addr_bits-1:0]        desc_addr = LIST + (walk_index << 4);
+
+    wire                          ar_pass   = S_ARVALID && ar_hit && !r_err && (!walk || ar_held);
+    wire                          ar_refuse = S_ARVALID && r_miss && !r_err;
+    wire                          r_inject  = r_err && (rd_outstanding == 0) && !collect;
+
+    wire                          aw_pass   = S_AWVALID && aw_hit && !b_err && (wq_count != 4);
+    wire                          aw_refuse = S_AWVALID && w_miss && !b_err && (wq_count != 4);
+    wire                          aw_take   = S_AWVALID && S_AWREADY;
+    wire                          w_queued  = (wq_count != 0);
+    wire                          w_pass    = (w_queued) ? !wq[wq_head] : (!w_ahead && aw_pass);
+    wire                          w_drop    = w_queued && wq[wq_head];
+    wire                          w_last    = S_WVALID && S_WREADY && S_WLAST;
+    wire                          w_early   = w_last && !w_queued;      // data of the waiting address done
+    wire                          wq_push   = aw_take && !w_ahead && !w_early;
+    wire                          wq_pop    = w_last && w_queued;
+    wire                          b_inject  = b_err && b_err_data && (wr_outstanding == 0);
+
+    wire                          want_r    = S_ARVALID && !ar_hit && !r_miss;
+    wire                          want_w    = S_AWVALID && !aw_hit && !w_miss;
+    wire                          pick_w    = want_w && (!want_r || prefer_w);
+    wire   [addr_bits-1:0]        seg_end   = walk_lin + desc[95:64];
+
+    assign ERROR = error;
+
+    assign M_AWADDR  = (off) ? S_AWADDR : w_phys + (S_AWADDR - w_lin);
+    assign M_AWVALID = aw_pass;
+    assign S_AWREADY = (aw_pass && M_AWREADY) || aw_refuse;
+
+    assign M_WVALID = S_WVALID && w_pass;
+    assign S_WREADY = (w_pass && M_WREADY) || w_drop;
+
+    assign S_BID    = (b_inject) ? b_err_id : M_BID;
+    assign S_BRESP  = (b_inject) ? 2'b10 : M_BRESP;
+    assign S_BVALID = b_inject || M_BVALID;
+    assign M_BREADY = S_BREADY && !b_inject;
+
+    assign M_ARID    = (fetch) ? {id_bits {1'b0}} : S_ARID;
+    assign M_ARADDR  = (fetch) ? desc_addr : (off) ? S_ARADDR : r_phys + (S_ARADDR - r_lin);
+    assign M_ARLEN   = (fetch) ? `sg_beats - 1 : S_ARLEN;
+    assign M_ARSIZE  = (fetch) ? bw_bits : S_ARSIZE;
+    assign M_ARBURST = (fetch) ? 2'b01 : S_ARBURST;
+    assign M_ARVALID = fetch || ar_pass;
+    assign S_ARREADY = (ar_pass && M_ARREADY) || ar_refuse;
+
+    assign S_RID    = (r_inject) ? r_err_id : M_RID;
+    assign S_RDATA  = (r_inject) ? {`sg_data_bits {1'b0}} : M_RDATA;
+    assign S_RRESP  = (r_inject) ? 2'b10 : M_RRESP;
+    assign S_RLAST  = (r_inject) ? (r_err_beats == 0) : M_RLAST;
+    assign S_RVALID = r_inject || (M_RVALID && !collect);
+    assign M_RREADY = collect || (S_RREADY && !r_inject);
+
+    // the descriptor from its beats, the first beat lowest
+    generate
+        if (bw_bits < 4) begin : narrow
+            always @(posedge CLK) begin
+                if (collect && M_RVALID) desc <= {M_RDATA, desc[127:`sg_data_bits]};
+            end
+        end else if (bw_bits == 4) begin : exact
+            always @(posedge CLK) begin
+                if (collect && M_RVALID) desc <= M_RDATA;
+            end
+        end else begin : wide
+            always @(posedge CLK) begin
+                if (collect && M_RVALID) desc <= M_RDATA[desc_addr[bw_bits-1:4] * 128 +: 128];
+            end
+        end
+    endgenerate
+
+    always @(posedge CLK) begin
+        if (RESETn == 0) begin
+            error          <= 1'b0;
+            r_valid        <= 1'b0;
+            w_valid        <= 1'b0;
+            r_miss         <= 1'b0;
+            w_miss         <= 1'b0;
+            walk           <= 1'b0;
+            prefer_w       <= 1'b0;
+            fetch          <= 1'b0;
+            collect        <= 1'b0;
+            check          <= 1'b0;
+            rd_outstanding <= 8'd0;
+            ar_held        <= 1'b0;
+            r_err          <= 1'b0;
+            wr_outstanding <= 8'd0;
+            w_ahead        <= 1'b0;
+            wq_head        <= 2'd0;
+            wq_tail        <= 2'd0;
+            wq_count       <= 3'd0;
+            b_err          <= 1'b0;
+        end else begin
+            // reads passed on, finished, refused and answered
+            ar_held <= ar_pass && !M_ARREADY;
+            rd_outstanding <= rd_outstanding + (ar_pass && M_ARREADY) - (M_RVALID && M_RREADY && M_RLAST && !collect);
+            if (ar_refuse) begin
+                r_miss      <= 1'b0;
+                r_err       <= 1'b1;
+                r_err_id    <= S_ARID;
+                r_err_beats <= S_ARLEN;
+            end
+            if (r_inject && S_RREADY) begin
+                if (r_err_beats == 0) r_err <= 1'b0;
+                r_err_beats <= r_err_beats - 1;
+            end
+
+            // writes, the data of each address passed or dropped in order
+            wr_outstanding <= wr_outstanding + (aw_pass && M_AWREADY) - (M_BVALID && M_BREADY);
+            if (aw_take) w_ahead <= 1'b0;
+            else if (w_early) w_ahead <= 1'b1;
+            if (wq_push) begin
+                wq[wq_tail] <= aw_refuse;
+                wq_tail     <= wq_tail + 1;
+            end
+            if (wq_pop) begin
+                wq_head <= wq_head + 1;
+                if (wq[wq_head]) b_err_data <= 1'b1;
+            end
+            wq_count <= wq_count + wq_push - wq_pop;
+            if (aw_refuse) begin
+                w_miss     <= 1'b0;
+                b_err      <= 1'b1;
+                b_err_id   <= S_AWID;
+                b_err_data <= 1'b0;
+            end
+            if (b_inject && S_BREADY) b_err <= 1'b0;
+
+            // the walk: start from the segment the channel last used or from
+            // the first, then a descriptor at a time until one holds the address
+            if (!walk && (want_r || want_w)) begin
+                walk      <= 1'b1;
+                walk_w    <= pick_w;
+                prefer_w  <= !pick_w;
+                walk_addr <= (pick_w) ? S_AWADDR : S_ARADDR;
+                if (pick_w ? (w_valid && (S_AWADDR >= w_end)) : (r_valid && (S_ARADDR >= r_end))) begin
+                    walk_index <= (pick_w) ? w_index + 1 : r_index + 1;
+                    walk_lin   <= (pick_w) ? w_end : r_end;
+                end else begin
+                    walk_index <= 32'd0;
+                    walk_lin   <= {addr_bits {1'b0}};
+                end
+            end
+            if (walk && !fetch && !collect && !check) begin
+                if (walk_index >= COUNT) begin
+                    walk  <= 1'b0;
+                    error <= 1'b1;
+                    if (walk_w) w_miss <= 1'b1;
+                    else r_miss <= 1'b1;
+                end else if ((rd_outstanding == 0) && !ar_held && !r_err) begin
+                    fetch      <= 1'b1;
+                    desc_error <= 1'b0;
+                end
+            end
+            if (fetch && M_ARREADY) begin
+                fetch   <= 1'b0;
+                collect <= 1'b1;
+            end
+            if (collect && M_RVALID) begin
+                if (M_RRESP[1]) desc_error <= 1'b1;
+                if (M_RLAST) begin
+                    collect <= 1'b0;
+                    check   <= 1'b1;
+                end
+            end
+            if (check) begin
+                check <= 1'b0;
+                if (desc_error) begin
+                    walk  <= 1'b0;
+                    error <= 1'b1;
+                    if (walk_w) w_miss <= 1'b1;
+                    else r_miss <= 1'b1;
+                end else if (walk_addr < seg_end) begin
+                    walk <= 1'b0;
+                    if (walk_w) begin
+                        w_valid <= 1'b1;
+                        w_index <= walk_index;
+                        w_lin   <= walk_lin;
+                        w_end   <= seg_end;
+                        w_phys  <= desc[addr_bits-1:0];
+                    end else begin
+                        r_valid <= 1'b1;
+                        r_index <= walk_index;
+                        r_lin   <= walk_lin;
+                        r_end   <= seg_end;
+                        r_phys  <= desc[addr_bits-1:0];
+                    end
+                end else begin
+                    walk_index <= walk_index + 1;
+                    walk_lin   <= seg_end;
+                end
+            end
+
+            if (FLUSH) begin
+                r_valid <= 1'b0;
+                w_valid <= 1'b0;
+                r_miss  <= 1'b0;
+                w_miss  <= 1'b0;
+            end
+            if (CLEAR) error <= 1'b0;
+        end
+    end
+
+endmodule
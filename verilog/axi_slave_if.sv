@@ -73,12 +73,23 @@ module axi_slave_interface
     parameter id_bits  = 2;
     parameter p_size   = 3;   // peripheral data width in 2^p_size bytes
     parameter b_size   = 3;   // bus width in 2^b_size bytes
+    parameter rd_prefetch = 4; // read beats fetched ahead of RREADY, 3 or more streams one beat per cycle
+    parameter exclusive = 1;   // 1 answers exclusive accesses with EXOKAY through an exclusive monitor
+    parameter rd_latency = 1;  // cycles from SRAM_OUTPUT_ENABLE to SRAM_READ_DATA, streaming needs rd_prefetch >= rd_latency+2
+    parameter aw_slice = 0;    // register slice on each channel, 0 bypass, 1 forward, 2 backward, 3 full (axi_reg_slice)
+    parameter w_slice  = 0;
+    parameter b_slice  = 0;
+    parameter ar_slice = 0;
+    parameter r_slice  = 0;
 
 `define p_bytes (1<<p_size)
 `define b_bytes (1<<b_size)
 `define lanes   (1<<(b_size-p_size))
+`define rd_fifo_depth ((rd_prefetch < 2) ? 2 : rd_prefetch)
 `define b_bits  (8 * (1<<b_size))
 `define p_bits  (8 * (1<<p_size))
+`define rd_ctx_bits (masters + id_bits + 1 + `resp_bits + 1 + 1 + 8)
+`define a_bits  (masters + id_bits + width + `len_bits + `size_bits + `burst_bits + `lock_bits + `cache_bits + `prot_bits)
 
     input                             ACLK;
     input                             ARESETn;
@@ -139,61 +150,136 @@ module axi_slave_interface
     output                            SRAM_WRITE_STROBE;
 
 
+    // the port side of the channel slices, I_ names the inner side
+
+    wire   [masters-1:0]              I_AWMASTER;
+    wire   [id_bits-1:0]              I_AWID;
+    wire   [width-1:0]                I_AWADDR;
+    wire   [`len_bits-1:0]            I_AWLEN;
+    wire   [`size_bits-1:0]           I_AWSIZE;
+    wire   [`burst_bits-1:0]          I_AWBURST;
+    wire   [`lock_bits-1:0]           I_AWLOCK;
+    wire   [`cache_bits-1:0]          I_AWCACHE;
+    wire   [`prot_bits-1:0]           I_AWPROT;
+    wire                              I_AWVALID;
+    wire                              I_AWREADY;
+
+    wire   [masters-1:0]              I_WMASTER;
+    wire   [id_bits-1:0]              I_WID;
+    wire   [(`b_bits)-1:0]            I_WDATA;
+    wire   [(`b_bytes)-1:0]           I_WSTRB;
+    wire                              I_WLAST;
+    wire                              I_WVALID;
+    wire                              I_WREADY;
+
+    wire   [masters-1:0]              I_BMASTER;
+    wire   [id_bits-1:0]              I_BID;
+    wire   [`resp_bits-1:0]           I_BRESP;
+    wire                              I_BVALID;
+    wire                              I_BREADY;
+
+    wire   [masters-1:0]              I_ARMASTER;
+    wire   [id_bits-1:0]              I_ARID;
+    wire   [width-1:0]                I_ARADDR;
+    wire   [`len_bits-1:0]            I_ARLEN;
+    wire   [`size_bits-1:0]           I_ARSIZE;
+    wire   [`burst_bits-1:0]          I_ARBURST;
+    wire   [`lock_bits-1:0]           I_ARLOCK;
+    wire   [`cache_bits-1:0]          I_ARCACHE;
+    wire   [`prot_bits-1:0]           I_ARPROT;
+    wire                              I_ARVALID;
+    wire                              I_ARREADY;
+
+    wire   [masters-1:0]              I_RMASTER;
+    wire   [id_bits-1:0]              I_RID;
+    wire   [(`b_bits)-1:0]            I_RDATA;
+    wire   [`resp_bits-1:0]           I_RRESP;
+    wire                              I_RLAST;
+    wire                              I_RVALID;
+    wire                              I_RREADY;
+
     wire   [masters-1:0]              O_RMASTER;
     wire   [width-1:0]                O_RADDR;
     wire   [id_bits-1:0]              O_RID;
     wire                              O_RLAST;
+    wire                              O_RFIRST;
+    wire                              O_RBEAT_LAST;
+    wire   [`lock_bits-1:0]           O_RLOCK;
 
     wire   [masters-1:0]              O_WMASTER;
     wire   [width-1:0]                O_WADDR;
     wire   [id_bits-1:0]              O_WID;
     wire                              O_WLAST;
+    wire                              O_WFIRST;
+    wire                              O_WBEAT_LAST;
+    wire   [`lock_bits-1:0]           O_WLOCK;
 
     reg                               O_BVALID;
     reg    [masters-1:0]              O_BMASTER;
     reg    [id_bits-1:0]              O_BID;
+    reg    [`resp_bits-1:0]           O_BRESP;
 
-    reg    [masters-1:0]              D_MASTER;
-    reg    [id_bits-1:0]              D_ID;
+    wire   [masters-1:0]              D_MASTER;
+    wire   [id_bits-1:0]              D_ID;
     wire                              WRITE_ADDR_VALID;
     wire                              WRITE_ADDR_READY;
     wire                              D_RADDR_VALID;
     wire                              D_RADDR_READY;
-    reg    [(`b_bytes)-1:0]           D_BE;
-    reg                               D_LAST;
-    reg    [(`b_bits)-1:0]            D_RDATA;
-    reg    [(`b_bits)-1:0]            D_WDATA;
-    reg                               read_partial_data_valid;
+    wire                              D_LAST;
+    wire   [`resp_bits-1:0]           D_RESP;
+    wire   [(`b_bits)-1:0]            D_RDATA;
     wire                              READ_DATA_VALID;
     wire                              READ_DATA_READY;
 
-    wire [1:0]                        rresp_tmp;
     reg                               write_cycle_active;
 
     reg  [masters:0]                  write_master;   // holds master for current write cycle
     reg  [id_bits-1:0]                write_id;       // holds transaction id for current write cycle
-    reg  [7:0]                        sent_byte_count;
-    reg  [7:0]                        bus_width = `b_bytes;
+    reg  [`resp_bits-1:0]             write_resp;     // response for the write cycle waiting on B
 
-    wire                              strobe_aw           = AWVALID && AWREADY;
-    wire                              strobe_w            = WVALID  && WREADY;
+    wire                              strobe_aw           = I_AWVALID && I_AWREADY;
+    wire                              strobe_w            = I_WVALID  && I_WREADY;
     wire                              strobe_wd           = WRITE_ADDR_VALID && WRITE_ADDR_READY;
-    wire                              strobe_b            = BVALID  && BREADY;
-    wire                              strobe_ar           = ARVALID && ARREADY;
-    wire                              strobe_r            = RVALID  && RREADY;
+    wire                              strobe_b            = I_BVALID  && I_BREADY;
+    wire                              strobe_ar           = I_ARVALID && I_ARREADY;
+    wire                              strobe_r            = I_RVALID  && I_RREADY;
 
     wire [(`p_bits)-1:0]              p_wdata; 
     wire [(`p_bits)-1:0]              p_rdata; 
     wire [(`p_bytes)-1:0]             p_be;
-
-    wire [31:0]                       payload_aw     = strobe_aw ? AWADDR : 32'hzzzzzzzz;
-    wire [(`b_bits)-1:0]              payload_w      = strobe_w  ? WDATA  : 64'hzzzzzzzzzzzzzzzz;
+    wire [(`b_bytes)-1:0]             w_strb;          // WSTRB, cleared for a failed exclusive write
+    wire [width-1:0]                  p_waddr;
+    wire                              p_we;
+    wire [width-1:0]                  p_raddr;
+    wire                              p_oe;
+
+    wire                              write_slot;      // one peripheral write beat can be taken
+    wire                              rd_issue;        // one peripheral read beat is sent to the SRAM
+    wire                              rd_credit;       // room for another bus beat on the R channel
+    wire                              rd_pending;      // SRAM read data is returned this cycle
+    wire                              rd_beat_last;
+    wire                              rd_hit;          // read served from the upsize word cache
+    wire                              rd_was_hit;
+    wire [7:0]                        rd_addr_lo;      // low address bits of the returning beat
+    wire [`rd_ctx_bits-1:0]           rd_ctx;          // what the returning beat needs from its issue
+    reg  [rd_latency-1:0]             rd_issue_pipe;
+    reg  [`rd_ctx_bits-1:0]           rd_ctx_pipe[rd_latency-1:0];
+    reg  [7:0]                        rd_outstanding;  // bus beats issued and not yet taken by the master
+
+    wire                              ex_hit;          // reservation of the write master still holds
+    reg                               ex_okay;         // first beat of the write burst passed the monitor
+    wire                              wr_exclusive = exclusive && O_WLOCK[0];
+    wire                              wr_exokay    = wr_exclusive && ((O_WFIRST) ? ex_hit : ex_okay);
+    wire                              wr_suppress  = wr_exclusive && !wr_exokay;
+
+    wire [31:0]                       payload_aw     = strobe_aw ? I_AWADDR : 32'hzzzzzzzz;
+    wire [(`b_bits)-1:0]              payload_w      = strobe_w  ? I_WDATA  : 64'hzzzzzzzzzzzzzzzz;
     wire [(`b_bits)-1:0]              payload_wd     = strobe_wd ? p_wdata: 64'hzzzzzzzzzzzzzzzz;
-    wire [31:0]                       payload_ra     = strobe_ar ? ARADDR : 32'hzzzzzzzz;
-    wire [(`b_bits)-1:0]              payload_r      = strobe_r  ? RDATA  : 64'hzzzzzzzzzzzzzzzz;
+    wire [31:0]                       payload_ra     = strobe_ar ? I_ARADDR : 32'hzzzzzzzz;
+    wire [(`b_bits)-1:0]              payload_r      = strobe_r  ? I_RDATA  : 64'hzzzzzzzzzzzzzzzz;
 
     wire                              write_done          = strobe_w;
-    wire                              generate_response   = strobe_w && WLAST;
+    wire                              generate_response   = strobe_w && I_WLAST;
     wire                              send_response;
     reg                               b_wait;
     reg                               address_error;
@@ -202,31 +288,93 @@ module axi_slave_interface
     wire                              get_more_data;
 
     genvar n;
+    integer i;
+
+    assign w_strb = (wr_suppress) ? {`b_bytes {1'b0}} : I_WSTRB;
+
+    // channel register slices, wires unless the *_slice parameters ask for
+    // registers to trade latency for timing at the port
+
+    axi_reg_slice #(`a_bits, aw_slice) aw_reg_slice (
+        .CLK           (ACLK),
+        .RESETn        (ARESETn),
+        .S_DATA        ({AWMASTER, AWID, AWADDR, AWLEN, AWSIZE, AWBURST, AWLOCK, AWCACHE, AWPROT}),
+        .S_VALID       (AWVALID),
+        .S_READY       (AWREADY),
+        .M_DATA        ({I_AWMASTER, I_AWID, I_AWADDR, I_AWLEN, I_AWSIZE, I_AWBURST, I_AWLOCK, I_AWCACHE, I_AWPROT}),
+        .M_VALID       (I_AWVALID),
+        .M_READY       (I_AWREADY)
+    );
+
+    axi_reg_slice #(masters + id_bits + `b_bits + `b_bytes + 1, w_slice) w_reg_slice (
+        .CLK           (ACLK),
+        .RESETn        (ARESETn),
+        .S_DATA        ({WMASTER, WID, WDATA, WSTRB, WLAST}),
+        .S_VALID       (WVALID),
+        .S_READY       (WREADY),
+        .M_DATA        ({I_WMASTER, I_WID, I_WDATA, I_WSTRB, I_WLAST}),
+        .M_VALID       (I_WVALID),
+        .M_READY       (I_WREADY)
+    );
+
+    axi_reg_slice #(masters + id_bits + `resp_bits, b_slice) b_reg_slice (
+        .CLK           (ACLK),
+        .RESETn        (ARESETn),
+        .S_DATA        ({I_BMASTER, I_BID, I_BRESP}),
+        .S_VALID       (I_BVALID),
+        .S_READY       (I_BREADY),
+        .M_DATA        ({BMASTER, BID, BRESP}),
+        .M_VALID       (BVALID),
+        .M_READY       (BREADY)
+    );
+
+    axi_reg_slice #(`a_bits, ar_slice) ar_reg_slice (
+        .CLK           (ACLK),
+        .RESETn        (ARESETn),
+        .S_DATA        ({ARMASTER, ARID, ARADDR, ARLEN, ARSIZE, ARBURST, ARLOCK, ARCACHE, ARPROT}),
+        .S_VALID       (ARVALID),
+        .S_READY       (ARREADY),
+        .M_DATA        ({I_ARMASTER, I_ARID, I_ARADDR, I_ARLEN, I_ARSIZE, I_ARBURST, I_ARLOCK, I_ARCACHE, I_ARPROT}),
+        .M_VALID       (I_ARVALID),
+        .M_READY       (I_ARREADY)
+    );
+
+    axi_reg_slice #(masters + id_bits + `b_bits + `resp_bits + 1, r_slice) r_reg_slice (
+        .CLK           (ACLK),
+        .RESETn        (ARESETn),
+        .S_DATA        ({I_RMASTER, I_RID, I_RDATA, I_RRESP, I_RLAST}),
+        .S_VALID       (I_RVALID),
+        .S_READY       (I_RREADY),
+        .M_DATA        ({RMASTER, RID, RDATA, RRESP, RLAST}),
+        .M_VALID       (RVALID),
+        .M_READY       (RREADY)
+    );
 
-    assign RRESP = 2'b00;
-    assign BRESP = 2'b00;
 
-    axi_addr_latch #(masters, width, p_size) write_address_request_bus (
+    axi_addr_latch #(masters, width, p_size, id_bits, b_size) write_address_request_bus (
         .CLK           (ACLK),
         .RESETN        (ARESETn),
 
-        .MASTER        (AWMASTER),
-        .ID            (AWID),
-        .ADDR          (AWADDR),
-        .LEN           (AWLEN),
-        .SIZE          (AWSIZE),
-        .BURST         (AWBURST),
-        .LOCK          (AWLOCK),
-        .CACHE         (AWCACHE),
-        .PROT          (AWPROT),
+        .MASTER        (I_AWMASTER),
+        .ID            (I_AWID),
+        .ADDR          (I_AWADDR),
+        .LEN           (I_AWLEN),
+        .SIZE          (I_AWSIZE),
+        .BURST         (I_AWBURST),
+        .LOCK          (I_AWLOCK),
+        .CACHE         (I_AWCACHE),
+        .PROT          (I_AWPROT),
 
-        .VALID         (AWVALID),
-        .READY         (AWREADY),
+        .VALID         (I_AWVALID),
+        .READY         (I_AWREADY),
 
         .O_MASTER      (O_WMASTER),
         .O_ID          (O_WID),
         .O_ADDR        (O_WADDR),
         .O_LAST        (O_WLAST),
+        .O_FIRST       (O_WFIRST),
+        .O_BEAT_LAST   (O_WBEAT_LAST),
+        .O_LOCK        (O_WLOCK),
 
         .O_VALID       (WRITE_ADDR_VALID),
         .O_READY       (WRITE_ADDR_READY)
@@ -237,12 +385,17 @@ module axi_slave_interface
             write_master <= 32'h00000000;
             write_cycle_active <= 0;
             more_data <= 0;
+            ex_okay <= 0;
         end else begin
             if (strobe_wd) begin
                 write_master <= O_WMASTER;
                 write_id <= O_WID;
                 more_data <= !O_WLAST;
                 write_cycle_active <= 1;
+                if (O_WFIRST) ex_okay <= ex_hit;
+            end
+            if (generate_response) begin
+                write_resp <= (wr_exokay) ? 2'b01 : 2'b00;
             end
             if (strobe_b) begin
                 write_cycle_active <= 0;
@@ -259,18 +412,21 @@ module axi_slave_interface
     ready_gen #(0) ready_gen_write_data (  // wait states on the address write data bus
             .CLK         (ACLK),
             .RESETn      (ARESETn),
-            .STROBE      (WVALID && WRITE_ADDR_VALID & get_more_data),  
-            .READY       (WREADY)
+            .STROBE      (I_WVALID && WRITE_ADDR_VALID & get_more_data),  
+            .READY       (write_slot)
     );
   
-    assign WRITE_ADDR_READY = WREADY;
+    // a bus beat is held on W until every peripheral beat it covers is written
+
+    assign WRITE_ADDR_READY = write_slot;
+    assign I_WREADY         = write_slot && O_WBEAT_LAST;
 
     always @(posedge ACLK) begin
         if (ARESETn) begin
              address_error <= 0;
         end else begin
             if (strobe_w) begin
-                 if ((write_master != WMASTER) || (write_id != WID)) address_error <= 1;
+                 if ((write_master != I_WMASTER) || (write_id != I_WID)) address_error <= 1;
             end
             if (strobe_wd) begin
                  if ((write_master != O_WMASTER) || (write_id != O_WID)) address_error <= 1;
@@ -298,22 +454,25 @@ module axi_slave_interface
             .READY       (send_response)
     );
              
-    assign BVALID = O_BVALID;
-    assign BMASTER = O_BMASTER;
-    assign BID = O_BID;
+    assign I_BVALID = O_BVALID;
+    assign I_BMASTER = O_BMASTER;
+    assign I_BID = O_BID;
+    assign I_BRESP = O_BRESP;
 
     always @(posedge ACLK) begin
         if (ARESETn == 0) begin
             O_BVALID <= 0;
             O_BMASTER <= 32'hzzzzzzzz;
             O_BID <= 32'hzzzzzzzz;
+            O_BRESP <= 2'b00;
         end else begin
             if (send_response) begin
                 O_BVALID <= 1;
                 O_BMASTER <= write_master;
                 O_BID <= write_id;
+                O_BRESP <= write_resp;
             end
-            if (O_BVALID && BREADY) begin
+            if (O_BVALID && I_BREADY) begin
                 O_BVALID <= 0;
                 O_BMASTER <= 32'hzzzzzzzz;
                 O_BID <= 32'hzzzzzzzz;
@@ -321,125 +480,267 @@ module axi_slave_interface
         end
     end
 
-    axi_addr_latch #(masters, width, p_size) read_address_request_bus (
+    axi_addr_latch #(masters, width, p_size, id_bits, b_size) read_address_request_bus (
         .CLK           (ACLK),
         .RESETN        (ARESETn),
 
-        .MASTER        (ARMASTER),
-        .ID            (ARID),
-        .ADDR          (ARADDR),
-        .LEN           (ARLEN),
-        .SIZE          (ARSIZE),
-        .BURST         (ARBURST),
-        .LOCK          (ARLOCK),
-        .CACHE         (ARCACHE),
-        .PROT          (ARPROT),
+        .MASTER        (I_ARMASTER),
+        .ID            (I_ARID),
+        .ADDR          (I_ARADDR),
+        .LEN           (I_ARLEN),
+        .SIZE          (I_ARSIZE),
+        .BURST         (I_ARBURST),
+        .LOCK          (I_ARLOCK),
+        .CACHE         (I_ARCACHE),
+        .PROT          (I_ARPROT),
 
-        .VALID         (ARVALID),
-        .READY         (ARREADY),
+        .VALID         (I_ARVALID),
+        .READY         (I_ARREADY),
 
         .O_MASTER      (O_RMASTER),
         .O_ID          (O_RID),
         .O_ADDR        (O_RADDR),
         .O_LAST        (O_RLAST),
+        .O_FIRST       (O_RFIRST),
+        .O_BEAT_LAST   (O_RBEAT_LAST),
+        .O_LOCK        (O_RLOCK),
 
         .O_VALID       (D_RADDR_VALID),
         .O_READY       (D_RADDR_READY)
     );
 
-    ready_gen #(0) data_ready (ACLK, ARESETn, D_RADDR_VALID, D_RADDR_READY);
+    ready_gen #(0) data_ready (ACLK, ARESETn, D_RADDR_VALID && rd_credit, D_RADDR_READY);
          
+    assign rd_issue  = D_RADDR_VALID && D_RADDR_READY;
+    // reads run ahead of I_RREADY as long as the return FIFO has room for the
+    // beat, the address latch follows INCR and WRAP order so a WRAP burst
+    // returns the critical word first
+
+    assign rd_credit = (rd_outstanding < rd_prefetch) ? 1'b1 : 1'b0;
+
+    // the issue side of each beat travels with it for the rd_latency cycles
+    // the SRAM takes, so a pipelined read port keeps beats in order
+
+    assign rd_ctx = { O_RMASTER, O_RID, O_RLAST, (exclusive && O_RLOCK[0]) ? 2'b01 : 2'b00,
+                      O_RBEAT_LAST, rd_hit, O_RADDR[7:0] };
+    assign { D_MASTER, D_ID, D_LAST, D_RESP, rd_beat_last, rd_was_hit, rd_addr_lo } = rd_ctx_pipe[rd_latency-1];
+    assign rd_pending = rd_issue_pipe[rd_latency-1];
+
     always @(posedge ACLK) begin
-         D_MASTER <= O_RMASTER;
-         D_ID     <= O_RID;
-         D_LAST   <= O_RLAST;
+         rd_ctx_pipe[0] <= rd_ctx;
+         for (i=1; i<rd_latency; i=i+1) rd_ctx_pipe[i] <= rd_ctx_pipe[i-1];
     end 
 
+    // exclusive access: an exclusive read reserves its block when the burst
+    // starts, an exclusive write is checked on its first beat and, if the
+    // reservation is gone, runs with its strobes cleared and answers OKAY.
+    // Every write that reaches the SRAM drops reservations on its block.
+
+    generate
+        if (exclusive) begin : monitor
+            axi_excl_monitor #(masters, id_bits, width) excl_monitor (
+                .CLK           (ACLK),
+                .RESETn        (ARESETn),
+
+                .SET           (rd_issue && O_RFIRST && O_RLOCK[0]),
+                .SET_MASTER    (O_RMASTER),
+                .SET_ID        (O_RID),
+                .SET_ADDR      (O_RADDR),
+
+                .CHECK_MASTER  (O_WMASTER),
+                .CHECK_ID      (O_WID),
+                .CHECK_ADDR    (O_WADDR),
+                .HIT           (ex_hit),
+
+                .CLEAR         (strobe_wd && (|w_strb)),
+                .CLEAR_ADDR    (O_WADDR)
+            );
+        end else begin
+            assign ex_hit = 1'b0;
+        end
+    endgenerate
+
+    always @(posedge ACLK) begin
+        if (!ARESETn) begin
+            rd_issue_pipe  <= {rd_latency {1'b0}};
+            rd_outstanding <= 8'h00;
+        end else begin
+            rd_issue_pipe  <= {rd_issue_pipe, rd_issue};     // top bit drops off
+            rd_outstanding <= rd_outstanding + ((rd_issue && O_RBEAT_LAST) ? 1 : 0) - ((strobe_r) ? 1 : 0);
+        end
+    end
+
     // connections out to the SRAM device
 
-    assign SRAM_READ_ADDRESS        = O_RADDR[width-1:p_size];
+    assign SRAM_READ_ADDRESS        = p_raddr;
     assign p_rdata                  = SRAM_READ_DATA;
-    assign SRAM_OUTPUT_ENABLE       = D_RADDR_VALID;
+    assign SRAM_OUTPUT_ENABLE       = p_oe;
  
-    assign SRAM_WRITE_ADDRESS       = O_WADDR[width-1:p_size];
+    assign SRAM_WRITE_ADDRESS       = p_waddr;
     assign SRAM_WRITE_DATA          = p_wdata;
     assign SRAM_WRITE_BYTE_ENABLE   = p_be;
-    assign SRAM_WRITE_STROBE        = strobe_w;   
-
-    assign D_WDATA = (strobe_w) ? WDATA : D_WDATA;   // latch and hold the WDATA from the master
-    assign D_BE    = (strobe_w) ? WSTRB : D_BE;      // latch and hold the WSTRB (byte enables) from the master
+    assign SRAM_WRITE_STROBE        = p_we;   
 
+    assign p_raddr = O_RADDR[width-1:p_size];
 
     generate 
 
         if (b_size == p_size) begin
 
+            assign p_waddr = O_WADDR[width-1:p_size];
+            assign p_wdata = I_WDATA;
+            assign p_be    = w_strb;
+            assign p_we    = strobe_w;
+            assign p_oe    = rd_issue;
+            assign rd_hit  = 1'b0;
+
             assign D_RDATA = p_rdata;
-            assign p_wdata = D_WDATA;
-            assign p_be    = D_BE;
+            assign READ_DATA_VALID = rd_pending;
 
         end 
-        if (b_size > p_size) begin
-
-            assign p_wdata = D_WDATA >> 8 * { (O_WADDR[(b_size-1):p_size]), {(p_size) {1'b0}}};
-            assign p_be    = D_BE    >>     { (O_WADDR[(b_size-1):p_size]), {(p_size) {1'b0}}};
+        if (b_size > p_size) begin : downsize
+
+            // each bus beat covers `lanes peripheral words, the address latch steps
+            // through them one per cycle and the W beat is held until the last one
+
+            wire [b_size-p_size-1:0]  rd_lane = rd_addr_lo[b_size-1:p_size];
+            reg  [(`b_bits)-1:0]      rd_beat;
+            wire [(`b_bits)-1:0]      rd_assembled;
+            wire [b_size-p_size-1:0]  wr_lane = O_WADDR[b_size-1:p_size];
+
+            assign p_waddr = O_WADDR[width-1:p_size];
+            assign p_wdata = I_WDATA >> (`p_bits * wr_lane);
+            assign p_be    = w_strb >> (`p_bytes * wr_lane);
+            assign p_we    = write_slot && (|p_be);    // lanes without strobes need no SRAM cycle
+            assign p_oe    = rd_issue;
+            assign rd_hit  = 1'b0;
+
+            for (n=0; n<`lanes; n=n+1) begin : lane
+                assign rd_assembled[`p_bits*(n+1)-1:`p_bits*n] = (rd_lane == n) ? 
+                    p_rdata : rd_beat[`p_bits*(n+1)-1:`p_bits*n];
+            end
 
-            for (n=0; n<`lanes; n=n+1) begin
-                assign D_RDATA[`p_bits*(n+1)-1:`p_bits*n] = (read_partial_data_valid && 
-                    (O_RADDR[b_size-1:p_size] == n)) ?  p_rdata : D_RDATA[`p_bits*(n+1)-1:`p_bits*n];
+            always @(posedge ACLK) begin
+                if (rd_pending) rd_beat <= rd_assembled;
             end
 
+            assign D_RDATA = rd_assembled;
+            assign READ_DATA_VALID = rd_pending && rd_beat_last;
+
         end
-        if (b_size < p_size) begin
-           always @(posedge ACLK) $display("this combination yet not implemented");
+        if (b_size < p_size) begin : upsize
+
+            // narrow bus beats are gathered into one wide SRAM write, byte enables
+            // merged, and the word is written when the burst moves to another word
+            // or ends.  Reads keep the last SRAM word and serve the following beats
+            // of the burst from it without another SRAM access.
+
+            wire [width-1:0]          wr_word = O_WADDR[width-1:p_size];
+            wire [p_size-b_size-1:0]  wr_lane = O_WADDR[p_size-1:b_size];
+            wire [(`p_bits)-1:0]      wr_data = {{(`p_bits-`b_bits) {1'b0}}, I_WDATA} << (`b_bits * wr_lane);
+            wire [(`p_bytes)-1:0]     wr_be   = {{(`p_bytes-`b_bytes) {1'b0}}, w_strb} << (`b_bytes * wr_lane);
+            wire [(`p_bits)-1:0]      wr_merged;
+
+            reg                       acc_valid;
+            reg                       acc_flush;
+            reg  [width-1:0]          acc_word;
+            reg  [(`p_bits)-1:0]      acc_data;
+            reg  [(`p_bytes)-1:0]     acc_be;
+
+            reg                       up_we;
+            reg  [width-1:0]          up_waddr;
+            reg  [(`p_bits)-1:0]      up_wdata;
+            reg  [(`p_bytes)-1:0]     up_wbe;
+
+            wire [width-1:0]          rd_word = O_RADDR[width-1:p_size];
+            wire [(`p_bits)-1:0]      rd_data;
+            wire [p_size-b_size-1:0]  rd_lane = rd_addr_lo[p_size-1:b_size];
+            reg                       rbuf_valid;
+            reg  [width-1:0]          rbuf_word;
+            reg  [(`p_bits)-1:0]      rbuf_data;
+
+            for (n=0; n<`p_bytes; n=n+1) begin : merge
+                assign wr_merged[8*n+7:8*n] = (wr_be[n]) ? wr_data[8*n+7:8*n] : acc_data[8*n+7:8*n];
+            end
+
+            always @(posedge ACLK) begin
+                if (!ARESETn) begin
+                    acc_valid <= 1'b0;
+                    acc_flush <= 1'b0;
+                    up_we     <= 1'b0;
+                end else begin
+                    up_we <= 1'b0;
+                    if (acc_valid && (acc_flush || (strobe_w && (wr_word != acc_word)))) begin
+                        up_we     <= 1'b1;
+                        up_waddr  <= acc_word;
+                        up_wdata  <= acc_data;
+                        up_wbe    <= acc_be;
+                        acc_valid <= strobe_w;
+                        acc_flush <= 1'b0;
+                        acc_word  <= wr_word;
+                        acc_data  <= wr_data;
+                        acc_be    <= wr_be;
+                    end else if (strobe_w) begin
+                        acc_valid <= 1'b1;
+                        acc_word  <= wr_word;
+                        acc_data  <= wr_merged;
+                        acc_be    <= ((acc_valid) ? acc_be : {`p_bytes {1'b0}}) | wr_be;
+                    end
+                    if (strobe_w && I_WLAST) acc_flush <= 1'b1;
+                end
+            end
+
+            assign p_waddr = up_waddr;
+            assign p_wdata = up_wdata;
+            assign p_be    = up_wbe;
+            assign p_we    = up_we;
+
+            assign rd_hit  = rbuf_valid && !O_RFIRST && (rbuf_word == rd_word);
+            assign p_oe    = rd_issue && !rd_hit;
+            assign rd_data = (rd_was_hit) ? rbuf_data : p_rdata;
+
+            always @(posedge ACLK) begin
+                if (!ARESETn) begin
+                    rbuf_valid <= 1'b0;
+                end else begin
+                    if (rd_issue) begin
+                        rbuf_valid <= 1'b1;
+                        rbuf_word  <= rd_word;
+                    end
+                    if (up_we && (up_waddr == rbuf_word) && !(rd_issue && (rd_word != rbuf_word))) begin
+                        rbuf_valid <= 1'b0;
+                    end
+                    if (rd_pending) rbuf_data <= rd_data;
+                end
+            end
+
+            assign D_RDATA = rd_data >> (`b_bits * rd_lane);
+            assign READ_DATA_VALID = rd_pending;
+
         end
 
     endgenerate
 
-    // assign correct lane of WDATA to p_wdata
-
-    axi_data_latch #(masters, id_bits, `b_bits) read_data_response (
+    axi_data_latch #(masters, id_bits, `b_bits, `rd_fifo_depth) read_data_response (
          .CLK          (ACLK),
          .RESETN       (ARESETn),
          .MASTER       (D_MASTER),
          .ID           (D_ID),
          .DATA         (D_RDATA),
+         .RESP         (D_RESP),
          .LAST         (D_LAST),
 
          .VALID        (READ_DATA_VALID),
          .READY        (READ_DATA_READY),
 
-         .O_MASTER     (RMASTER),
-         .O_ID         (RID),
-         .O_DATA       (RDATA),
-         .O_RESP       (rresp_tmp),
-         .O_LAST       (RLAST),
+         .O_MASTER     (I_RMASTER),
+         .O_ID         (I_RID),
+         .O_DATA       (I_RDATA),
+         .O_RESP       (I_RRESP),
+         .O_LAST       (I_RLAST),
 
-         .O_VALID      (RVALID),
-         .O_READY      (RREADY)
+         .O_VALID      (I_RVALID),
+         .O_READY      (I_RREADY)
     );
 
-    generate 
-        if (b_size == p_size) begin
-            assign READ_DATA_VALID = read_partial_data_valid;
-        end else begin  
-            assign READ_DATA_VALID = read_partial_data_valid && (D_LAST || (sent_byte_count == bus_width));
-        end
-    endgenerate
-
-    always @(posedge ACLK) begin
-        if (!ARESETn) begin
-            read_partial_data_valid <= 0;
-            sent_byte_count <= 0;
-        end else begin
-            if (D_RADDR_VALID && D_RADDR_READY) begin
-                read_partial_data_valid <= 1;
-            end 
-            if (read_partial_data_valid && READ_DATA_READY) begin
-                read_partial_data_valid <= 0;
-                sent_byte_count <= (D_LAST) ? 8'h00 : sent_byte_count + 1;
-            end
-        end
-    end
-
 endmodule
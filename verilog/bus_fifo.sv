@@ -10,13 +10,24 @@ module bus_fifo
         DATA_READY,
         DATA_OUT,
         DATA_ACK,
-        FULL
+        FULL,
+        ALMOST_FULL,
+        ALMOST_EMPTY
     );
 
-    parameter width = 8;
-    parameter depth = 8;
+    parameter width        = 8;
+    parameter depth        = 8;            // number of entries, 2 or more
+    parameter almost_full  = depth - 1;    // ALMOST_FULL when at least this many entries are held
+    parameter almost_empty = 1;            // ALMOST_EMPTY when at most this many entries are held
+    parameter skid         = 0;            // 1 adds a second output register, DATA_ACK then does not reach the memory read
+    parameter block_ram    = 0;            // 1 reads the memory through a register so it maps onto block RAM
     `define cwidth $clog2(depth)
 
+    // first word fall through: the head entry sits in an output register and
+    // DATA_READY is raised the cycle after the push.  A push and a pop can be
+    // taken every cycle.  With block_ram the memory has a registered read and
+    // no bypass, which adds a cycle of latency through an empty FIFO.
+
     input                 CLK;
     input                 RESET_N;
     input                 DATA_STROBE;
@@ -25,35 +36,134 @@ module bus_fifo
     output [width-1:0]    DATA_OUT;
     input                 DATA_ACK;
     output                FULL;
+    output                ALMOST_FULL;
+    output                ALMOST_EMPTY;
 
-    reg    [width-1:0]    fifo_mem[(1<<depth)-1:0];
     reg    [`cwidth-1:0]  input_pointer;
     reg    [`cwidth-1:0]  output_pointer;
+    reg    [`cwidth:0]    ram_count;      // entries held in fifo_mem
+    reg    [`cwidth:0]    count;          // entries held in total
+    reg                   full;
+    reg                   almost_full_r;
+    reg                   almost_empty_r;
+
+    reg    [width-1:0]    out_data0;      // head of the FIFO
+    reg    [width-1:0]    out_data1;      // skid entry behind the head
+    reg                   out_valid0;
+    reg                   out_valid1;
+
+    wire                  push;
+    wire                  pop;
+    wire                  take;           // output stage loads src_data this cycle
+    wire                  src_valid;
+    wire   [width-1:0]    src_data;
+    wire                  ram_write;
+    wire                  ram_read;
+    wire   [`cwidth:0]    count_next;
+
+    assign push       = DATA_STROBE && !full;
+    assign pop        = DATA_ACK && out_valid0;
+    assign take       = src_valid && ((skid) ? !out_valid1 : (!out_valid0 || pop));
+    assign count_next = count + ((push) ? 1 : 0) - ((pop) ? 1 : 0);
+
+    assign DATA_READY   = out_valid0;
+    assign DATA_OUT     = out_data0;
+    assign FULL         = full;
+    assign ALMOST_FULL  = almost_full_r;
+    assign ALMOST_EMPTY = almost_empty_r;
+
+    generate
+
+        if (block_ram) begin : bram
+
+            (* ram_style = "block" *) reg [width-1:0] fifo_mem[depth-1:0];
+            reg    [width-1:0]    ram_q;
+            reg                   ram_q_valid;
+
+            assign ram_write = push;
+            assign ram_read  = (ram_count != 0) && (!ram_q_valid || take);
+            assign src_valid = ram_q_valid;
+            assign src_data  = ram_q;
+
+            always @(posedge CLK) begin
+                if (ram_write) fifo_mem[input_pointer] <= DATA_IN;
+                if (ram_read)  ram_q <= fifo_mem[output_pointer];
+            end
 
-    wire                  empty;
-    wire   [`cwidth:0]    input_pointer_plus_one;
+            always @(posedge CLK) begin
+                if (!RESET_N) begin
+                    ram_q_valid <= 1'b0;
+                end else begin
+                    if (ram_read) ram_q_valid <= 1'b1;
+                    else if (take) ram_q_valid <= 1'b0;
+                end
+            end
+
+        end else begin : dram
+
+            (* ram_style = "distributed" *) reg [width-1:0] fifo_mem[depth-1:0];
+            wire                  bypass;
 
-    assign empty = (input_pointer == output_pointer) ? 1'b1 : 1'b0;
-    assign FULL  = (input_pointer_plus_one == output_pointer) ? 1'b1 : 1'b0;
-    assign DATA_READY = !empty;
+            // an empty memory passes the pushed word straight to the output stage
+            assign bypass    = (ram_count == 0) && take;
+            assign ram_write = push && !bypass;
+            assign ram_read  = (ram_count != 0) && take;
+            assign src_valid = (ram_count != 0) || push;
+            assign src_data  = (ram_count != 0) ? fifo_mem[output_pointer] : DATA_IN;
 
-    assign input_pointer_plus_one = input_pointer + {{`cwidth-1 {1'b0}}, 1'b1};
-    assign DATA_OUT = (empty) ? {width {1'b0}} : fifo_mem[output_pointer];
+            always @(posedge CLK) begin
+                if (ram_write) fifo_mem[input_pointer] <= DATA_IN;
+            end
+
+        end
+
+    endgenerate
 
     always @(posedge CLK) begin
-        
-        if (!RESET_N) begin 
-            input_pointer <= {`cwidth {1'b0}};
+
+        if (!RESET_N) begin
+            input_pointer  <= {`cwidth {1'b0}};
             output_pointer <= {`cwidth {1'b0}};
+            ram_count      <= {`cwidth+1 {1'b0}};
+            count          <= {`cwidth+1 {1'b0}};
+            full           <= 1'b0;
+            almost_full_r  <= 1'b0;
+            almost_empty_r <= 1'b1;
+            out_valid0     <= 1'b0;
+            out_valid1     <= 1'b0;
         end else begin
-            if (DATA_STROBE & !FULL) begin
-                fifo_mem[input_pointer] <= DATA_IN;
-                input_pointer <= input_pointer + {{`cwidth-1 {1'b0}}, 1'b1};
+            if (ram_write) begin
+                input_pointer <= (input_pointer == depth-1) ? {`cwidth {1'b0}} : input_pointer + 1'b1;
             end
-            if (DATA_ACK & !empty) begin
-                output_pointer <= output_pointer + {{`cwidth-1 {1'b0}}, 1'b1};
+            if (ram_read) begin
+                output_pointer <= (output_pointer == depth-1) ? {`cwidth {1'b0}} : output_pointer + 1'b1;
+            end
+            ram_count      <= ram_count + ((ram_write) ? 1 : 0) - ((ram_read) ? 1 : 0);
+            count          <= count_next;
+            full           <= (count_next == depth) ? 1'b1 : 1'b0;
+            almost_full_r  <= (count_next >= almost_full) ? 1'b1 : 1'b0;
+            almost_empty_r <= (count_next <= almost_empty) ? 1'b1 : 1'b0;
+
+            if (pop) begin
+                if (take) begin
+                    out_data0  <= src_data;     // take implies the skid entry is empty
+                end else if (out_valid1) begin
+                    out_data0  <= out_data1;
+                    out_valid1 <= 1'b0;
+                end else begin
+                    out_valid0 <= 1'b0;
+                end
+            end else if (take) begin
+                if (!out_valid0) begin
+                    out_data0  <= src_data;
+                    out_valid0 <= 1'b1;
+                end else begin
+                    out_data1  <= src_data;
+                    out_valid1 <= 1'b1;
+                end
             end
         end
     end
 
 endmodule
+
@@ -0,0 +1,77 @@
+
+`timescale 1ns/1ns
+
+module cdc_bus_sync
+    (
+        SCLK,
+        SRESETn,
+        SDATA,
+        SIDLE,
+
+        DCLK,
+        DRESETn,
+        DDATA
+    );
+
+    parameter width = 32;
+
+    // carries a slowly changing value (a configuration register or status
+    // word) between clocks.  A change is captured into hold and announced by
+    // toggling req, the destination copies hold once the toggle has crossed
+    // and returns it as the acknowledge.  Every bit of DDATA changes in the
+    // same cycle, values that change again before the acknowledge are skipped.
+    // SIDLE is high on SCLK once DDATA holds the current SDATA, so a
+    // handshake sent after it, through any other crossing, arrives after the
+    // value.
+
+    input                   SCLK;
+    input                   SRESETn;
+    input  [width-1:0]      SDATA;
+    output                  SIDLE;
+
+    input                   DCLK;
+    input                   DRESETn;
+    output [width-1:0]      DDATA;
+
+    reg    [width-1:0]      hold;
+    reg                     req;
+    reg    [1:0]            ack_sync;
+
+    reg    [1:0]            req_sync;
+    reg                     req_seen;
+    reg    [width-1:0]      ddata;
+
+    wire                    busy = (req != ack_sync[1]) ? 1'b1 : 1'b0;
+
+    assign SIDLE = (!busy && (SDATA == hold)) ? 1'b1 : 1'b0;
+    assign DDATA = ddata;
+
+    always @(posedge SCLK) begin
+        if (SRESETn == 0) begin
+            hold     <= {width {1'b0}};
+            req      <= 1'b0;
+            ack_sync <= 2'b00;
+        end else begin
+            ack_sync <= {ack_sync[0], req_seen};
+            if (!busy && (SDATA != hold)) begin
+                hold <= SDATA;
+                req  <= !req;
+            end
+        end
+    end
+
+    always @(posedge DCLK) begin
+        if (DRESETn == 0) begin
+            req_sync <= 2'b00;
+            req_seen <= 1'b0;
+            ddata    <= {width {1'b0}};
+        end else begin
+            req_sync <= {req_sync[0], req};
+            if (req_sync[1] != req_seen) begin
+                ddata    <= hold;
+                req_seen <= req_sync[1];
+            end
+        end
+    end
+
+endmodule